@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+/*
+ * Compares the buffer formatters of `utils.hpp` (formatDecimal(),
+ * formatSize(), and formatNs()), as well as their string wrappers, to
+ * the printf()-based string formatters which they replace.
+ *
+ * Usage:
+ *
+ *     jacquesctf-format-bench [VALUE-COUNT [ROUND-COUNT]]
+ *
+ * For each formatter, prints the best time per call, in nanoseconds,
+ * over ROUND-COUNT rounds of VALUE-COUNT pseudo-random values (same
+ * seed for each run), as well as the number of values for which the
+ * old and new outputs differ.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <array>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <boost/optional.hpp>
+
+#include "aliases.hpp"
+#include "utils.hpp"
+
+namespace jacques {
+namespace bench {
+namespace old {
+
+template <typename T>
+static std::string sepNumber(const T value, const char sep, const char *fmt)
+{
+    std::array<char, 64> buf;
+    const auto absValue = std::is_signed<T>::value ?
+                          std::abs(static_cast<long long>(value)) : value;
+    const auto count = std::sprintf(buf.data(), fmt, absValue);
+    Index i = 0;
+    std::string ret;
+
+    for (auto at = count - 1; at >= 0; --at, ++i) {
+        const auto ch = buf[at];
+
+        if (i % 3 == 0 && i != 0) {
+            ret += sep;
+        }
+
+        ret += ch;
+    }
+
+    if (ret.back() == sep) {
+        ret.pop_back();
+    }
+
+    if (value < 0) {
+        ret += '-';
+    }
+
+    std::reverse(std::begin(ret), std::end(ret));
+    return ret;
+}
+
+static std::string sepNumber(const long long value, const char sep)
+{
+    return sepNumber(value, sep, "%lld");
+}
+
+static std::string sepNumber(const unsigned long long value, const char sep)
+{
+    return sepNumber(value, sep, "%llu");
+}
+
+static std::pair<std::string, std::string> formatSize(const Size sizeBits,
+                                                      const utils::SizeFormatMode formatMode,
+                                                      const boost::optional<char>& sep)
+{
+    using utils::SizeFormatMode;
+
+    std::array<char, 64> buf;
+    const char *unit;
+    const auto sizeBytes = sizeBits / 8;
+    const auto extraBits = sizeBits & 7;
+
+    switch (formatMode) {
+    case SizeFormatMode::FULL_FLOOR:
+    case SizeFormatMode::FULL_FLOOR_WITH_EXTRA_BITS:
+    {
+        unit = "B";
+        double val = static_cast<double>(sizeBytes);
+
+        if (sizeBytes >= 1024 * 1024 * 1024) {
+            val = static_cast<double>(sizeBytes) / (1024. * 1024 * 1024);
+            unit = "GiB";
+        } else if (sizeBytes >= 1024 * 1024) {
+            val = static_cast<double>(sizeBytes) / (1024. * 1024);
+            unit = "MiB";
+        } else if (sizeBytes >= 1024) {
+            val = static_cast<double>(sizeBytes) / 1024.;
+            unit = "KiB";
+        }
+
+        if (formatMode == SizeFormatMode::FULL_FLOOR_WITH_EXTRA_BITS &&
+                extraBits > 0) {
+            std::sprintf(buf.data(), "%.3f+%llu", val, extraBits);
+        } else {
+            std::sprintf(buf.data(), "%.3f", val);
+        }
+
+        break;
+    }
+
+    case SizeFormatMode::BYTES_FLOOR:
+    case SizeFormatMode::BYTES_FLOOR_WITH_EXTRA_BITS:
+        unit = "B";
+
+        if (formatMode == SizeFormatMode::BYTES_FLOOR_WITH_EXTRA_BITS &&
+                extraBits > 0) {
+            if (sep) {
+                std::sprintf(buf.data(), "%s+%llu",
+                             sepNumber(static_cast<long long>(sizeBytes), *sep).c_str(),
+                             extraBits);
+            } else {
+                std::sprintf(buf.data(), "%llu+%llu", sizeBytes, extraBits);
+            }
+        } else {
+            if (sep) {
+                std::sprintf(buf.data(), "%s",
+                             sepNumber(static_cast<long long>(sizeBytes), *sep).c_str());
+            } else {
+                std::sprintf(buf.data(), "%llu", sizeBytes);
+            }
+        }
+
+        break;
+
+    case SizeFormatMode::BITS:
+        unit = "b";
+
+        if (sep) {
+            std::sprintf(buf.data(), "%s",
+                         sepNumber(static_cast<long long>(sizeBits), *sep).c_str());
+        } else {
+            std::sprintf(buf.data(), "%llu", sizeBits);
+        }
+
+        break;
+    }
+
+    return {buf.data(), unit};
+}
+
+static std::pair<std::string, std::string> formatNs(long long ns,
+                                                    const boost::optional<char>& sep)
+{
+    constexpr auto nsInS = 1'000'000'000LL;
+    const auto absNs = std::abs(ns);
+    const auto absSOnly = (absNs / nsInS);
+    const auto nsOnly = absNs % nsInS;
+    std::string sStr;
+
+    if (ns < 0) {
+        sStr = "-";
+    }
+
+    sStr += sep ? sepNumber(absSOnly, *sep) : std::to_string(absSOnly);
+
+    const auto nsStr = sep ? sepNumber(nsOnly, *sep, "%09llu") :
+                       std::to_string(nsOnly);
+
+    return {sStr, nsStr};
+}
+
+} // namespace old
+
+/*
+ * Values with a uniformly distributed digit count, which is closer to
+ * what the views show (offsets, sizes, timestamps, counts) than
+ * uniformly distributed values.
+ */
+static std::vector<unsigned long long> createValues(const Size count)
+{
+    std::mt19937_64 gen {0x6a61637175657321ULL};
+    std::uniform_int_distribution<unsigned int> bitCountDist {1, 62};
+    std::vector<unsigned long long> values;
+
+    values.reserve(count);
+
+    for (Index i = 0; i < count; ++i) {
+        values.push_back(gen() >> (64 - bitCountDist(gen)));
+    }
+
+    return values;
+}
+
+/*
+ * Returns the best time per call (ns) of `func` over `roundCount`
+ * rounds of all the values of `values`.
+ *
+ * `func` returns a size which this function accumulates in `sink` so
+ * that the compiler cannot elide the calls.
+ */
+template <typename FuncT>
+static double bench(const std::vector<unsigned long long>& values,
+                    const Size roundCount, Size& sink, FuncT&& func)
+{
+    using Clock = std::chrono::steady_clock;
+
+    double bestNs = HUGE_VAL;
+
+    for (Index round = 0; round < roundCount; ++round) {
+        const auto begin = Clock::now();
+
+        for (const auto value : values) {
+            sink += func(value);
+        }
+
+        const auto end = Clock::now();
+        const std::chrono::duration<double, std::nano> duration = end - begin;
+
+        bestNs = std::min(bestNs, duration.count() / values.size());
+    }
+
+    return bestNs;
+}
+
+// returns the number of values for which `oldFunc` and `newFunc` differ
+template <typename OldFuncT, typename NewFuncT>
+static Size diffCount(const std::vector<unsigned long long>& values,
+                      OldFuncT&& oldFunc, NewFuncT&& newFunc)
+{
+    Size count = 0;
+
+    for (const auto value : values) {
+        if (oldFunc(value) != newFunc(value)) {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+static void printResult(const char * const name, const double oldNs,
+                        const double newNs, const double newBufNs,
+                        const Size diffCount)
+{
+    std::printf("%-28s %10.1f %10.1f %10.1f %8.1fx %10llu\n", name, oldNs,
+                newNs, newBufNs, oldNs / newBufNs, diffCount);
+}
+
+static int run(const Size valueCount, const Size roundCount)
+{
+    using utils::SizeFormatMode;
+
+    const auto values = createValues(valueCount);
+    std::array<char, utils::formatBufSize> buf;
+    std::array<char, utils::formatBufSize> nsBuf;
+    Size sink = 0;
+
+    std::printf("%llu values, best of %llu rounds, ns per call\n\n",
+                valueCount, roundCount);
+    std::printf("%-28s %10s %10s %10s %9s %10s\n", "Formatter", "Old",
+                "New", "New (buf)", "Speedup", "Diffs");
+
+    // decimal with and without separator (signed)
+    for (const auto sep : {boost::optional<char> {' '}, boost::optional<char> {}}) {
+        const auto toSigned = [](const unsigned long long value) {
+            // odd values are negative
+            return value & 1 ? -static_cast<long long>(value >> 1) :
+                   static_cast<long long>(value >> 1);
+        };
+        const auto oldFunc = [&](const unsigned long long value) {
+            return sep ? old::sepNumber(toSigned(value), *sep) :
+                   std::to_string(toSigned(value));
+        };
+        const auto newFunc = [&](const unsigned long long value) {
+            if (sep) {
+                return utils::sepNumber(toSigned(value), *sep);
+            }
+
+            const auto len = utils::formatDecimal(buf.data(), toSigned(value));
+
+            return std::string {buf.data(), len};
+        };
+        const auto oldNs = bench(values, roundCount, sink, [&](const auto value) {
+            return oldFunc(value).size();
+        });
+        const auto newNs = bench(values, roundCount, sink, [&](const auto value) {
+            return newFunc(value).size();
+        });
+        const auto newBufNs = bench(values, roundCount, sink, [&](const auto value) {
+            return utils::formatDecimal(buf.data(), toSigned(value), sep);
+        });
+
+        printResult(sep ? "decimal (sep.)" : "decimal", oldNs, newNs,
+                    newBufNs, diffCount(values, oldFunc, newFunc));
+    }
+
+    // data size, each mode
+    const std::array<std::pair<SizeFormatMode, const char *>, 5> modes {{
+        {SizeFormatMode::FULL_FLOOR, "size (full)"},
+        {SizeFormatMode::FULL_FLOOR_WITH_EXTRA_BITS, "size (full, extra bits)"},
+        {SizeFormatMode::BYTES_FLOOR, "size (bytes, sep.)"},
+        {SizeFormatMode::BYTES_FLOOR_WITH_EXTRA_BITS, "size (bytes, sep., extra)"},
+        {SizeFormatMode::BITS, "size (bits, sep.)"},
+    }};
+
+    for (const auto& modeNamePair : modes) {
+        const auto mode = modeNamePair.first;
+        const boost::optional<char> sep {' '};
+        const auto oldFunc = [&](const unsigned long long value) {
+            return old::formatSize(value, mode, sep);
+        };
+        const auto newFunc = [&](const unsigned long long value) {
+            return utils::formatSize(value, mode, sep);
+        };
+        const auto oldNs = bench(values, roundCount, sink, [&](const auto value) {
+            return oldFunc(value).first.size();
+        });
+        const auto newNs = bench(values, roundCount, sink, [&](const auto value) {
+            return newFunc(value).first.size();
+        });
+        const auto newBufNs = bench(values, roundCount, sink, [&](const auto value) {
+            utils::formatSize(buf.data(), value, mode, sep);
+            return static_cast<Size>(buf[0]);
+        });
+
+        printResult(modeNamePair.second, oldNs, newNs, newBufNs,
+                    diffCount(values, oldFunc, newFunc));
+    }
+
+    /*
+     * Nanoseconds with a separator: without a separator, the old
+     * version didn't zero-pad the nanosecond part.
+     */
+    {
+        const boost::optional<char> sep {' '};
+        const auto toNs = [](const unsigned long long value) {
+            return static_cast<long long>(value);
+        };
+        const auto oldFunc = [&](const unsigned long long value) {
+            return old::formatNs(toNs(value), sep);
+        };
+        const auto newFunc = [&](const unsigned long long value) {
+            return utils::formatNs(toNs(value), sep);
+        };
+        const auto oldNs = bench(values, roundCount, sink, [&](const auto value) {
+            return oldFunc(value).second.size();
+        });
+        const auto newNs = bench(values, roundCount, sink, [&](const auto value) {
+            return newFunc(value).second.size();
+        });
+        const auto newBufNs = bench(values, roundCount, sink, [&](const auto value) {
+            utils::formatNs(buf.data(), nsBuf.data(), toNs(value), sep);
+            return static_cast<Size>(nsBuf[0]);
+        });
+
+        printResult("ns (sep.)", oldNs, newNs, newBufNs,
+                    diffCount(values, oldFunc, newFunc));
+    }
+
+    // keep the sink alive
+    std::printf("\n(checksum: %llu)\n", sink);
+    return 0;
+}
+
+} // namespace bench
+} // namespace jacques
+
+int main(const int argc, const char * const argv[])
+{
+    jacques::Size valueCount = 1'000'000;
+    jacques::Size roundCount = 5;
+
+    if (argc >= 2) {
+        valueCount = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    if (argc >= 3) {
+        roundCount = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    if (valueCount == 0 || roundCount == 0) {
+        std::fprintf(stderr, "Usage: %s [VALUE-COUNT [ROUND-COUNT]]\n",
+                     argv[0]);
+        return 1;
+    }
+
+    return jacques::bench::run(valueCount, roundCount);
+}
@@ -0,0 +1,454 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_CACHE_HPP
+#define _JACQUES_CACHE_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <functional>
+#include <boost/optional.hpp>
+#include <boost/core/noncopyable.hpp>
+
+#include "aliases.hpp"
+
+namespace jacques {
+
+/*
+ * A generic cache, where values of type `ValueT` are associated to keys
+ * of type `KeyT`, with CLOCK (second chance) eviction.
+ *
+ * The entries live in a single vector allocated once (no allocation
+ * per insertion), and an open addressing (linear probing) table of
+ * entry indexes, at most half full, finds an entry from its key. Erasing
+ * from the table shifts the following entries back instead of leaving
+ * tombstones, so that lookups never slow down over time.
+ *
+ * get() only sets the referenced bit of a hit entry. When the cache is
+ * full, the clock hand sweeps the entries, clearing referenced bits,
+ * and evicts the first entry which isn't referenced: recently used
+ * entries get a second chance.
+ *
+ * The cache can also have a maximum total weight, in which case a
+ * weight function gives the weight of each value (for example, its
+ * size in bytes): insert() evicts entries until the new entry fits.
+ *
+ * The cache counts its hits, misses, and evictions.
+ *
+ * A pointer which get() returns remains valid until the next call to
+ * insert() or invalidate().
+ *
+ * This cache is not thread-safe: see `ShardedCache` below.
+ */
+template <typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>>
+class Cache :
+    boost::noncopyable
+{
+public:
+    using WeightFunc = std::function<Size (const ValueT&)>;
+
+public:
+    /*
+     * Builds a cache which can contain at most `maxSize` elements and,
+     * if `maxWeight` is not zero, elements having a total weight (as
+     * given by `weightFunc`) of at most `maxWeight`.
+     */
+    explicit Cache(const Size maxSize, const Size maxWeight = 0,
+                   WeightFunc weightFunc = nullptr) :
+        _maxSize {maxSize},
+        _maxWeight {maxWeight},
+        _weightFunc {std::move(weightFunc)}
+    {
+        assert(maxSize > 0);
+        assert(maxWeight == 0 || _weightFunc);
+
+        Size tableSize = 2;
+
+        _tableShift = 63;
+
+        while (tableSize < maxSize * 2) {
+            tableSize *= 2;
+            --_tableShift;
+        }
+
+        _entries.reserve(maxSize);
+        _table.assign(tableSize, _noEntry);
+        _tableMask = tableSize - 1;
+    }
+
+    // size of the cache (not its capacity)
+    Size size() const noexcept
+    {
+        return _entries.size();
+    }
+
+    // total weight of the cached values
+    Size weight() const noexcept
+    {
+        return _weight;
+    }
+
+    Size hitCount() const noexcept
+    {
+        return _hitCount;
+    }
+
+    Size missCount() const noexcept
+    {
+        return _missCount;
+    }
+
+    Size evictionCount() const noexcept
+    {
+        return _evictionCount;
+    }
+
+    /*
+     * Inserts an element within the cache, possibly evicting other
+     * elements.
+     *
+     * The cache must not contain an element for which the key is `key`.
+     */
+    void insert(const KeyT& key, ValueT value)
+    {
+        assert(!this->contains(key));
+
+        const auto weight = _maxWeight > 0 ? _weightFunc(value) : 0;
+
+        while (!_entries.empty() &&
+                (_entries.size() == _maxSize ||
+                 (_maxWeight > 0 && _weight + weight > _maxWeight))) {
+            this->_evict();
+        }
+
+        _entries.push_back({key, std::move(value), weight, false});
+        _weight += weight;
+
+        // new entry is at the first free position of its probe sequence
+        auto pos = this->_homePos(key);
+
+        while (_table[pos] != _noEntry) {
+            pos = (pos + 1) & _tableMask;
+        }
+
+        _table[pos] = _entries.size() - 1;
+    }
+
+    /*
+     * Returns the cached value associated to the key `key`, returning
+     * `nullptr` if this cache does not contain such a value. When a
+     * value is returned, it is marked as referenced in this cache.
+     */
+    const ValueT *get(const KeyT& key)
+    {
+        const auto pos = this->_findPos(key);
+
+        if (pos == _noEntry) {
+            ++_missCount;
+            return nullptr;
+        }
+
+        auto& entry = _entries[_table[pos]];
+
+        ++_hitCount;
+        entry.isReferenced = true;
+        return &entry.value;
+    }
+
+    /*
+     * Returns whether or not this cache contains a value for which the
+     * key is `key` (doesn't count as a hit or a miss).
+     */
+    bool contains(const KeyT& key) const
+    {
+        return this->_findPos(key) != _noEntry;
+    }
+
+    // invalidates the cache: removes everything
+    void invalidate()
+    {
+        _entries.clear();
+        std::fill(std::begin(_table), std::end(_table), _noEntry);
+        _hand = 0;
+        _weight = 0;
+    }
+
+    /*
+     * Invalidates any cached value associated to the key `key` (removes
+     * it from this cache).
+     */
+    void invalidate(const KeyT& key)
+    {
+        const auto pos = this->_findPos(key);
+
+        if (pos != _noEntry) {
+            this->_remove(pos);
+        }
+    }
+
+private:
+    struct _Entry
+    {
+        KeyT key;
+        ValueT value;
+        Size weight;
+        bool isReferenced;
+    };
+
+    static constexpr Index _noEntry = std::numeric_limits<Index>::max();
+
+private:
+    Index _homePos(const KeyT& key) const
+    {
+        /*
+         * Fibonacci hashing: keys such as offsets are often multiples
+         * of a power of two, which the multiplication spreads over the
+         * high bits.
+         */
+        const std::uint64_t hash = HashT {}(key);
+
+        return (hash * 0x9e3779b97f4a7c15ULL) >> _tableShift;
+    }
+
+    // position of the table slot of `key`, or `_noEntry` if missing
+    Index _findPos(const KeyT& key) const
+    {
+        auto pos = this->_homePos(key);
+
+        while (_table[pos] != _noEntry) {
+            if (_entries[_table[pos]].key == key) {
+                return pos;
+            }
+
+            pos = (pos + 1) & _tableMask;
+        }
+
+        return _noEntry;
+    }
+
+    // removes the entry of the table slot at position `pos`
+    void _remove(const Index pos)
+    {
+        const auto entryIndex = _table[pos];
+
+        _weight -= _entries[entryIndex].weight;
+
+        // backward shift deletion
+        auto holePos = pos;
+        auto nextPos = (pos + 1) & _tableMask;
+
+        while (_table[nextPos] != _noEntry) {
+            const auto homePos = this->_homePos(_entries[_table[nextPos]].key);
+
+            if (((nextPos - homePos) & _tableMask) >=
+                    ((nextPos - holePos) & _tableMask)) {
+                _table[holePos] = _table[nextPos];
+                holePos = nextPos;
+            }
+
+            nextPos = (nextPos + 1) & _tableMask;
+        }
+
+        _table[holePos] = _noEntry;
+
+        // keep the entries contiguous: move the last one to the hole
+        const auto lastEntryIndex = _entries.size() - 1;
+
+        if (entryIndex != lastEntryIndex) {
+            const auto lastPos = this->_findPos(_entries[lastEntryIndex].key);
+
+            assert(lastPos != _noEntry);
+            _entries[entryIndex] = std::move(_entries[lastEntryIndex]);
+            _table[lastPos] = entryIndex;
+        }
+
+        _entries.pop_back();
+
+        if (_hand >= _entries.size()) {
+            _hand = 0;
+        }
+    }
+
+    void _evict()
+    {
+        assert(!_entries.empty());
+
+        // second chance for referenced entries
+        while (_entries[_hand].isReferenced) {
+            _entries[_hand].isReferenced = false;
+            _hand = (_hand + 1) % _entries.size();
+        }
+
+        ++_evictionCount;
+        this->_remove(this->_findPos(_entries[_hand].key));
+    }
+
+private:
+    const Size _maxSize;
+    const Size _maxWeight;
+    const WeightFunc _weightFunc;
+
+    // entries (contiguous, unordered)
+    std::vector<_Entry> _entries;
+
+    // open addressing table of indexes within `_entries`
+    std::vector<Index> _table;
+    Index _tableMask;
+    unsigned int _tableShift;
+
+    // CLOCK hand (index within `_entries`)
+    Index _hand = 0;
+
+    Size _weight = 0;
+    Size _hitCount = 0;
+    Size _missCount = 0;
+    Size _evictionCount = 0;
+};
+
+template <typename KeyT, typename ValueT, typename HashT>
+constexpr Index Cache<KeyT, ValueT, HashT>::_noEntry;
+
+/*
+ * A thread-safe cache made of `ShardCountV` caches (shards), each one
+ * with its own lock, so that threads which access different keys
+ * rarely contend.
+ *
+ * The maximum size and weight of each shard is the total maximum size
+ * and weight divided by `ShardCountV`.
+ *
+ * get() returns a copy of the cached value because another thread
+ * could evict it at any time: `ValueT` is typically a shared pointer.
+ */
+template <typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>,
+          Size ShardCountV = 16>
+class ShardedCache :
+    boost::noncopyable
+{
+private:
+    using _Shard = Cache<KeyT, ValueT, HashT>;
+
+public:
+    explicit ShardedCache(const Size maxSize, const Size maxWeight = 0,
+                          typename _Shard::WeightFunc weightFunc = nullptr)
+    {
+        assert(maxSize >= ShardCountV);
+
+        for (auto& shard : _shards) {
+            shard.cache = std::make_unique<_Shard>(maxSize / ShardCountV,
+                                                   maxWeight / ShardCountV,
+                                                   weightFunc);
+        }
+    }
+
+    /*
+     * Inserts an element within the cache if it does not contain an
+     * element for which the key is `key`.
+     */
+    void insert(const KeyT& key, ValueT value)
+    {
+        auto& shard = this->_shard(key);
+        std::lock_guard<std::mutex> lock {shard.mutex};
+
+        if (!shard.cache->contains(key)) {
+            shard.cache->insert(key, std::move(value));
+        }
+    }
+
+    boost::optional<ValueT> get(const KeyT& key)
+    {
+        auto& shard = this->_shard(key);
+        std::lock_guard<std::mutex> lock {shard.mutex};
+
+        if (const auto value = shard.cache->get(key)) {
+            return *value;
+        }
+
+        return boost::none;
+    }
+
+    void invalidate()
+    {
+        for (auto& shard : _shards) {
+            std::lock_guard<std::mutex> lock {shard.mutex};
+
+            shard.cache->invalidate();
+        }
+    }
+
+    void invalidate(const KeyT& key)
+    {
+        auto& shard = this->_shard(key);
+        std::lock_guard<std::mutex> lock {shard.mutex};
+
+        shard.cache->invalidate(key);
+    }
+
+    Size hitCount() const
+    {
+        return this->_sum([](const _Shard& cache) {
+            return cache.hitCount();
+        });
+    }
+
+    Size missCount() const
+    {
+        return this->_sum([](const _Shard& cache) {
+            return cache.missCount();
+        });
+    }
+
+    Size evictionCount() const
+    {
+        return this->_sum([](const _Shard& cache) {
+            return cache.evictionCount();
+        });
+    }
+
+private:
+    struct _ShardEntry
+    {
+        mutable std::mutex mutex;
+        std::unique_ptr<_Shard> cache;
+    };
+
+private:
+    _ShardEntry& _shard(const KeyT& key)
+    {
+        // other bits than the ones the shard's own table uses
+        const std::uint64_t hash = HashT {}(key);
+
+        return _shards[((hash * 0xc2b2ae3d27d4eb4fULL) >> 32) % ShardCountV];
+    }
+
+    template <typename FuncT>
+    Size _sum(FuncT&& func) const
+    {
+        Size sum = 0;
+
+        for (const auto& shard : _shards) {
+            std::lock_guard<std::mutex> lock {shard.mutex};
+
+            sum += func(*shard.cache);
+        }
+
+        return sum;
+    }
+
+private:
+    std::array<_ShardEntry, ShardCountV> _shards;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_CACHE_HPP
@@ -37,6 +37,17 @@ Config::~Config()
 {
 }
 
+ReplayConfig::ReplayConfig(const bfs::path& keyScriptPath,
+                           std::vector<bfs::path>&& paths,
+                           const unsigned int width,
+                           const unsigned int height) :
+    InspectConfig {std::move(paths)},
+    _keyScriptPath {keyScriptPath},
+    _width {width},
+    _height {height}
+{
+}
+
 SinglePathConfig::SinglePathConfig(const bfs::path& path) :
     _path {path}
 {
@@ -74,6 +85,11 @@ CreateLttngIndexConfig::CreateLttngIndexConfig(std::vector<bfs::path>&& paths) :
 {
 }
 
+ValidateConfig::ValidateConfig(std::vector<bfs::path>&& paths) :
+    _paths {std::move(paths)}
+{
+}
+
 PrintCliUsageConfig::PrintCliUsageConfig()
 {
 }
@@ -82,7 +98,19 @@ PrintVersionConfig::PrintVersionConfig()
 {
 }
 
-static void expandDir(std::list<bfs::path>& tmpFilePaths, const bfs::path& path)
+/*
+ * Appends the data stream file paths found within `path`, recursively,
+ * to `tmpFilePaths`.
+ *
+ * If `parallel` is true, the subdirectories of the first directory
+ * level which has more than one subdirectory are expanded concurrently
+ * (deeper levels are expanded sequentially by each worker). The result
+ * is the same as a sequential expansion: subdirectory paths in
+ * directory iteration order, followed with the sorted data stream file
+ * paths of `path` itself.
+ */
+static void expandDir(std::list<bfs::path>& tmpFilePaths, const bfs::path& path,
+                      const bool parallel = false)
 {
     namespace bfs = bfs;
 
@@ -90,6 +118,7 @@ static void expandDir(std::list<bfs::path>& tmpFilePaths, const bfs::path& path)
 
     const bool hasMetadata = bfs::exists(path / "metadata");
     std::vector<bfs::path> thisDirStreamFilePaths;
+    std::vector<bfs::path> subDirPaths;
 
     for (const auto& entry : boost::make_iterator_range(bfs::directory_iterator(path), {})) {
         const auto& entryPath = entry.path();
@@ -104,8 +133,8 @@ static void expandDir(std::list<bfs::path>& tmpFilePaths, const bfs::path& path)
         }
 
         if (bfs::is_directory(entryPath)) {
-            // expand subdirectory
-            expandDir(tmpFilePaths, entryPath);
+            // expand subdirectory later
+            subDirPaths.push_back(entryPath);
             continue;
         }
 
@@ -121,6 +150,22 @@ static void expandDir(std::list<bfs::path>& tmpFilePaths, const bfs::path& path)
         }
     }
 
+    if (parallel && subDirPaths.size() > 1) {
+        std::vector<std::list<bfs::path>> subDirFilePaths(subDirPaths.size());
+
+        utils::parallelFor(subDirPaths.size(), [&](const Index index) {
+            expandDir(subDirFilePaths[index], subDirPaths[index]);
+        });
+
+        for (auto& filePaths : subDirFilePaths) {
+            tmpFilePaths.splice(std::end(tmpFilePaths), filePaths);
+        }
+    } else {
+        for (const auto& subDirPath : subDirPaths) {
+            expandDir(tmpFilePaths, subDirPath, parallel);
+        }
+    }
+
     std::sort(std::begin(thisDirStreamFilePaths),
               std::end(thisDirStreamFilePaths));
     tmpFilePaths.insert(std::end(tmpFilePaths),
@@ -156,7 +201,7 @@ static std::vector<bfs::path> expandPaths(const std::vector<bfs::path>& origFile
         }
 
         if (bfs::is_directory(path)) {
-            expandDir(tmpFilePaths, path);
+            expandDir(tmpFilePaths, path, true);
         } else {
             const auto metadataPath = path.parent_path() / "metadata";
 
@@ -215,7 +260,7 @@ static std::vector<bfs::path> getExpandedPaths(const std::vector<std::string>& a
     return expandPaths(origFilePaths);
 }
 
-static std::unique_ptr<const Config> inspectConfigFromArgs(const std::vector<std::string>& args)
+static std::unique_ptr<Config> inspectConfigFromArgs(const std::vector<std::string>& args)
 {
     bpo::options_description optDesc {""};
 
@@ -246,7 +291,65 @@ static std::unique_ptr<const Config> inspectConfigFromArgs(const std::vector<std
     return std::make_unique<InspectConfig>(std::move(expandedPaths));
 }
 
-static std::unique_ptr<const Config> createLttngIndexConfigFromArgs(const std::vector<std::string>& args)
+static std::unique_ptr<Config> replayConfigFromArgs(const std::vector<std::string>& args)
+{
+    bpo::options_description optDesc {""};
+
+    optDesc.add_options()
+        ("width,w", bpo::value<unsigned int>()->default_value(160), "")
+        ("height,H", bpo::value<unsigned int>()->default_value(48), "")
+        ("key-script-path", bpo::value<std::string>(), "")
+        ("paths", bpo::value<std::vector<std::string>>(), "");
+
+    bpo::positional_options_description posDesc;
+
+    posDesc.add("key-script-path", 1).add("paths", -1);
+
+    bpo::variables_map vm;
+
+    try {
+        bpo::store(bpo::command_line_parser(args).options(optDesc).
+                   positional(posDesc).run(), vm);
+    } catch (const bpo::error& ex) {
+        throw CliError {ex.what()};
+    } catch (...) {
+        std::abort();
+    }
+
+    if (vm.count("key-script-path") == 0) {
+        throw CliError {"Missing key script path."};
+    }
+
+    if (vm.count("paths") == 0) {
+        throw CliError {"Missing trace directory path or data stream file path."};
+    }
+
+    const auto width = vm["width"].as<unsigned int>();
+    const auto height = vm["height"].as<unsigned int>();
+
+    if (width < 80 || height < 16) {
+        throw CliError {"Terminal size must be at least 80x16."};
+    }
+
+    const auto keyScriptPath = bfs::path {vm["key-script-path"].as<std::string>()};
+
+    if (!bfs::is_regular_file(keyScriptPath)) {
+        std::ostringstream ss;
+
+        ss << "`" << keyScriptPath.string() << "` is not a regular file.";
+        throw CliError {ss.str()};
+    }
+
+    const auto& pathStrs = vm["paths"].as<std::vector<std::string>>();
+    auto expandedPaths = expandPaths({std::begin(pathStrs), std::end(pathStrs)},
+                                     false);
+
+    return std::make_unique<ReplayConfig>(keyScriptPath,
+                                          std::move(expandedPaths), width,
+                                          height);
+}
+
+static std::unique_ptr<Config> createLttngIndexConfigFromArgs(const std::vector<std::string>& args)
 {
     bpo::options_description optDesc {""};
 
@@ -273,6 +376,39 @@ static std::unique_ptr<const Config> createLttngIndexConfigFromArgs(const std::v
     return std::make_unique<CreateLttngIndexConfig>(std::move(expandedPaths));
 }
 
+static std::unique_ptr<Config> validateConfigFromArgs(const std::vector<std::string>& args)
+{
+    bpo::options_description optDesc {""};
+
+    optDesc.add_options()
+        ("paths", bpo::value<std::vector<std::string>>(), "");
+
+    bpo::positional_options_description posDesc;
+
+    posDesc.add("paths", -1);
+
+    bpo::variables_map vm;
+
+    try {
+        bpo::store(bpo::command_line_parser(args).options(optDesc).
+                   positional(posDesc).run(), vm);
+    } catch (const bpo::error& ex) {
+        throw CliError {ex.what()};
+    } catch (...) {
+        std::abort();
+    }
+
+    if (vm.count("paths") == 0) {
+        throw CliError {"Missing trace directory path or data stream file path."};
+    }
+
+    const auto& pathStrs = vm["paths"].as<std::vector<std::string>>();
+    auto expandedPaths = expandPaths({std::begin(pathStrs), std::end(pathStrs)},
+                                     false);
+
+    return std::make_unique<ValidateConfig>(std::move(expandedPaths));
+}
+
 static void checkLooksLikeDataStreamFile(const bfs::path& path)
 {
     if (!bfs::is_regular_file(path)) {
@@ -291,7 +427,7 @@ static void checkLooksLikeDataStreamFile(const bfs::path& path)
     }
 }
 
-static std::unique_ptr<const Config> listPacketsConfigFromArgs(const std::vector<std::string>& args)
+static std::unique_ptr<Config> listPacketsConfigFromArgs(const std::vector<std::string>& args)
 {
     bpo::options_description optDesc {""};
 
@@ -333,7 +469,7 @@ static std::unique_ptr<const Config> listPacketsConfigFromArgs(const std::vector
                                                vm.count("header") == 1);
 }
 
-static std::unique_ptr<const Config> copyPacketsConfigFromArgs(const std::vector<std::string>& args)
+static std::unique_ptr<Config> copyPacketsConfigFromArgs(const std::vector<std::string>& args)
 {
     bpo::options_description optDesc {""};
 
@@ -401,6 +537,11 @@ std::unique_ptr<const Config> configFromArgs(const int argc,
     optDesc.add_options()
         ("help,h", "")
         ("version,V", "")
+        ("stats", "")
+        ("data-source", bpo::value<std::string>(), "")
+        ("packet-cache-windows", bpo::value<Size>(), "")
+        ("packet-cache-window-size", bpo::value<Size>(), "")
+        ("packet-cache-max-regions", bpo::value<Size>(), "")
         ("args", bpo::value<std::vector<std::string>>(), "");
 
     bpo::positional_options_description posDesc;
@@ -435,10 +576,13 @@ std::unique_ptr<const Config> configFromArgs(const int argc,
         const static std::string listPacketsCmdName {"list-packets"};
         const static std::string copyPacketsCmdName {"copy-packets"};
         const static std::string createLttngIndexCmdName {"create-lttng-index"};
+        const static std::string validateCmdName {"validate"};
+        const static std::string replayCmdName {"replay"};
 
         if (args[0] == "inspect" || args[0] == listPacketsCmdName ||
                 args[0] == copyPacketsCmdName ||
-                args[0] == createLttngIndexCmdName) {
+                args[0] == createLttngIndexCmdName ||
+                args[0] == validateCmdName || args[0] == replayCmdName) {
             removeCmdName = true;
         }
 
@@ -449,16 +593,67 @@ std::unique_ptr<const Config> configFromArgs(const int argc,
             extraArgs.erase(extraArgs.begin());
         }
 
+        std::unique_ptr<Config> cfg;
+
         if (args[0] == listPacketsCmdName) {
-            return listPacketsConfigFromArgs(extraArgs);
+            cfg = listPacketsConfigFromArgs(extraArgs);
         } else if (args[0] == copyPacketsCmdName) {
-            return copyPacketsConfigFromArgs(extraArgs);
+            cfg = copyPacketsConfigFromArgs(extraArgs);
         } else if (args[0] == createLttngIndexCmdName) {
-            return createLttngIndexConfigFromArgs(extraArgs);
+            cfg = createLttngIndexConfigFromArgs(extraArgs);
+        } else if (args[0] == validateCmdName) {
+            cfg = validateConfigFromArgs(extraArgs);
+        } else if (args[0] == replayCmdName) {
+            cfg = replayConfigFromArgs(extraArgs);
+        } else {
+            // `inspect` command is the default
+            cfg = inspectConfigFromArgs(extraArgs);
+        }
+
+        cfg->printStats(vm.count("stats") > 0);
+
+        if (vm.count("data-source") > 0) {
+            const auto& dataSource = vm["data-source"].as<std::string>();
+
+            if (dataSource == "mmap") {
+                cfg->dataSourceKind(DataSourceKind::MEMORY_MAPPED_FILE);
+            } else if (dataSource == "pread") {
+                cfg->dataSourceKind(DataSourceKind::PREAD);
+            } else if (dataSource == "pread-thread") {
+                cfg->dataSourceKind(DataSourceKind::PREAD_THREAD);
+            } else {
+                std::ostringstream ss;
+
+                ss << "Invalid data source `" << dataSource <<
+                      "` (expecting `mmap`, `pread`, or `pread-thread`).";
+                throw CliError {ss.str()};
+            }
+        }
+
+        auto packetCacheConfig = cfg->packetCacheConfig();
+
+        if (vm.count("packet-cache-windows") > 0) {
+            packetCacheConfig.windowCount = vm["packet-cache-windows"].as<Size>();
+
+            if (packetCacheConfig.windowCount < 1) {
+                throw CliError {"Packet cache window count must be at least 1."};
+            }
+        }
+
+        if (vm.count("packet-cache-window-size") > 0) {
+            packetCacheConfig.windowEventRecordCount = vm["packet-cache-window-size"].as<Size>();
+
+            if (packetCacheConfig.windowEventRecordCount < 4) {
+                throw CliError {"Packet cache window size must be at least 4 event records."};
+            }
+        }
+
+        if (vm.count("packet-cache-max-regions") > 0) {
+            packetCacheConfig.maxRegionCount = vm["packet-cache-max-regions"].as<Size>();
         }
 
-        // `inspect` command is the default
-        return inspectConfigFromArgs(extraArgs);
+        cfg->packetCacheConfig(packetCacheConfig);
+        return std::move(cfg);
     } catch (const bpo::error& ex) {
         throw CliError {ex.what()};
     } catch (...) {
@@ -14,6 +14,9 @@
 #include <stdexcept>
 #include <boost/filesystem.hpp>
 
+#include "data-source-kind.hpp"
+#include "packet-cache-config.hpp"
+
 namespace jacques {
 
 class CliError :
@@ -37,6 +40,44 @@ protected:
 
 public:
     virtual ~Config();
+
+    // true to print the data layer counters (see `stats.hpp`) at exit
+    bool printStats() const noexcept
+    {
+        return _printStats;
+    }
+
+    void printStats(const bool printStats) noexcept
+    {
+        _printStats = printStats;
+    }
+
+    // how to read data stream files
+    DataSourceKind dataSourceKind() const noexcept
+    {
+        return _dataSourceKind;
+    }
+
+    void dataSourceKind(const DataSourceKind dataSourceKind) noexcept
+    {
+        _dataSourceKind = dataSourceKind;
+    }
+
+    // caching configuration of the packets to inspect
+    const PacketCacheConfig& packetCacheConfig() const noexcept
+    {
+        return _packetCacheConfig;
+    }
+
+    void packetCacheConfig(const PacketCacheConfig& packetCacheConfig) noexcept
+    {
+        _packetCacheConfig = packetCacheConfig;
+    }
+
+private:
+    bool _printStats = false;
+    DataSourceKind _dataSourceKind = DataSourceKind::MEMORY_MAPPED_FILE;
+    PacketCacheConfig _packetCacheConfig;
 };
 
 class InspectConfig :
@@ -50,10 +91,55 @@ public:
         return _paths;
     }
 
+    // true if the user keys come from a key script (`replay` command)
+    virtual bool isReplay() const noexcept
+    {
+        return false;
+    }
+
 private:
     const std::vector<boost::filesystem::path> _paths;
 };
 
+/*
+ * Configuration of the `replay` command: an `inspect` command which
+ * renders headlessly at a fixed terminal size and reads its user keys
+ * from a key script.
+ */
+class ReplayConfig :
+    public InspectConfig
+{
+public:
+    explicit ReplayConfig(const boost::filesystem::path& keyScriptPath,
+                          std::vector<boost::filesystem::path>&& paths,
+                          unsigned int width, unsigned int height);
+
+    const boost::filesystem::path& keyScriptPath() const noexcept
+    {
+        return _keyScriptPath;
+    }
+
+    unsigned int width() const noexcept
+    {
+        return _width;
+    }
+
+    unsigned int height() const noexcept
+    {
+        return _height;
+    }
+
+    bool isReplay() const noexcept override
+    {
+        return true;
+    }
+
+private:
+    const boost::filesystem::path _keyScriptPath;
+    const unsigned int _width;
+    const unsigned int _height;
+};
+
 class SinglePathConfig :
     public Config
 {
@@ -144,6 +230,33 @@ public:
         return _paths;
     }
 
+    // true if the user keys come from a key script (`replay` command)
+    virtual bool isReplay() const noexcept
+    {
+        return false;
+    }
+
+private:
+    const std::vector<boost::filesystem::path> _paths;
+};
+
+class ValidateConfig :
+    public Config
+{
+public:
+    explicit ValidateConfig(std::vector<boost::filesystem::path>&& paths);
+
+    const std::vector<boost::filesystem::path>& paths() const noexcept
+    {
+        return _paths;
+    }
+
+    // true if the user keys come from a key script (`replay` command)
+    virtual bool isReplay() const noexcept
+    {
+        return false;
+    }
+
 private:
     const std::vector<boost::filesystem::path> _paths;
 };
@@ -137,7 +137,9 @@ void copyPacket(std::ifstream& srcStream, const PacketIndexEntry& indexEntry,
 void copyPacketsCommand(const CopyPacketsConfig& cfg)
 {
     const Metadata metadata {cfg.srcPath().parent_path() / "metadata"};
-    DataStreamFile dsf {cfg.srcPath(), metadata};
+    DataStreamFile dsf {
+        cfg.srcPath(), metadata, nullptr, cfg.dataSourceKind()
+    };
 
     dsf.buildIndex();
 
@@ -170,7 +170,9 @@ void createLttngIndexCommand(const CreateLttngIndexConfig& cfg)
 
         assert(metadata);
 
-        DataStreamFile dsf {dsfPath, *metadata};
+        DataStreamFile dsf {
+            dsfPath, *metadata, nullptr, cfg.dataSourceKind()
+        };
 
         dsf.buildIndex();
         createDataStreamFileLttngIndex(dsf);
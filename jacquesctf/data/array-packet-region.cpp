@@ -0,0 +1,25 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+
+#include "array-packet-region.hpp"
+
+namespace jacques {
+
+ArrayPacketRegion::ArrayPacketRegion(const PacketSegment& segment,
+                                     Scope::SP scope,
+                                     const yactfr::DataType& elemDataType,
+                                     const Size elemCount) :
+    ContentPacketRegion {segment, std::move(scope), elemDataType},
+    _elemCount {elemCount}
+{
+    assert(elemCount > 0);
+    assert(segment.size()->bits() % elemCount == 0);
+}
+
+} // namespace jacques
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_ARRAY_PACKET_REGION_HPP
+#define _JACQUES_ARRAY_PACKET_REGION_HPP
+
+#include <yactfr/metadata/fwd.hpp>
+
+#include "aliases.hpp"
+#include "data-size.hpp"
+#include "content-packet-region.hpp"
+
+namespace jacques {
+
+/*
+ * A content packet region which contains all the elements of a large
+ * array of which the element type is an integer or floating point
+ * number type, the elements being contiguous (no padding between them).
+ *
+ * dataType() is the data type of the elements.
+ *
+ * Such a packet region only exists within a packet's caches (and in
+ * the results of Packet::appendRegions()): the packet creates the
+ * content packet region of an element when it's requested by offset.
+ * Do not call value() on an array packet region.
+ */
+class ArrayPacketRegion :
+    public ContentPacketRegion
+{
+public:
+    explicit ArrayPacketRegion(const PacketSegment& segment, Scope::SP scope,
+                               const yactfr::DataType& elemDataType,
+                               Size elemCount);
+
+    Size elemCount() const noexcept
+    {
+        return _elemCount;
+    }
+
+    DataSize elemSize() const noexcept
+    {
+        return this->segment().size()->bits() / _elemCount;
+    }
+
+    // offset of the element containing the bit `offsetInPacketBits`
+    Index elemOffsetInPacketBits(const Index offsetInPacketBits) const noexcept
+    {
+        const auto elemSizeBits = this->elemSize().bits();
+        const auto firstOffsetInPacketBits = this->segment().offsetInPacketBits();
+
+        return firstOffsetInPacketBits +
+               (offsetInPacketBits - firstOffsetInPacketBits) /
+               elemSizeBits * elemSizeBits;
+    }
+
+    Index lastElemOffsetInPacketBits() const noexcept
+    {
+        return *this->segment().endOffsetInPacketBits() -
+               this->elemSize().bits();
+    }
+
+private:
+    const Size _elemCount;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_ARRAY_PACKET_REGION_HPP
@@ -5,6 +5,11 @@
  * prohibited. Proprietary and confidential.
  */
 
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <yactfr/metadata/data-type.hpp>
+
 #include "content-packet-region.hpp"
 
 namespace jacques {
@@ -24,20 +29,97 @@ static OptByteOrder byteOrderFromDataType(const yactfr::DataType& dataType)
     return boost::none;
 }
 
+static std::uint64_t bitArrayUIntValue(const BitArray& bitArray)
+{
+    const auto size = bitArray.size().bits();
+    std::uint64_t value = 0;
+
+    assert(size <= 64);
+
+    /*
+     * With the big endian byte order, the bit array's first bit is the
+     * most significant one; with the little endian byte order, it's the
+     * least significant one (see BitArray::bitLocation()).
+     */
+    if (bitArray.byteOrder() == ByteOrder::LITTLE) {
+        for (Index index = 0; index < size; ++index) {
+            value |= static_cast<std::uint64_t>(bitArray[index]) << index;
+        }
+    } else {
+        for (Index index = 0; index < size; ++index) {
+            value = (value << 1) | bitArray[index];
+        }
+    }
+
+    return value;
+}
+
 ContentPacketRegion::ContentPacketRegion(const PacketSegment& segment,
                                          Scope::SP scope,
-                                         const yactfr::DataType& dataType,
-                                         const boost::optional<Value>& value) :
+                                         const yactfr::DataType& dataType) :
     PacketRegion {
         segment,
         std::move(scope)
     },
-    _dataType {&dataType},
-    _value {value}
+    _dataType {&dataType}
 {
     this->_segment().byteOrder(byteOrderFromDataType(dataType));
 }
 
+boost::optional<ContentPacketRegion::Value> ContentPacketRegion::value(const BitArray& bitArray) const
+{
+    const auto& dataType = *_dataType;
+
+    if (dataType.isSignedIntType() || dataType.isSignedEnumType()) {
+        const auto size = bitArray.size().bits();
+        auto value = bitArrayUIntValue(bitArray);
+
+        // sign extension
+        if (size < 64 && (value >> (size - 1)) & 1) {
+            value |= ~static_cast<std::uint64_t>(0) << size;
+        }
+
+        return Value {static_cast<std::int64_t>(value)};
+    } else if (dataType.isUnsignedIntType() || dataType.isUnsignedEnumType()) {
+        return Value {bitArrayUIntValue(bitArray)};
+    } else if (dataType.isFloatType()) {
+        const auto value = bitArrayUIntValue(bitArray);
+
+        if (bitArray.size().bits() == 32) {
+            const auto value32 = static_cast<std::uint32_t>(value);
+            float fValue;
+
+            std::memcpy(&fValue, &value32, sizeof fValue);
+            return Value {static_cast<double>(fValue)};
+        } else if (bitArray.size().bits() == 64) {
+            double dValue;
+
+            std::memcpy(&dValue, &value, sizeof dValue);
+            return Value {dValue};
+        }
+    } else if (dataType.isStringType() || dataType.isStaticTextArrayType() ||
+            dataType.isDynamicTextArrayType()) {
+        // strings are always aligned within the packet
+        assert(bitArray.offsetInFirstByteBits() == 0);
+
+        /*
+         * The string ends at the first null character, if any, within
+         * the packet region.
+         */
+        const auto begin = reinterpret_cast<const char *>(bitArray.buf());
+        const auto end = begin + bitArray.size().bytes();
+
+        return Value {
+            boost::string_view {
+                begin,
+                static_cast<boost::string_view::size_type>(std::find(begin, end, '\0') - begin)
+            }
+        };
+    }
+
+    return boost::none;
+}
+
 void ContentPacketRegion::_accept(PacketRegionVisitor& visitor)
 {
     visitor.visit(*this);
@@ -12,43 +12,58 @@
 #include <cstdint>
 #include <boost/variant.hpp>
 #include <boost/optional.hpp>
+#include <boost/utility/string_view.hpp>
 #include <yactfr/metadata/fwd.hpp>
 
 #include "packet-region.hpp"
+#include "bit-array.hpp"
 #include "scope.hpp"
 
 namespace jacques {
 
+/*
+ * A content packet region does not contain its value: caching many
+ * packet regions (a packet's event record window) is much cheaper this
+ * way, and only a few values are ever displayed. Call value() with the
+ * region's bit array (see Packet::bitArray()) to decode the value from
+ * the packet's data on demand.
+ */
 class ContentPacketRegion :
     public PacketRegion
 {
 public:
+    /*
+     * A string value is a view of the packet's data: it remains valid
+     * as long as the packet object which provided the bit array exists.
+     */
     using Value = boost::variant<std::int64_t,
                                  std::uint64_t,
                                  double,
-                                 std::string>;
+                                 boost::string_view>;
 
 public:
     explicit ContentPacketRegion(const PacketSegment& segment, Scope::SP scope,
-                                 const yactfr::DataType& dataType,
-                                 const boost::optional<Value>& value);
+                                 const yactfr::DataType& dataType);
 
     const yactfr::DataType& dataType() const noexcept
     {
         return *_dataType;
     }
 
-    const boost::optional<Value>& value() const noexcept
-    {
-        return _value;
-    }
+    /*
+     * Decodes the value of this packet region from `bitArray`, the bit
+     * array of this packet region.
+     *
+     * Returns `boost::none` if this packet region's data type is not an
+     * integer, floating point number, or string type.
+     */
+    boost::optional<Value> value(const BitArray& bitArray) const;
 
 private:
     void _accept(PacketRegionVisitor& visitor) override;
 
 private:
     const yactfr::DataType *_dataType;
-    boost::optional<Value> _value;
 };
 
 } // namespace jacques
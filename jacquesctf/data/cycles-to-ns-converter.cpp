@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <yactfr/metadata/clock-type.hpp>
+
+#include "cycles-to-ns-converter.hpp"
+
+namespace jacques {
+
+constexpr unsigned long long CyclesToNsConverter::_nsInS;
+
+CyclesToNsConverter::CyclesToNsConverter(const unsigned long long frequency,
+                                         const long long offsetSeconds,
+                                         const unsigned long long offsetCycles) :
+    _freq {frequency},
+    _offsetCycles {offsetCycles},
+    _offsetNs {static_cast<_S128>(offsetSeconds) * static_cast<_S128>(_nsInS)}
+{
+    assert(frequency > 0);
+    assert(offsetCycles < frequency);
+
+    if (_nsInS % frequency == 0) {
+        _nsPerCycle = _nsInS / frequency;
+        return;
+    }
+
+    /*
+     * With a larger frequency, the quotient which the reciprocal gives
+     * within _divByFreq() could be more than a few units too small.
+     */
+    if (frequency <= (1ULL << 36)) {
+        _freqReciprocal = (static_cast<_U128>(1) << 64) / frequency;
+    }
+}
+
+CyclesToNsConverter::CyclesToNsConverter(const yactfr::ClockType& clockType) :
+    CyclesToNsConverter {
+        clockType.freq(),
+        clockType.offset().seconds(),
+        clockType.offset().cycles(),
+    }
+{
+}
+
+} // namespace jacques
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_CYCLES_TO_NS_CONVERTER_HPP
+#define _JACQUES_CYCLES_TO_NS_CONVERTER_HPP
+
+#include <limits>
+#include <yactfr/metadata/fwd.hpp>
+
+#include "aliases.hpp"
+
+namespace jacques {
+
+/*
+ * Converter of clock values (cycles) to nanoseconds from origin for a
+ * given clock frequency and offset.
+ *
+ * The constructor precomputes everything which only depends on the
+ * clock, so that nsFromOrigin() only performs 128-bit multiplications:
+ *
+ * * If the frequency divides 10^9 (1 GHz, 1 MHz, and so on), a
+ *   nanosecond is an integral number of cycles.
+ *
+ * * Otherwise, nsFromOrigin() divides by the frequency by multiplying
+ *   by its 64-bit fixed-point reciprocal and then corrects the
+ *   quotient, which is at most a few units too small.
+ *
+ * In both cases, the result is exactly the floor of
+ * `(offsetCycles + cycles) * 10^9 / frequency`, plus the offset in
+ * seconds, saturated to the range of `long long`.
+ */
+class CyclesToNsConverter
+{
+public:
+    explicit CyclesToNsConverter(unsigned long long frequency,
+                                 long long offsetSeconds,
+                                 unsigned long long offsetCycles);
+    explicit CyclesToNsConverter(const yactfr::ClockType& clockType);
+
+    unsigned long long frequency() const noexcept
+    {
+        return _freq;
+    }
+
+    long long nsFromOrigin(const unsigned long long cycles) const noexcept
+    {
+        const _U128 totalCycles = static_cast<_U128>(cycles) + _offsetCycles;
+        _U128 ns;
+
+        if (_nsPerCycle > 0) {
+            ns = totalCycles * _nsPerCycle;
+        } else {
+            // split the seconds so that the products below can't overflow
+            const auto seconds = this->_divByFreq(totalCycles);
+            const auto reducedCycles = totalCycles - seconds * _freq;
+
+            ns = seconds * _nsInS + this->_divByFreq(reducedCycles * _nsInS);
+        }
+
+        constexpr auto maxLl = std::numeric_limits<long long>::max();
+        constexpr auto minLl = std::numeric_limits<long long>::min();
+
+        // `ns` is less than 2^95: this sum can't overflow
+        const auto nsFromOrigin = _offsetNs + static_cast<_S128>(ns);
+
+        if (nsFromOrigin > maxLl) {
+            return maxLl;
+        } else if (nsFromOrigin < minLl) {
+            return minLl;
+        }
+
+        return static_cast<long long>(nsFromOrigin);
+    }
+
+private:
+    using _U128 = unsigned __int128;
+    using _S128 = __int128;
+
+    static constexpr unsigned long long _nsInS = 1'000'000'000ULL;
+
+private:
+    // floor of `value / _freq`
+    _U128 _divByFreq(const _U128 value) const noexcept
+    {
+        if (_freqReciprocal == 0) {
+            // the correction below could take too many steps
+            return value / _freq;
+        }
+
+        _U128 quotient = (value * _freqReciprocal) >> 64;
+
+        while ((quotient + 1) * _freq <= value) {
+            ++quotient;
+        }
+
+        return quotient;
+    }
+
+private:
+    unsigned long long _freq;
+    unsigned long long _offsetCycles;
+    _S128 _offsetNs;
+
+    // nanoseconds per cycle if the frequency divides 10^9, 0 otherwise
+    unsigned long long _nsPerCycle = 0;
+
+    // floor of `2^64 / _freq`, or 0 to divide
+    _U128 _freqReciprocal = 0;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_CYCLES_TO_NS_CONVERTER_HPP
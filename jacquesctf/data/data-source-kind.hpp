@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_DATA_SOURCE_KIND_HPP
+#define _JACQUES_DATA_SOURCE_KIND_HPP
+
+namespace jacques {
+
+// how the element sequence of a data stream file reads its data
+enum class DataSourceKind
+{
+    // memory-mapped file views (`yactfr::MemoryMappedFileViewFactory`)
+    MEMORY_MAPPED_FILE,
+
+    // `pread()` buffers, asking the kernel to read ahead
+    PREAD,
+
+    // `pread()` buffers, reading ahead on a background thread
+    PREAD_THREAD,
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_DATA_SOURCE_KIND_HPP
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cstdlib>
+
+#include "data-stream-file-handles.hpp"
+#include "pread-data-source-factory.hpp"
+
+namespace jacques {
+
+static std::shared_ptr<yactfr::DataSourceFactory> createFactory(const boost::filesystem::path& path,
+                                                                const DataSourceKind kind)
+{
+    switch (kind) {
+    case DataSourceKind::MEMORY_MAPPED_FILE:
+        return std::make_shared<yactfr::MemoryMappedFileViewFactory>(path.string(),
+                                                                     8 << 20,
+                                                                     yactfr::MemoryMappedFileViewFactory::AccessPattern::SEQUENTIAL);
+
+    case DataSourceKind::PREAD:
+        return std::make_shared<PreadDataSourceFactory>(path);
+
+    case DataSourceKind::PREAD_THREAD:
+        return std::make_shared<PreadDataSourceFactory>(path, 8 << 20, true);
+
+    default:
+        std::abort();
+    }
+}
+
+DataStreamFileHandles::DataStreamFileHandles(const boost::filesystem::path& path,
+                                             const Metadata& metadata,
+                                             const DataSourceKind dataSourceKind) :
+    _factory {createFactory(path, dataSourceKind)},
+    _mmapFactory {
+        dynamic_cast<yactfr::MemoryMappedFileViewFactory *>(_factory.get())
+    },
+    _seq {metadata.traceType(), _factory}
+{
+}
+
+} // namespace jacques
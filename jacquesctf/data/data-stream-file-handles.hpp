@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_DATA_STREAM_FILE_HANDLES_HPP
+#define _JACQUES_DATA_STREAM_FILE_HANDLES_HPP
+
+#include <memory>
+#include <boost/filesystem.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <yactfr/element-sequence.hpp>
+#include <yactfr/data-source-factory.hpp>
+#include <yactfr/memory-mapped-file-view-factory.hpp>
+
+#include "aliases.hpp"
+#include "metadata.hpp"
+#include "data-source-kind.hpp"
+
+namespace jacques {
+
+/*
+ * Open handles of a data stream file: a data source factory of kind
+ * `dataSourceKind` with its element sequence.
+ *
+ * The data source factory keeps a file descriptor open as long as it
+ * exists: an object which uses any of those handles (an element
+ * sequence iterator, for example) must keep a shared pointer to this
+ * object.
+ */
+class DataStreamFileHandles :
+    boost::noncopyable
+{
+public:
+    using SP = std::shared_ptr<DataStreamFileHandles>;
+
+public:
+    explicit DataStreamFileHandles(const boost::filesystem::path& path,
+                                   const Metadata& metadata,
+                                   DataSourceKind dataSourceKind = DataSourceKind::MEMORY_MAPPED_FILE);
+
+    // number of file descriptors which such an object keeps open
+    static constexpr Size fdCount() noexcept
+    {
+        return 1;
+    }
+
+    yactfr::DataSourceFactory& factory() noexcept
+    {
+        return *_factory;
+    }
+
+    // `nullptr` if the data source kind is not a memory-mapped file
+    yactfr::MemoryMappedFileViewFactory *memoryMappedFileViewFactory() noexcept
+    {
+        return _mmapFactory;
+    }
+
+    yactfr::ElementSequence& seq() noexcept
+    {
+        return _seq;
+    }
+
+private:
+    std::shared_ptr<yactfr::DataSourceFactory> _factory;
+    yactfr::MemoryMappedFileViewFactory *_mmapFactory = nullptr;
+    yactfr::ElementSequence _seq;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_DATA_STREAM_FILE_HANDLES_HPP
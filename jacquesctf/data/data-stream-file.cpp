@@ -8,40 +8,50 @@
 #include <cassert>
 #include <algorithm>
 #include <limits>
-#include <unistd.h>
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <fcntl.h>
 
 #include "data-stream-file.hpp"
-#include "io-error.hpp"
+#include "stats.hpp"
+#include "profiler.hpp"
 
 namespace jacques {
 
 DataStreamFile::DataStreamFile(const boost::filesystem::path& path,
-                               const Metadata& metadata) :
+                               const Metadata& metadata,
+                               FileHandlePool * const fileHandlePool,
+                               const DataSourceKind dataSourceKind,
+                               const PacketCacheConfig& packetCacheConfig) :
     _path {path},
     _metadata {&metadata},
-    _factory {
-        std::make_shared<yactfr::MemoryMappedFileViewFactory>(path.string(),
-                                                              8 << 20,
-                                                              yactfr::MemoryMappedFileViewFactory::AccessPattern::SEQUENTIAL)
-    },
-    _seq {_metadata->traceType(), _factory}
+    _fileHandlePool {fileHandlePool},
+    _dataSourceKind {dataSourceKind},
+    _packetCacheConfig {packetCacheConfig}
 {
     _fileSize = DataSize::fromBytes(boost::filesystem::file_size(path));
-    _fd = open(path.string().c_str(), O_RDONLY);
+}
+
+DataStreamFile::~DataStreamFile()
+{
+    // our packets are gone: nothing else uses our handles
+    _packets.clear();
 
-    if (_fd < 0) {
-        throw IOError {path, "Cannot open file."};
+    if (_fileHandlePool) {
+        _fileHandlePool->release(_path);
     }
 }
 
-DataStreamFile::~DataStreamFile()
+DataStreamFileHandles::SP DataStreamFile::_handles()
 {
-    if (_fd >= 0) {
-        (void) close(_fd);
+    if (_fileHandlePool) {
+        return _fileHandlePool->acquire(_path, *_metadata, _dataSourceKind);
+    }
+
+    if (!_ownHandles) {
+        _ownHandles = std::make_shared<DataStreamFileHandles>(_path,
+                                                              *_metadata,
+                                                              _dataSourceKind);
     }
+
+    return _ownHandles;
 }
 
 void DataStreamFile::buildIndex()
@@ -57,15 +67,29 @@ void DataStreamFile::buildIndex(const BuildIndexProgressFunc& progressFunc,
     }
 
     if (_fileSize == 0) {
+        _index.finish();
         _isIndexBuilt = true;
         return;
     }
 
-    const auto oldExpectedAccessPattern = _factory->expectedAccessPattern();
+    const auto handles = this->_handles();
+
+    // a `pread()` data source always reads ahead sequentially
+    const auto mmapFactory = handles->memoryMappedFileViewFactory();
+    auto oldExpectedAccessPattern = yactfr::MemoryMappedFileViewFactory::AccessPattern::SEQUENTIAL;
+
+    if (mmapFactory) {
+        oldExpectedAccessPattern = mmapFactory->expectedAccessPattern();
+        mmapFactory->expectedAccessPattern(yactfr::MemoryMappedFileViewFactory::AccessPattern::RANDOM);
+    }
+
+    this->_buildIndex(handles->seq(), progressFunc, step);
+    _index.finish();
+
+    if (mmapFactory) {
+        mmapFactory->expectedAccessPattern(oldExpectedAccessPattern);
+    }
 
-    _factory->expectedAccessPattern(yactfr::MemoryMappedFileViewFactory::AccessPattern::RANDOM);
-    this->_buildIndex(progressFunc, step);
-    _factory->expectedAccessPattern(oldExpectedAccessPattern);
     _isIndexBuilt = true;
     _packets.resize(_index.size());
 }
@@ -125,7 +149,7 @@ void DataStreamFile::_addPacketIndexEntry(const Index offsetInDataStreamFileByte
         _hasError = true;
     }
 
-    _index.push_back(PacketIndexEntry {
+    _index.append(PacketIndexEntry {
         _index.size(), offsetInDataStreamFileBytes,
         state.packetContextOffsetInPacketBits,
         state.preambleSize,
@@ -151,11 +175,152 @@ void DataStreamFile::_IndexBuildingState::reset()
     dst = nullptr;
 }
 
-void DataStreamFile::_buildIndex(const BuildIndexProgressFunc& progressFunc,
+std::vector<yactfr::ElementSequenceIterator> DataStreamFile::_createSearchIterators(yactfr::ElementSequence& seq,
+                                                                                   const Size packetCount,
+                                                                                   const Size maxWorkerCount)
+{
+    auto workerCount = std::min(static_cast<Size>(std::max(std::thread::hardware_concurrency(), 1U)),
+                                packetCount);
+
+    if (maxWorkerCount > 0) {
+        workerCount = std::min(workerCount, maxWorkerCount);
+    }
+
+    std::vector<yactfr::ElementSequenceIterator> its;
+
+    /*
+     * Create all the iterators from this thread: the workers only
+     * seek and advance their own iterator.
+     */
+    for (Index worker = 0; worker < workerCount; ++worker) {
+        its.push_back(std::begin(seq));
+    }
+
+    return its;
+}
+
+std::vector<PacketDecodingError> DataStreamFile::decodingErrors(const Size maxWorkerCount)
+{
+    assert(_isIndexBuilt);
+
+    const auto handles = this->_handles();
+    auto its = this->_createSearchIterators(handles->seq(), _index.size(),
+                                            maxWorkerCount);
+    const auto workerCount = its.size();
+    std::vector<boost::optional<PacketDecodingError>> packetErrors(_index.size());
+
+    utils::parallelFor(workerCount, [&](const Index worker) {
+        auto& it = its[worker];
+        const auto endIt = std::end(handles->seq());
+
+        for (auto index = worker; index < _index.size(); index += workerCount) {
+            try {
+                it.seekPacket(_index[index].offsetInDataStreamFileBytes());
+
+                while (it != endIt &&
+                        it->kind() != yactfr::Element::Kind::PACKET_END) {
+                    ++it;
+                }
+            } catch (const yactfr::DecodingError& ex) {
+                packetErrors[index] = PacketDecodingError {ex, _index[index]};
+            }
+        }
+    });
+
+    std::vector<PacketDecodingError> errors;
+
+    for (const auto& error : packetErrors) {
+        if (error) {
+            errors.push_back(*error);
+        }
+    }
+
+    return errors;
+}
+
+DataSize DataStreamFile::effectiveTotalSizeFromPacket(const Index packetIndex) const noexcept
+{
+    assert(_isIndexBuilt);
+    return _index.effectiveTotalSizeFrom(packetIndex);
+}
+
+void DataStreamFile::_startSearchProgress(SearchProgress * const progress,
+                                          const Index packetIndex) const
+{
+    if (!progress || progress->isStarted()) {
+        return;
+    }
+
+    progress->start(_index.size() - packetIndex,
+                    this->effectiveTotalSizeFromPacket(packetIndex));
+}
+
+boost::optional<Timestamp> DataStreamFile::eventRecordFirstTimestamp(const Index packetIndex,
+                                                                     const Index erIndexInPacket)
+{
+    using ElemKind = yactfr::Element::Kind;
+
+    assert(_isIndexBuilt);
+
+    if (packetIndex >= _index.size() || !_metadata->isCorrelatable()) {
+        return boost::none;
+    }
+
+    const auto handles = this->_handles();
+    auto it = std::begin(handles->seq());
+    const auto endIt = std::end(handles->seq());
+    Index erIndex = 0;
+    bool inEventRecord = false;
+
+    try {
+        it.seekPacket(_index[packetIndex].offsetInDataStreamFileBytes());
+
+        while (it != endIt && it->kind() != ElemKind::PACKET_END) {
+            switch (it->kind()) {
+            case ElemKind::EVENT_RECORD_BEGINNING:
+                inEventRecord = erIndex == erIndexInPacket;
+                break;
+
+            case ElemKind::EVENT_RECORD_END:
+                if (inEventRecord) {
+                    // no timestamp
+                    return boost::none;
+                }
+
+                ++erIndex;
+                break;
+
+            case ElemKind::CLOCK_VALUE:
+                if (inEventRecord) {
+                    auto& elem = static_cast<const yactfr::ClockValueElement&>(*it);
+
+                    return Timestamp {
+                        elem.cycles(), _metadata->cyclesToNsConverter(elem.clockType())
+                    };
+                }
+
+                break;
+
+            default:
+                break;
+            }
+
+            ++it;
+        }
+    } catch (const yactfr::DecodingError&) {
+        // no such event record
+    }
+
+    return boost::none;
+}
+
+void DataStreamFile::_buildIndex(yactfr::ElementSequence& seq,
+                                 const BuildIndexProgressFunc& progressFunc,
                                  const Size step)
 {
-    auto it = std::begin(_seq);
-    const auto endIt = std::end(_seq);
+    const profiler::Span span {"DataStreamFile::_buildIndex"};
+    auto it = std::begin(seq);
+    const auto endIt = std::end(seq);
     Index offsetBytes = 0;
     _IndexBuildingState state;
     bool packetStarted = false;
@@ -238,7 +403,9 @@ void DataStreamFile::_buildIndex(const BuildIndexProgressFunc& progressFunc,
 
                 auto& elem = static_cast<const yactfr::ClockValueElement&>(*it);
 
-                state.tsBegin = Timestamp {elem};
+                state.tsBegin = Timestamp {
+                    elem.cycles(), _metadata->cyclesToNsConverter(elem.clockType())
+                };
                 break;
             }
 
@@ -251,7 +418,9 @@ void DataStreamFile::_buildIndex(const BuildIndexProgressFunc& progressFunc,
 
                 auto& elem = static_cast<const yactfr::PacketEndClockValueElement&>(*it);
 
-                state.tsEnd = Timestamp {elem};
+                state.tsEnd = Timestamp {
+                    elem.cycles(), _metadata->cyclesToNsConverter(elem.clockType())
+                };
                 break;
             }
 
@@ -321,90 +490,41 @@ bool DataStreamFile::hasOffsetBits(const Index offsetBits)
 
     assert(!_index.empty());
 
-    return offsetBits < _index.back().endOffsetInDataStreamFileBits();
+    return offsetBits < _index.endOffsetInDataStreamFileBits();
 }
 
 const PacketIndexEntry& DataStreamFile::packetIndexEntryContainingOffsetBits(const Index offsetBits)
 {
     assert(this->hasOffsetBits(offsetBits));
-
-    auto it = std::upper_bound(std::begin(_index), std::end(_index),
-                               offsetBits, [](const auto offsetBits,
-                                              const auto& entry) {
-        return offsetBits <
-               entry.offsetInDataStreamFileBits() + entry.effectiveTotalSize();
-    });
-
-    assert(it != std::end(_index));
-    assert(offsetBits >= it->offsetInDataStreamFileBits() &&
-           offsetBits < it->offsetInDataStreamFileBits() +
-                        it->effectiveTotalSize());
-
-
-    return *it;
+    return _index[_index.indexContainingOffsetBits(offsetBits)];
 }
 
 const PacketIndexEntry *DataStreamFile::packetIndexEntryContainingNsFromOrigin(const long long nsFromOrigin)
-{
-    const auto tsLtCompFunc = [](const Timestamp& ts,
-                                 const long long nsFromOrigin) -> bool {
-        return ts.nsFromOrigin() < nsFromOrigin;
-    };
-    const auto valueInTsFunc = [](const long long nsFromOrigin,
-                                  const PacketIndexEntry& entry) -> bool {
-        return nsFromOrigin >= entry.beginningTimestamp()->nsFromOrigin() &&
-               nsFromOrigin < entry.endTimestamp()->nsFromOrigin();
-    };
-
-    return this->_packetIndexEntryContainingValue(tsLtCompFunc, valueInTsFunc,
-                                                  nsFromOrigin);
-}
-
-const PacketIndexEntry *DataStreamFile::packetIndexEntryContainingCycles(const unsigned long long cycles)
-{
-    const auto tsLtCompFunc = [](const Timestamp& ts,
-                                 const unsigned long long cycles) -> bool {
-        return ts.cycles() < cycles;
-    };
-    const auto valueInTsFunc = [](const unsigned long long cycles,
-                                  const PacketIndexEntry& entry) -> bool {
-        return cycles >= entry.beginningTimestamp()->cycles() &&
-               cycles < entry.endTimestamp()->cycles();
-    };
-
-    return this->_packetIndexEntryContainingValue(tsLtCompFunc, valueInTsFunc,
-                                                  cycles);
-}
-
-const PacketIndexEntry *DataStreamFile::packetIndexEntryWithSeqNum(const Index seqNum)
 {
     assert(_isIndexBuilt);
 
-    if (_index.empty()) {
+    if (!_metadata->isCorrelatable()) {
         return nullptr;
     }
 
-    auto it = std::upper_bound(std::begin(_index), std::end(_index),
-                               seqNum, [](const auto seqNum,
-                                          const auto& entry) {
-        if (entry.seqNum()) {
-            return seqNum < *entry.seqNum();
-        }
-
-        return true;
-    });
+    return _index.entryContainingNsFromOrigin(nsFromOrigin);
+}
 
-    --it;
+const PacketIndexEntry *DataStreamFile::packetIndexEntryContainingCycles(const unsigned long long cycles)
+{
+    assert(_isIndexBuilt);
 
-    if (!it->seqNum()) {
+    if (!_metadata->isCorrelatable()) {
         return nullptr;
     }
 
-    if (*it->seqNum() != seqNum) {
-        return nullptr;
-    }
+    return _index.entryContainingCycles(cycles);
+}
 
-    return &(*it);
+const PacketIndexEntry *DataStreamFile::packetIndexEntryWithSeqNum(const Index seqNum)
+{
+    assert(_isIndexBuilt);
+    return _index.entryWithSeqNum(seqNum);
 }
 
 Packet& DataStreamFile::packetAtIndex(const Index index,
@@ -415,15 +535,21 @@ Packet& DataStreamFile::packetAtIndex(const Index index,
 
     if (!_packets[index]) {
         auto& packetIndexEntry = _index[index];
-        auto mmapFile = std::make_unique<MemoryMappedFile>(_path, _fd);
+        auto mmapFile = std::make_unique<MemoryMappedFile>(_path);
 
         buildListener.startBuild(packetIndexEntry);
 
-        auto packet = std::make_unique<Packet>(packetIndexEntry, _seq,
+        // the packet reacquires our handles for each decoding operation
+        const auto acquireFileHandles = [this] {
+            return this->_handles();
+        };
+
+        auto packet = std::make_unique<Packet>(packetIndexEntry,
+                                               acquireFileHandles,
                                                *_metadata,
-                                               _factory->createDataSource(),
                                                std::move(mmapFile),
-                                               buildListener);
+                                               buildListener,
+                                               _packetCacheConfig);
 
         buildListener.endBuild();
 
@@ -433,6 +559,9 @@ Packet& DataStreamFile::packetAtIndex(const Index index,
 
         packetIndexEntry.eventRecordCount(packet->eventRecordCount());
         _packets[index] = std::move(packet);
+        stats::inc(stats::Counter::PACKETS_CREATED);
+    } else {
+        stats::inc(stats::Counter::PACKET_HITS);
     }
 
     return *_packets[index];
@@ -9,20 +9,33 @@
 #define _JACQUES_DATA_STREAM_FILE_HPP
 
 #include <cassert>
+#include <algorithm>
 #include <vector>
+#include <string>
+#include <utility>
+#include <atomic>
 #include <functional>
 #include <boost/filesystem.hpp>
 #include <boost/core/noncopyable.hpp>
 #include <yactfr/element-sequence.hpp>
+#include <yactfr/element.hpp>
+#include <yactfr/decoding-errors.hpp>
 #include <yactfr/metadata/fwd.hpp>
-#include <yactfr/memory-mapped-file-view-factory.hpp>
 
 #include "aliases.hpp"
 #include "packet.hpp"
 #include "packet-index-entry.hpp"
+#include "packet-index.hpp"
+#include "data-stream-file-handles.hpp"
+#include "file-handle-pool.hpp"
+#include "data-source-kind.hpp"
+#include "packet-cache-config.hpp"
 #include "metadata.hpp"
 #include "data-size.hpp"
+#include "timestamp.hpp"
 #include "packet-checkpoints-build-listener.hpp"
+#include "search-progress.hpp"
+#include "utils.hpp"
 
 namespace jacques {
 
@@ -33,8 +46,26 @@ public:
     using BuildIndexProgressFunc = std::function<void (const PacketIndexEntry&)>;
 
 public:
+    /*
+     * The constructor doesn't open the file: the data stream file
+     * opens it on first use.
+     *
+     * If `fileHandlePool` is not null, the data stream file acquires
+     * its open handles from this pool, which can close them when it
+     * has too many open ones. Otherwise, the data stream file keeps
+     * its handles open once it opens them.
+     *
+     * `dataSourceKind` is how the element sequences of this data
+     * stream file read its data.
+     *
+     * `packetCacheConfig` is the caching configuration of the packets
+     * which packetAtIndex() creates.
+     */
     explicit DataStreamFile(const boost::filesystem::path& path,
-                            const Metadata& metadata);
+                            const Metadata& metadata,
+                            FileHandlePool *fileHandlePool = nullptr,
+                            DataSourceKind dataSourceKind = DataSourceKind::MEMORY_MAPPED_FILE,
+                            const PacketCacheConfig& packetCacheConfig = PacketCacheConfig {});
     ~DataStreamFile();
     void buildIndex();
     void buildIndex(const BuildIndexProgressFunc& progressFunc,
@@ -46,6 +77,96 @@ public:
     const PacketIndexEntry *packetIndexEntryContainingNsFromOrigin(long long nsFromOrigin);
     const PacketIndexEntry *packetIndexEntryContainingCycles(unsigned long long cycles);
 
+    /*
+     * Finds the first event record, from the event record at index
+     * `erIndexInPacket` within the packet at index `packetIndex`, which
+     * `matcher` matches.
+     *
+     * `matcher` must have the following const methods (see
+     * `EventRecordMatcher`):
+     *
+     *     bool eventRecordTypeMatches(const yactfr::EventRecordType&);
+     *     bool hasDataType(const yactfr::DataType&);
+     *     bool signedIntMatches(const yactfr::DataType&, long long);
+     *     bool unsignedIntMatches(const yactfr::DataType&, unsigned long long);
+     *     bool floatMatches(const yactfr::DataType&, double);
+     *     bool stringMatches(const yactfr::DataType&, const std::string&);
+     *
+     * An event record matches when any of those methods returns true
+     * for its type or for one of its field values.
+     *
+     * This method reads the values of the decoded elements directly: it
+     * doesn't create packet objects or packet regions. It scans the
+     * packets concurrently, each worker using its own element sequence
+     * iterator, and stops as soon as a packet preceding all the
+     * remaining ones contains a match.
+     *
+     * If `progress` is set, this method reports its progress to it and
+     * stops scanning, between two packets, as soon as it's canceled. If
+     * `progress` is already started, this method doesn't restart it:
+     * the caller started it for a wider search.
+     *
+     * If `maxWorkerCount` is not 0, this method scans with at most
+     * `maxWorkerCount` concurrent workers.
+     *
+     * If `minNsFromOrigin` is set, this method skips the event records
+     * of which the first timestamp is less than it (nanoseconds from
+     * origin) while scanning. An event record without a timestamp is
+     * never skipped.
+     *
+     * Returns the index of the packet and the index of the event record
+     * within this packet, or `boost::none` if there's no such event
+     * record or if the search is canceled.
+     */
+    template <typename MatcherT>
+    boost::optional<std::pair<Index, Index>> findEventRecord(Index packetIndex,
+                                                             Index erIndexInPacket,
+                                                             const MatcherT& matcher,
+                                                             SearchProgress *progress = nullptr,
+                                                             Size maxWorkerCount = 0,
+                                                             const boost::optional<long long>& minNsFromOrigin = boost::none);
+
+    /*
+     * Finds all the event records of this data stream file which
+     * `matcher` matches (see findEventRecord()), scanning the packets
+     * concurrently.
+     *
+     * Returns the (packet index, event record index within packet)
+     * pairs of the matching event records, in data stream file order,
+     * or nothing if the search is canceled (see findEventRecord() for
+     * `progress`).
+     */
+    template <typename MatcherT>
+    std::vector<std::pair<Index, Index>> findEventRecords(const MatcherT& matcher,
+                                                          SearchProgress *progress = nullptr);
+
+    /*
+     * Returns the first timestamp of the event record at index
+     * `erIndexInPacket` within the packet at index `packetIndex`, or
+     * `boost::none` if there's no such event record, if it has no
+     * timestamp, or if the metadata is not correlatable.
+     *
+     * Like findEventRecord(), this method reads the decoded elements
+     * directly: it doesn't create a packet object, so that it's safe to
+     * call it from a search worker.
+     */
+    boost::optional<Timestamp> eventRecordFirstTimestamp(Index packetIndex,
+                                                         Index erIndexInPacket);
+
+    /*
+     * Fully decodes all the packets of this data stream file
+     * concurrently (at most `maxWorkerCount` workers if not 0) and
+     * returns the decoding error of each invalid packet, in data stream
+     * file order.
+     *
+     * Like findEventRecord(), this method reads the decoded elements
+     * directly: it doesn't create packet objects.
+     */
+    std::vector<PacketDecodingError> decodingErrors(Size maxWorkerCount = 0);
+
+    // total effective size of the packets from index `packetIndex`
+    DataSize effectiveTotalSizeFromPacket(Index packetIndex) const noexcept;
+
     Size packetCount() const noexcept
     {
         assert(_isIndexBuilt);
@@ -69,10 +190,17 @@ public:
     const std::vector<PacketIndexEntry>& packetIndexEntries() const noexcept
     {
         assert(_isIndexBuilt);
-        return _index;
+        return _index.entries();
     }
 
     std::vector<PacketIndexEntry>& packetIndexEntries() noexcept
+    {
+        assert(_isIndexBuilt);
+        return _index.entries();
+    }
+
+    // packet index, with its columns and aggregates
+    const PacketIndex& packetIndex() const noexcept
     {
         assert(_isIndexBuilt);
         return _index;
@@ -117,76 +245,336 @@ private:
     };
 
 private:
-    void _buildIndex(const BuildIndexProgressFunc& progressFunc,
-                     Size step);
+    DataStreamFileHandles::SP _handles();
+    void _buildIndex(yactfr::ElementSequence& seq,
+                     const BuildIndexProgressFunc& progressFunc, Size step);
     void _addPacketIndexEntry(Index offsetInDataStreamFileBytes,
                               Index offsetInDataStreamFileBits,
                               const _IndexBuildingState& state,
                               bool isInvalid);
 
-    template <typename TsLtCompFuncT, typename ValueInTsFuncT, typename ValueT>
-    const PacketIndexEntry *_packetIndexEntryContainingValue(TsLtCompFuncT&& tsLtCompFunc,
-                                                             ValueInTsFuncT&& valueInTsFunc,
-                                                             const ValueT value)
-    {
-        if (!_metadata->isCorrelatable()) {
-            return nullptr;
-        }
+    std::vector<yactfr::ElementSequenceIterator> _createSearchIterators(yactfr::ElementSequence& seq,
+                                                                        Size packetCount,
+                                                                        Size maxWorkerCount = 0);
+    void _startSearchProgress(SearchProgress *progress, Index packetIndex) const;
 
-        if (_index.empty()) {
-            return nullptr;
-        }
+    template <typename MatcherT>
+    void _findEventRecordsInPacket(yactfr::ElementSequence& seq,
+                                   yactfr::ElementSequenceIterator& it,
+                                   const PacketIndexEntry& entry,
+                                   Index erIndexInPacket,
+                                   const MatcherT& matcher, bool findAll,
+                                   const boost::optional<long long>& minNsFromOrigin,
+                                   std::vector<Index>& erIndexes);
 
-        auto it = std::lower_bound(std::begin(_index), std::end(_index),
-                                   value, [tsLtCompFunc](const auto& entry,
-                                                         const auto value) {
-            if (!entry.beginningTimestamp()) {
-                return false;
+private:
+    const boost::filesystem::path _path;
+    const Metadata * const _metadata;
+    FileHandlePool * const _fileHandlePool;
+    const DataSourceKind _dataSourceKind;
+    const PacketCacheConfig _packetCacheConfig;
+
+    // open handles when there's no file handle pool
+    DataStreamFileHandles::SP _ownHandles;
+
+    DataSize _fileSize;
+    PacketIndex _index;
+    std::vector<std::unique_ptr<Packet>> _packets;
+    bool _isIndexBuilt = false;
+    bool _hasError = false;
+};
+
+template <typename MatcherT>
+boost::optional<std::pair<Index, Index>> DataStreamFile::findEventRecord(const Index packetIndex,
+                                                                         const Index erIndexInPacket,
+                                                                         const MatcherT& matcher,
+                                                                         SearchProgress * const progress,
+                                                                         const Size maxWorkerCount,
+                                                                         const boost::optional<long long>& minNsFromOrigin)
+{
+    assert(_isIndexBuilt);
+
+    if (packetIndex >= _index.size()) {
+        return boost::none;
+    }
+
+    this->_startSearchProgress(progress, packetIndex);
+
+    /*
+     * Worker `w` scans the packets at indexes `packetIndex + w`,
+     * `packetIndex + w + workerCount`, and so on.
+     */
+    const auto handles = this->_handles();
+    auto its = this->_createSearchIterators(handles->seq(),
+                                            _index.size() - packetIndex,
+                                            maxWorkerCount);
+    const auto workerCount = its.size();
+
+    // lowest index of a packet containing a match so far
+    std::atomic<Index> firstMatchPacketIndex {_index.size()};
+    std::vector<boost::optional<std::pair<Index, Index>>> workerMatches(workerCount);
+
+    utils::parallelFor(workerCount, [&](const Index worker) {
+        std::vector<Index> erIndexes;
+
+        for (auto index = packetIndex + worker; index < _index.size();
+                index += workerCount) {
+            if (index > firstMatchPacketIndex.load()) {
+                // another worker found a match in a preceding packet
+                break;
+            }
+
+            if (progress && progress->isCanceled()) {
+                break;
             }
 
-            return std::forward<TsLtCompFuncT>(tsLtCompFunc)(*entry.beginningTimestamp(),
-                                                             value);
-        });
+            erIndexes.clear();
+            this->_findEventRecordsInPacket(handles->seq(), its[worker],
+                                            _index[index],
+                                            index == packetIndex ?
+                                            erIndexInPacket : 0,
+                                            matcher, false, minNsFromOrigin,
+                                            erIndexes);
 
-        if (it == std::end(_index)) {
-            --it;
+            if (progress) {
+                progress->packetScanned(_index[index]);
+            }
+
+            if (!erIndexes.empty()) {
+                workerMatches[worker] = std::make_pair(index, erIndexes.front());
+
+                auto curIndex = firstMatchPacketIndex.load();
+
+                while (index < curIndex &&
+                        !firstMatchPacketIndex.compare_exchange_weak(curIndex, index));
+
+                break;
+            }
         }
+    });
+
+    boost::optional<std::pair<Index, Index>> match;
+
+    if (progress && progress->isCanceled()) {
+        return match;
+    }
 
-        if (!it->beginningTimestamp() || !it->endTimestamp()) {
-            return nullptr;
+    for (const auto& workerMatch : workerMatches) {
+        if (workerMatch && (!match || workerMatch->first < match->first)) {
+            match = workerMatch;
         }
+    }
 
-        if (!std::forward<ValueInTsFuncT>(valueInTsFunc)(value, *it)) {
-            if (it == std::begin(_index)) {
-                return nullptr;
-            }
+    return match;
+}
+
+template <typename MatcherT>
+std::vector<std::pair<Index, Index>> DataStreamFile::findEventRecords(const MatcherT& matcher,
+                                                                      SearchProgress * const progress)
+{
+    assert(_isIndexBuilt);
+
+    this->_startSearchProgress(progress, 0);
 
-            --it;
+    const auto handles = this->_handles();
+    auto its = this->_createSearchIterators(handles->seq(), _index.size());
+    const auto workerCount = its.size();
 
-            if (!it->beginningTimestamp() || !it->endTimestamp()) {
-                return nullptr;
+    // event record indexes of the matches, per packet
+    std::vector<std::vector<Index>> packetErIndexes(_index.size());
+
+    utils::parallelFor(workerCount, [&](const Index worker) {
+        for (auto index = worker; index < _index.size(); index += workerCount) {
+            if (progress && progress->isCanceled()) {
+                break;
             }
 
-            if (!std::forward<ValueInTsFuncT>(valueInTsFunc)(value, *it)) {
-                return nullptr;
+            this->_findEventRecordsInPacket(handles->seq(), its[worker],
+                                            _index[index], 0, matcher, true,
+                                            boost::none,
+                                            packetErIndexes[index]);
+
+            if (progress) {
+                progress->packetScanned(_index[index]);
             }
         }
+    });
 
-        return &*it;
+    std::vector<std::pair<Index, Index>> matches;
+
+    if (progress && progress->isCanceled()) {
+        return matches;
     }
 
-private:
-    const boost::filesystem::path _path;
-    const Metadata * const _metadata;
-    std::shared_ptr<yactfr::MemoryMappedFileViewFactory> _factory;
-    yactfr::ElementSequence _seq;
-    DataSize _fileSize;
-    std::vector<PacketIndexEntry> _index;
-    std::vector<std::unique_ptr<Packet>> _packets;
-    int _fd;
-    bool _isIndexBuilt = false;
-    bool _hasError = false;
-};
+    for (Index packetIndex = 0; packetIndex < packetErIndexes.size();
+            ++packetIndex) {
+        for (const auto erIndex : packetErIndexes[packetIndex]) {
+            matches.emplace_back(packetIndex, erIndex);
+        }
+    }
+
+    return matches;
+}
+
+template <typename MatcherT>
+void DataStreamFile::_findEventRecordsInPacket(yactfr::ElementSequence& seq,
+                                               yactfr::ElementSequenceIterator& it,
+                                               const PacketIndexEntry& entry,
+                                               const Index erIndexInPacket,
+                                               const MatcherT& matcher,
+                                               const bool findAll,
+                                               const boost::optional<long long>& minNsFromOrigin,
+                                               std::vector<Index>& erIndexes)
+{
+    using ElemKind = yactfr::Element::Kind;
+
+    const auto endIt = std::end(seq);
+    Index erIndex = 0;
+    bool isErCandidate = false;
+    bool erMatches = false;
+    bool erHasTs = false;
+    std::string str;
+
+    try {
+        it.seekPacket(entry.offsetInDataStreamFileBytes());
+
+        while (it != endIt && it->kind() != ElemKind::PACKET_END) {
+            switch (it->kind()) {
+            case ElemKind::EVENT_RECORD_BEGINNING:
+                isErCandidate = erIndex >= erIndexInPacket;
+                erMatches = false;
+                erHasTs = false;
+                break;
+
+            case ElemKind::CLOCK_VALUE:
+                if (isErCandidate && !erHasTs && minNsFromOrigin) {
+                    // first timestamp of the event record
+                    auto& elem = static_cast<const yactfr::ClockValueElement&>(*it);
+                    const Timestamp ts {
+                        elem.cycles(), _metadata->cyclesToNsConverter(elem.clockType())
+                    };
+
+                    erHasTs = true;
+
+                    if (ts.nsFromOrigin() < *minNsFromOrigin) {
+                        // too early, even if it matches already
+                        isErCandidate = false;
+                        erMatches = false;
+                    }
+                }
+
+                break;
+
+            case ElemKind::EVENT_RECORD_TYPE:
+                if (isErCandidate && !erMatches) {
+                    auto& elem = static_cast<const yactfr::EventRecordTypeElement&>(*it);
+
+                    erMatches = matcher.eventRecordTypeMatches(elem.eventRecordType());
+                }
+
+                break;
+
+            case ElemKind::EVENT_RECORD_END:
+                if (erMatches) {
+                    erIndexes.push_back(erIndex);
+
+                    if (!findAll) {
+                        return;
+                    }
+                }
+
+                isErCandidate = false;
+                ++erIndex;
+                break;
+
+            case ElemKind::SIGNED_INT:
+            case ElemKind::SIGNED_ENUM:
+                if (isErCandidate && !erMatches) {
+                    auto& elem = static_cast<const yactfr::SignedIntElement&>(*it);
+
+                    erMatches = matcher.signedIntMatches(elem.type(),
+                                                         elem.value());
+                }
+
+                break;
+
+            case ElemKind::UNSIGNED_INT:
+            case ElemKind::UNSIGNED_ENUM:
+                if (isErCandidate && !erMatches) {
+                    auto& elem = static_cast<const yactfr::UnsignedIntElement&>(*it);
+
+                    erMatches = matcher.unsignedIntMatches(elem.type(),
+                                                           elem.value());
+                }
+
+                break;
+
+            case ElemKind::FLOAT:
+                if (isErCandidate && !erMatches) {
+                    auto& elem = static_cast<const yactfr::FloatElement&>(*it);
+
+                    erMatches = matcher.floatMatches(elem.type(), elem.value());
+                }
+
+                break;
+
+            case ElemKind::STRING_BEGINNING:
+            case ElemKind::STATIC_TEXT_ARRAY_BEGINNING:
+            case ElemKind::DYNAMIC_TEXT_ARRAY_BEGINNING:
+            {
+                if (!isErCandidate || erMatches) {
+                    break;
+                }
+
+                const yactfr::DataType *type;
+
+                if (it->kind() == ElemKind::STRING_BEGINNING) {
+                    type = &static_cast<const yactfr::StringBeginningElement&>(*it).type();
+                } else if (it->kind() == ElemKind::STATIC_TEXT_ARRAY_BEGINNING) {
+                    type = &static_cast<const yactfr::StaticTextArrayBeginningElement&>(*it).type();
+                } else {
+                    type = &static_cast<const yactfr::DynamicTextArrayBeginningElement&>(*it).type();
+                }
+
+                if (!matcher.hasDataType(*type)) {
+                    // let the substrings go by
+                    break;
+                }
+
+                // assemble the string up to its first null character
+                bool isStrComplete = false;
+
+                str.clear();
+                ++it;
+
+                while (it->kind() == ElemKind::SUBSTRING) {
+                    auto& elem = static_cast<const yactfr::SubstringElement&>(*it);
+
+                    if (!isStrComplete) {
+                        const auto nullIt = std::find(elem.begin(), elem.end(), '\0');
+
+                        str.append(elem.begin(), nullIt);
+                        isStrComplete = nullIt != elem.end();
+                    }
+
+                    ++it;
+                }
+
+                // `it` is now at the string/text array end element
+                erMatches = matcher.stringMatches(*type, str);
+                break;
+            }
+
+            default:
+                break;
+            }
+
+            ++it;
+        }
+    } catch (const yactfr::DecodingError&) {
+        // no more matches within this packet
+    }
+}
 
 } // namespace jacques
 
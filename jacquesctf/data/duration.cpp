@@ -5,6 +5,11 @@
  * prohibited. Proprietary and confidential.
  */
 
+#include <cassert>
+#include <cstring>
+#include <array>
+#include <algorithm>
+
 #include "duration.hpp"
 #include "utils.hpp"
 
@@ -29,41 +34,37 @@ Duration::Parts Duration::parts() const
 
 void Duration::format(char * const buf, const Size bufSize) const
 {
-    // TODO: use bufSize
-    JACQUES_UNUSED(bufSize);
+    assert(bufSize > 0);
 
-    auto bufAt = buf;
+    std::array<char, 64> tmpBuf;
+    auto bufAt = tmpBuf.data();
     const auto parts = this->parts();
 
     if (parts.hours > 0) {
-        bufAt += std::sprintf(bufAt, "%llu:", parts.hours);
+        bufAt += utils::formatDecimal(bufAt, parts.hours);
+        *bufAt++ = ':';
     }
 
     if (parts.minutes > 0 || parts.hours > 0) {
-        const char *fmt;
-
-        if (parts.hours > 0) {
-            fmt = "%02llu:";
-        } else {
-            fmt = "%llu:";
-        }
-
-        bufAt += std::sprintf(bufAt, fmt, parts.minutes);
+        bufAt += utils::formatDecimal(bufAt, parts.minutes, boost::none,
+                                      parts.hours > 0 ? 2 : 1);
+        *bufAt++ = ':';
     }
 
     if (parts.seconds > 0 || parts.minutes > 0 || parts.hours > 0) {
-        const char *fmt;
+        bufAt += utils::formatDecimal(bufAt, parts.seconds, boost::none,
+                                      (parts.minutes > 0 || parts.hours > 0) ? 2 : 1);
+    }
 
-        if (parts.minutes > 0 || parts.hours > 0) {
-            fmt = "%02llu";
-        } else {
-            fmt = "%llu";
-        }
+    *bufAt++ = '.';
+    bufAt += utils::formatDecimal(bufAt, parts.ns, boost::none, 9);
 
-        bufAt += std::sprintf(bufAt, fmt, parts.seconds);
-    }
+    // truncate like snprintf() does
+    const auto len = std::min(static_cast<Size>(bufAt - tmpBuf.data()),
+                              bufSize - 1);
 
-    std::sprintf(bufAt, ".%09llu", parts.ns);
+    std::memcpy(buf, tmpBuf.data(), len);
+    buf[len] = '\0';
 }
 
 std::string Duration::format() const
@@ -61,7 +61,9 @@ EventRecord::SP EventRecord::createFromElementSequenceIterator(yactfr::ElementSe
 
                 auto& elem = static_cast<const yactfr::ClockValueElement&>(*it);
 
-                eventRecord->firstTimestamp(Timestamp {elem});
+                eventRecord->firstTimestamp(Timestamp {
+                    elem.cycles(), metadata.cyclesToNsConverter(elem.clockType())
+                });
                 break;
             }
 
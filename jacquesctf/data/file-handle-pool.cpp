@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <algorithm>
+#include <sys/resource.h>
+
+#include "file-handle-pool.hpp"
+#include "stats.hpp"
+
+namespace jacques {
+
+FileHandlePool::FileHandlePool(const boost::optional<Size>& maxFdCount) :
+    _maxFdCount {maxFdCount ? *maxFdCount : FileHandlePool::defaultMaxFdCount()}
+{
+    assert(_maxFdCount >= DataStreamFileHandles::fdCount());
+}
+
+Size FileHandlePool::defaultMaxFdCount()
+{
+    // usual soft limit if unknown
+    Size limit = 1024;
+    struct rlimit rl;
+
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0) {
+        limit = rl.rlim_cur == RLIM_INFINITY ? 65536 :
+                static_cast<Size>(rl.rlim_cur);
+    }
+
+    /*
+     * Keep an eighth of the limit, at least 32 file descriptors, for
+     * the files which aren't in a pool: metadata streams, the memory-
+     * mapped files while they're being mapped, the terminal, and the
+     * like.
+     */
+    const auto reserve = std::max(limit / 8, static_cast<Size>(32));
+
+    return std::max(limit > reserve ? limit - reserve : 0,
+                    static_cast<Size>(16));
+}
+
+DataStreamFileHandles::SP FileHandlePool::acquire(const boost::filesystem::path& path,
+                                                  const Metadata& metadata,
+                                                  const DataSourceKind dataSourceKind)
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+    const auto it = _entryIts.find(path);
+
+    if (it != std::end(_entryIts)) {
+        // most recently acquired now
+        _entries.splice(std::begin(_entries), _entries, it->second);
+        return it->second->second;
+    }
+
+    this->_trim();
+
+    auto handles = std::make_shared<DataStreamFileHandles>(path, metadata,
+                                                            dataSourceKind);
+
+    _fdCount += handles->fdCount();
+    _entries.emplace_front(path, handles);
+    _entryIts[path] = std::begin(_entries);
+    stats::inc(stats::Counter::FILE_HANDLES_OPENED);
+    return handles;
+}
+
+void FileHandlePool::_trim()
+{
+    /*
+     * Make room for the file descriptors of one more entry, closing the
+     * least recently acquired handles first. A use count of 1 means that only this
+     * pool has them: nothing can acquire them again without locking
+     * our mutex, so that it's safe to close them.
+     */
+    auto it = std::end(_entries);
+
+    while (_fdCount + DataStreamFileHandles::fdCount() > _maxFdCount &&
+            it != std::begin(_entries)) {
+        --it;
+
+        if (it->second.use_count() > 1) {
+            continue;
+        }
+
+        _fdCount -= it->second->fdCount();
+        _entryIts.erase(it->first);
+        it = _entries.erase(it);
+        stats::inc(stats::Counter::FILE_HANDLES_CLOSED);
+    }
+}
+
+void FileHandlePool::release(const boost::filesystem::path& path)
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+    const auto it = _entryIts.find(path);
+
+    if (it == std::end(_entryIts) || it->second->second.use_count() > 1) {
+        return;
+    }
+
+    _fdCount -= it->second->second->fdCount();
+    _entries.erase(it->second);
+    _entryIts.erase(it);
+    stats::inc(stats::Counter::FILE_HANDLES_CLOSED);
+}
+
+Size FileHandlePool::openCount() const
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    return _entries.size();
+}
+
+Size FileHandlePool::fdCount() const
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    return _fdCount;
+}
+
+} // namespace jacques
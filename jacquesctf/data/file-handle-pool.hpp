@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_FILE_HANDLE_POOL_HPP
+#define _JACQUES_FILE_HANDLE_POOL_HPP
+
+#include <list>
+#include <mutex>
+#include <utility>
+#include <unordered_map>
+#include <boost/filesystem.hpp>
+#include <boost/optional.hpp>
+#include <boost/core/noncopyable.hpp>
+
+#include "aliases.hpp"
+#include "metadata.hpp"
+#include "data-stream-file-handles.hpp"
+#include "data-source-kind.hpp"
+
+namespace jacques {
+
+/*
+ * Thread-safe pool of the open handles of many data stream files.
+ *
+ * acquire() opens the handles of a data stream file on first use and
+ * returns them. When the handles of the pool would keep more than its
+ * maximum number of file descriptors open, it closes the least recently
+ * acquired ones which nothing else uses anymore (only the pool has a
+ * shared pointer to them): the next acquire() for those data stream
+ * files reopens them.
+ *
+ * Handles which are still in use (by an element sequence iterator, for
+ * example) remain open, so that the pool can exceed its maximum when
+ * more handles are in use at the same time.
+ */
+class FileHandlePool :
+    boost::noncopyable
+{
+public:
+    /*
+     * Builds a file handle pool keeping at most `maxFdCount` file
+     * descriptors open, or defaultMaxFdCount() if not set.
+     */
+    explicit FileHandlePool(const boost::optional<Size>& maxFdCount = boost::none);
+
+    /*
+     * Default maximum number of file descriptors of a pool: the soft
+     * `RLIMIT_NOFILE` limit of the process, minus a reserve for the
+     * other files (metadata streams, terminal, and the like).
+     */
+    static Size defaultMaxFdCount();
+
+    /*
+     * Returns the open handles of the data stream file `path`, opening
+     * them (using `metadata` and `dataSourceKind`) if needed.
+     */
+    DataStreamFileHandles::SP acquire(const boost::filesystem::path& path,
+                                      const Metadata& metadata,
+                                      DataSourceKind dataSourceKind = DataSourceKind::MEMORY_MAPPED_FILE);
+
+    // closes the handles of `path` if nothing else uses them
+    void release(const boost::filesystem::path& path);
+
+    // current number of open handles within this pool
+    Size openCount() const;
+
+    // current number of file descriptors which this pool keeps open
+    Size fdCount() const;
+
+private:
+    using _Entry = std::pair<boost::filesystem::path, DataStreamFileHandles::SP>;
+    using _Entries = std::list<_Entry>;
+
+    struct _PathHash
+    {
+        std::size_t operator()(const boost::filesystem::path& path) const
+        {
+            return boost::filesystem::hash_value(path);
+        }
+    };
+
+private:
+    void _trim();
+
+private:
+    const Size _maxFdCount;
+    mutable std::mutex _mutex;
+    Size _fdCount = 0;
+
+    // most recently acquired first
+    _Entries _entries;
+
+    std::unordered_map<boost::filesystem::path, _Entries::iterator,
+                       _PathHash> _entryIts;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_FILE_HANDLE_POOL_HPP
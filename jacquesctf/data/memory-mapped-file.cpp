@@ -20,22 +20,9 @@ namespace jacques {
 
 namespace bfs = boost::filesystem;
 
-MemoryMappedFile::MemoryMappedFile(const bfs::path& path,
-                                   const boost::optional<int>& fd) :
+MemoryMappedFile::MemoryMappedFile(const bfs::path& path) :
     _path {path}
 {
-    if (fd) {
-        _fd = *fd;
-    } else {
-        _fd = open(path.string().c_str(), O_RDONLY);
-
-        if (_fd < 0) {
-            throw IOError {path, "Cannot open file."};
-        }
-
-        _closeFd = true;
-    }
-
     _fileSize = DataSize::fromBytes(bfs::file_size(path));
     _mmapOffsetGranularityBytes = sysconf(_SC_PAGE_SIZE);
     assert(_mmapOffsetGranularityBytes >= 1);
@@ -43,9 +30,7 @@ MemoryMappedFile::MemoryMappedFile(const bfs::path& path,
 
 MemoryMappedFile::~MemoryMappedFile()
 {
-    if (_fd >= 0 && _closeFd) {
-        (void) close(_fd);
-    }
+    this->_unmap();
 }
 
 void MemoryMappedFile::_unmap()
@@ -75,10 +60,20 @@ void MemoryMappedFile::map(const Index offsetBytes, const DataSize& size)
         return;
     }
 
+    const auto fd = open(_path.string().c_str(), O_RDONLY);
+
+    if (fd < 0) {
+        _mmapSize = 0;
+        throw IOError {_path, "Cannot open file."};
+    }
+
     _mmapAddr = mmap(NULL, static_cast<size_t>(_mmapSize.bytes()),
-                     PROT_READ, MAP_PRIVATE, _fd,
+                     PROT_READ, MAP_PRIVATE, fd,
                      static_cast<off_t>(mmapOffsetBytes));
 
+    // the mapping doesn't need the file descriptor anymore
+    (void) close(fd);
+
     if (_mmapAddr == MAP_FAILED) {
         std::ostringstream ss;
 
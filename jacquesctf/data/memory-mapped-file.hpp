@@ -11,7 +11,6 @@
 #include <string>
 #include <cstdlib>
 #include <boost/core/noncopyable.hpp>
-#include <boost/optional.hpp>
 #include <boost/filesystem.hpp>
 #include <sys/mman.h>
 
@@ -20,12 +19,18 @@
 
 namespace jacques {
 
+/*
+ * Memory-mapped region of a file.
+ *
+ * The file is only open during map(): a mapping remains valid once its
+ * file descriptor is closed, so that this object doesn't keep any file
+ * descriptor open.
+ */
 class MemoryMappedFile :
     boost::noncopyable
 {
 public:
-    explicit MemoryMappedFile(const boost::filesystem::path& path,
-                              const boost::optional<int>& fd = boost::none);
+    explicit MemoryMappedFile(const boost::filesystem::path& path);
     ~MemoryMappedFile();
 
 public:
@@ -72,8 +77,6 @@ private:
     void *_mmapAddr = nullptr;
     DataSize _mmapSize = 0;
     int _mmapAdvice = MADV_NORMAL;
-    int _fd = -1;
-    bool _closeFd = false;
     DataSize _fileSize;
     Index _mmapOffsetGranularityBytes;
     void *_mapAddr = nullptr;
@@ -5,6 +5,7 @@
  * prohibited. Proprietary and confidential.
  */
 
+#include <cassert>
 #include <memory>
 #include <fstream>
 #include <numeric>
@@ -17,6 +18,8 @@
 #include <yactfr/metadata/dynamic-array-type.hpp>
 #include <yactfr/metadata/static-array-type.hpp>
 #include <yactfr/metadata/struct-type.hpp>
+#include <yactfr/metadata/data-stream-type.hpp>
+#include <yactfr/metadata/event-record-type.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/optional.hpp>
 
@@ -26,7 +29,7 @@ namespace jacques {
 
 namespace bfs = boost::filesystem;
 
-Metadata::Metadata(const bfs::path& path) :
+Metadata::Metadata(const bfs::path& path, TextCache * const textCache) :
     _path {path}
 {
     try {
@@ -43,10 +46,7 @@ Metadata::Metadata(const bfs::path& path) :
         }
 
         _text = stream->text();
-        _traceType = yactfr::traceTypeFromMetadataText(std::begin(_text),
-                                                       std::end(_text));
-        this->_setDataTypeParents();
-        this->_setIsCorrelatable();
+        this->_setTextInfo(textCache);
     } catch (const yactfr::InvalidMetadataStream& ex) {
         throw MetadataError<yactfr::InvalidMetadataStream> {path, ex};
     } catch (const yactfr::InvalidMetadata& ex) {
@@ -56,9 +56,62 @@ Metadata::Metadata(const bfs::path& path) :
     }
 }
 
-void Metadata::_setIsCorrelatable()
+void Metadata::_setTextInfo(TextCache * const textCache)
 {
-    if (_traceType->clockTypes().empty()) {
+    if (!textCache) {
+        _textInfo = Metadata::_createTextInfo(_text);
+        return;
+    }
+
+    std::promise<std::shared_ptr<const _TextInfo>> promise;
+    TextCache::_TextInfoFuture future;
+
+    {
+        std::lock_guard<std::mutex> lock {textCache->_mutex};
+        auto it = textCache->_textInfos.find(_text);
+
+        if (it != std::end(textCache->_textInfos)) {
+            future = it->second;
+        } else {
+            textCache->_textInfos[_text] = promise.get_future().share();
+        }
+    }
+
+    if (future.valid()) {
+        /*
+         * Another metadata object has this text: wait for its text
+         * info (or rethrow its parsing error, which our constructor
+         * converts to a metadata error with our own path).
+         */
+        _textInfo = future.get();
+        return;
+    }
+
+    try {
+        _textInfo = Metadata::_createTextInfo(_text);
+        promise.set_value(_textInfo);
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+std::shared_ptr<const Metadata::_TextInfo> Metadata::_createTextInfo(const std::string& text)
+{
+    auto textInfo = std::make_shared<_TextInfo>();
+
+    textInfo->traceType = yactfr::traceTypeFromMetadataText(std::begin(text),
+                                                            std::end(text));
+    Metadata::_setDataTypeParents(*textInfo);
+    Metadata::_setIsCorrelatable(*textInfo);
+    Metadata::_setStaticSizes(*textInfo);
+    Metadata::_setCyclesToNsConverters(*textInfo);
+    return textInfo;
+}
+
+void Metadata::_setIsCorrelatable(_TextInfo& textInfo)
+{
+    if (textInfo.traceType->clockTypes().empty()) {
         return;
     }
 
@@ -66,7 +119,7 @@ void Metadata::_setIsCorrelatable()
     bool hasNonAbsolute = false;
     const boost::uuids::uuid *uuid = nullptr;
 
-    for (auto& clockType : _traceType->clockTypes()) {
+    for (auto& clockType : textInfo.traceType->clockTypes()) {
         if (clockType->isAbsolute()) {
             hasAbsolute = true;
         } else {
@@ -92,7 +145,140 @@ void Metadata::_setIsCorrelatable()
         return;
     }
 
-    _isCorrelatable = true;
+    textInfo.isCorrelatable = true;
+}
+
+void Metadata::_setCyclesToNsConverters(_TextInfo& textInfo)
+{
+    for (auto& clockType : textInfo.traceType->clockTypes()) {
+        textInfo.cyclesToNsConverters.emplace(clockType.get(),
+                                              CyclesToNsConverter {*clockType});
+    }
+}
+
+/*
+ * Advances `offsetBits` from the beginning to the end of a field having
+ * the data type `dataType`, updating `alignment` to the largest
+ * alignment found.
+ *
+ * Returns false if a field having the data type `dataType` has no
+ * static size.
+ */
+static bool advanceStaticSize(const yactfr::DataType& dataType,
+                              Index& offsetBits, Size& alignment)
+{
+    const Size dtAlignment = dataType.alignment();
+
+    alignment = std::max(alignment, dtAlignment);
+    offsetBits = (offsetBits + dtAlignment - 1) / dtAlignment * dtAlignment;
+
+    if (dataType.isBitArrayType()) {
+        offsetBits += dataType.asBitArrayType()->size();
+        return true;
+    } else if (dataType.isStructType()) {
+        for (auto& field : *dataType.asStructType()) {
+            if (!advanceStaticSize(field->type(), offsetBits, alignment)) {
+                return false;
+            }
+        }
+
+        return true;
+    } else if (dataType.isStaticArrayType()) {
+        const auto& arrayType = *dataType.asStaticArrayType();
+
+        for (Index i = 0; i < arrayType.length(); ++i) {
+            if (!advanceStaticSize(arrayType.elemType(), offsetBits,
+                                   alignment)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // string, dynamic array, or variant
+    return false;
+}
+
+static bool advanceStaticSize(const yactfr::DataType * const dataType,
+                              Index& offsetBits, Size& alignment)
+{
+    if (!dataType) {
+        return true;
+    }
+
+    return advanceStaticSize(*dataType, offsetBits, alignment);
+}
+
+void Metadata::_setStaticSizes(_TextInfo& textInfo)
+{
+    for (auto& dst : textInfo.traceType->dataStreamTypes()) {
+        if (dst->eventRecordTypes().empty()) {
+            continue;
+        }
+
+        // second context and payload of each event record type
+        for (auto& ert : dst->eventRecordTypes()) {
+            Index layoutSizeBits = 0;
+            Size layoutAlignment = 1;
+
+            if ((ert->secondContextType() || ert->payloadType()) &&
+                    advanceStaticSize(ert->secondContextType(),
+                                      layoutSizeBits, layoutAlignment) &&
+                    advanceStaticSize(ert->payloadType(), layoutSizeBits,
+                                      layoutAlignment)) {
+                textInfo.ertStaticLayoutAlignments[ert.get()] = layoutAlignment;
+            }
+        }
+
+        // event record header and first context (common part)
+        Index commonSizeBits = 0;
+        Size commonAlignment = 1;
+
+        if (!advanceStaticSize(dst->eventRecordHeaderType(), commonSizeBits,
+                               commonAlignment) ||
+                !advanceStaticSize(dst->eventRecordFirstContextType(),
+                                   commonSizeBits, commonAlignment)) {
+            continue;
+        }
+
+        /*
+         * Whole event records: the sizes assume that the event record
+         * starts at an offset which is a multiple of the largest
+         * alignment of any data type of the data stream type's event
+         * records.
+         */
+        boost::optional<Index> sizeBits;
+        Size alignment = commonAlignment;
+        bool isStatic = true;
+
+        for (auto& ert : dst->eventRecordTypes()) {
+            Index ertSizeBits = commonSizeBits;
+
+            if (!advanceStaticSize(ert->secondContextType(), ertSizeBits,
+                                   alignment) ||
+                    !advanceStaticSize(ert->payloadType(), ertSizeBits,
+                                       alignment) ||
+                    (sizeBits && ertSizeBits != *sizeBits)) {
+                isStatic = false;
+                break;
+            }
+
+            sizeBits = ertSizeBits;
+        }
+
+        /*
+         * If the size is not a multiple of the alignment, the padding
+         * before an event record depends on its index.
+         */
+        if (!isStatic || *sizeBits == 0 || *sizeBits % alignment != 0) {
+            continue;
+        }
+
+        textInfo.dstStaticEventRecordSizes[dst.get()] = {
+            DataSize {*sizeBits}, alignment
+        };
+    }
 }
 
 class SetDataTypeParentsPathsVisitor :
@@ -273,32 +459,33 @@ static void setScopeDataTypeParents(SetDataTypeParentsPathsVisitor& visitor,
     dataType->accept(visitor);
 }
 
-void Metadata::_setDataTypeParents()
+void Metadata::_setDataTypeParents(_TextInfo& textInfo)
 {
-    SetDataTypeParentsPathsVisitor visitor {_dataTypeParents,
-                                            _dataTypePaths};
+    auto& dataTypeScopes = textInfo.dataTypeScopes;
+    SetDataTypeParentsPathsVisitor visitor {textInfo.dataTypeParents,
+                                            textInfo.dataTypePaths};
 
     visitor.scope(yactfr::Scope::PACKET_HEADER);
-    setScopeDataTypeParents(visitor, _dataTypeScopes,
-                            _traceType->packetHeaderType());
+    setScopeDataTypeParents(visitor, dataTypeScopes,
+                            textInfo.traceType->packetHeaderType());
 
-    for (auto& dst : _traceType->dataStreamTypes()) {
+    for (auto& dst : textInfo.traceType->dataStreamTypes()) {
         visitor.scope(yactfr::Scope::PACKET_CONTEXT);
-        setScopeDataTypeParents(visitor, _dataTypeScopes,
+        setScopeDataTypeParents(visitor, dataTypeScopes,
                                 dst->packetContextType());
         visitor.scope(yactfr::Scope::EVENT_RECORD_HEADER);
-        setScopeDataTypeParents(visitor, _dataTypeScopes,
+        setScopeDataTypeParents(visitor, dataTypeScopes,
                                 dst->eventRecordHeaderType());
         visitor.scope(yactfr::Scope::EVENT_RECORD_FIRST_CONTEXT);
-        setScopeDataTypeParents(visitor, _dataTypeScopes,
+        setScopeDataTypeParents(visitor, dataTypeScopes,
                                 dst->eventRecordFirstContextType());
 
         for (auto& ert : dst->eventRecordTypes()) {
             visitor.scope(yactfr::Scope::EVENT_RECORD_SECOND_CONTEXT);
-            setScopeDataTypeParents(visitor, _dataTypeScopes,
+            setScopeDataTypeParents(visitor, dataTypeScopes,
                                     ert->secondContextType());
             visitor.scope(yactfr::Scope::EVENT_RECORD_PAYLOAD);
-            setScopeDataTypeParents(visitor, _dataTypeScopes,
+            setScopeDataTypeParents(visitor, dataTypeScopes,
                                     ert->payloadType());
         }
     }
@@ -312,27 +499,27 @@ void Metadata::_setDataTypeParents()
                                0ULL, accFunc) +
                dtPathMapPair.second.path.size() + 4;
     };
-    const auto maxDtPathIt = std::max_element(std::begin(_dataTypePaths),
-                                              std::end(_dataTypePaths),
+    const auto maxDtPathIt = std::max_element(std::begin(textInfo.dataTypePaths),
+                                              std::end(textInfo.dataTypePaths),
                                               [totalSizeFunc](const auto& pairA,
                                                               const auto& pairB) {
         return totalSizeFunc(pairA) < totalSizeFunc(pairB);
     });
 
-    _maxDataTypePathSize = maxDtPathIt == std::end(_dataTypePaths) ?
-                                          0 : totalSizeFunc(*maxDtPathIt);
+    textInfo.maxDataTypePathSize = maxDtPathIt == std::end(textInfo.dataTypePaths) ?
+                                   0 : totalSizeFunc(*maxDtPathIt);
 }
 
 const Metadata::DataTypePath& Metadata::dataTypePath(const yactfr::DataType& dataType) const
 {
-    return _dataTypePaths.find(&dataType)->second;
+    return _textInfo->dataTypePaths.find(&dataType)->second;
 }
 
 const yactfr::DataType *Metadata::dataTypeParent(const yactfr::DataType& dataType) const
 {
-    auto it = _dataTypeParents.find(&dataType);
+    auto it = _textInfo->dataTypeParents.find(&dataType);
 
-    if (it == std::end(_dataTypeParents)) {
+    if (it == std::end(_textInfo->dataTypeParents)) {
         return nullptr;
     }
 
@@ -348,20 +535,50 @@ yactfr::Scope Metadata::dataTypeScope(const yactfr::DataType& dataType) const
         assert(curDataType);
     }
 
-    return _dataTypeScopes.find(curDataType)->second;
+    return _textInfo->dataTypeScopes.find(curDataType)->second;
 }
 
 bool Metadata::dataTypeIsScopeRoot(const yactfr::DataType& dataType) const
 {
-    auto it = _dataTypeScopes.find(&dataType);
+    auto it = _textInfo->dataTypeScopes.find(&dataType);
 
-    if (it == std::end(_dataTypeScopes)) {
+    if (it == std::end(_textInfo->dataTypeScopes)) {
         return false;
     }
 
     return true;
 }
 
+const Metadata::StaticEventRecordSize *Metadata::dataStreamTypeStaticEventRecordSize(const yactfr::DataStreamType& dst) const
+{
+    const auto it = _textInfo->dstStaticEventRecordSizes.find(&dst);
+
+    if (it == std::end(_textInfo->dstStaticEventRecordSizes)) {
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+boost::optional<Size> Metadata::eventRecordTypeStaticLayoutAlignment(const yactfr::EventRecordType& ert) const
+{
+    const auto it = _textInfo->ertStaticLayoutAlignments.find(&ert);
+
+    if (it == std::end(_textInfo->ertStaticLayoutAlignments)) {
+        return boost::none;
+    }
+
+    return it->second;
+}
+
+const CyclesToNsConverter& Metadata::cyclesToNsConverter(const yactfr::ClockType& clockType) const
+{
+    const auto it = _textInfo->cyclesToNsConverters.find(&clockType);
+
+    assert(it != std::end(_textInfo->cyclesToNsConverters));
+    return it->second;
+}
+
 DataSize Metadata::fileSize() const noexcept
 {
     return DataSize::fromBytes(bfs::file_size(_path));
@@ -9,6 +9,8 @@
 #define _JACQUES_METADATA_HPP
 
 #include <memory>
+#include <mutex>
+#include <future>
 #include <unordered_map>
 #include <yactfr/metadata/metadata-stream.hpp>
 #include <yactfr/metadata/fwd.hpp>
@@ -22,6 +24,7 @@
 
 #include "aliases.hpp"
 #include "data-size.hpp"
+#include "cycles-to-ns-converter.hpp"
 
 namespace jacques {
 
@@ -70,15 +73,82 @@ public:
     using DataTypePathMap = std::unordered_map<const yactfr::DataType *,
                                                DataTypePath>;
 
+    /*
+     * Size of each event record of a data stream type of which all the
+     * event records have the same static size (see
+     * dataStreamTypeStaticEventRecordSize()).
+     */
+    struct StaticEventRecordSize
+    {
+        DataSize size;
+
+        /*
+         * The event records only have this size if the first one
+         * starts at an offset which is a multiple of this alignment
+         * (bits).
+         */
+        Size alignment;
+    };
+
+private:
+    /*
+     * Everything which only depends on the metadata text. Metadata
+     * objects built from identical texts can share a single instance.
+     */
+    struct _TextInfo
+    {
+        yactfr::TraceType::SP traceType;
+        DataTypeParentMap dataTypeParents;
+        DataTypeScopeMap dataTypeScopes;
+        DataTypePathMap dataTypePaths;
+        Size maxDataTypePathSize = 0;
+        bool isCorrelatable = false;
+        std::unordered_map<const yactfr::DataStreamType *,
+                           StaticEventRecordSize> dstStaticEventRecordSizes;
+        std::unordered_map<const yactfr::EventRecordType *,
+                           Size> ertStaticLayoutAlignments;
+        std::unordered_map<const yactfr::ClockType *,
+                           CyclesToNsConverter> cyclesToNsConverters;
+    };
+
+public:
+    /*
+     * Thread-safe cache of parsed metadata texts.
+     *
+     * Pass the same cache to many metadata constructors (possibly
+     * called concurrently) to parse each distinct metadata text only
+     * once: a constructor which finds a text which another thread is
+     * currently parsing waits for this result instead of parsing it
+     * again.
+     */
+    class TextCache :
+        boost::noncopyable
+    {
+        friend class Metadata;
+
+    private:
+        using _TextInfoFuture = std::shared_future<std::shared_ptr<const _TextInfo>>;
+
+    private:
+        std::mutex _mutex;
+        std::unordered_map<std::string, _TextInfoFuture> _textInfos;
+    };
+
 public:
-    explicit Metadata(const boost::filesystem::path& path);
+    explicit Metadata(const boost::filesystem::path& path,
+                      TextCache *textCache = nullptr);
     const yactfr::DataType *dataTypeParent(const yactfr::DataType& dataType) const;
     yactfr::Scope dataTypeScope(const yactfr::DataType& dataType) const;
     const DataTypePath& dataTypePath(const yactfr::DataType& dataType) const;
 
+    const DataTypePathMap& dataTypePaths() const noexcept
+    {
+        return _textInfo->dataTypePaths;
+    }
+
     Size maxDataTypePathSize() const noexcept
     {
-        return _maxDataTypePathSize;
+        return _textInfo->maxDataTypePathSize;
     }
 
     bool dataTypeIsScopeRoot(const yactfr::DataType& dataType) const;
@@ -121,18 +191,52 @@ public:
 
     yactfr::TraceType::SP traceType() const noexcept
     {
-        return _traceType;
+        return _textInfo->traceType;
     }
 
     // true if all clock types are absolute or have the same UUID
     bool isCorrelatable() const noexcept
     {
-        return _isCorrelatable;
+        return _textInfo->isCorrelatable;
     }
 
+    /*
+     * Returns the static size which all the event records of the data
+     * stream type `dst` have, or `nullptr` if they don't all have the
+     * same static size (an event record type contains a string, a
+     * dynamic array, or a variant, for example).
+     *
+     * With such a size, the offset of an event record within a packet
+     * only depends on its index: a packet has no padding between its
+     * event records.
+     */
+    const StaticEventRecordSize *dataStreamTypeStaticEventRecordSize(const yactfr::DataStreamType& dst) const;
+
+    /*
+     * Returns the largest alignment (bits) of the data types of the
+     * second context and payload of the event record type `ert` if
+     * they have a static size, or `boost::none` if they don't (or if
+     * `ert` has no second context and no payload).
+     *
+     * The layout (packet regions and scopes) of the second context and
+     * payload of such an event record then only depends on their
+     * offset modulo this alignment.
+     */
+    boost::optional<Size> eventRecordTypeStaticLayoutAlignment(const yactfr::EventRecordType& ert) const;
+
+    /*
+     * Returns the precomputed converter of values of the clock type
+     * `clockType` to nanoseconds from origin.
+     */
+    const CyclesToNsConverter& cyclesToNsConverter(const yactfr::ClockType& clockType) const;
+
 private:
-    void _setDataTypeParents();
-    void _setIsCorrelatable();
+    static std::shared_ptr<const _TextInfo> _createTextInfo(const std::string& text);
+    static void _setDataTypeParents(_TextInfo& textInfo);
+    static void _setIsCorrelatable(_TextInfo& textInfo);
+    static void _setStaticSizes(_TextInfo& textInfo);
+    static void _setCyclesToNsConverters(_TextInfo& textInfo);
+    void _setTextInfo(TextCache *textCache);
 
 private:
     const boost::filesystem::path _path;
@@ -146,12 +250,7 @@ private:
         boost::optional<boost::uuids::uuid> uuid;
     } _stream;
 
-    yactfr::TraceType::SP _traceType;
-    DataTypeParentMap _dataTypeParents;
-    DataTypeScopeMap _dataTypeScopes;
-    DataTypePathMap _dataTypePaths;
-    Size _maxDataTypePathSize = 0;
-    bool _isCorrelatable = false;
+    std::shared_ptr<const _TextInfo> _textInfo;
 };
 
 } // namespace jacques
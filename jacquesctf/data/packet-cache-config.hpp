@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_PACKET_CACHE_CONFIG_HPP
+#define _JACQUES_PACKET_CACHE_CONFIG_HPP
+
+#include "aliases.hpp"
+
+namespace jacques {
+
+/*
+ * Event record and packet region caching parameters of a packet (see
+ * `Packet`).
+ */
+struct PacketCacheConfig
+{
+    // maximum number of windows, including the current one (at least 1)
+    Size windowCount = 6;
+
+    // maximum number of event records in a window (at least 4)
+    Size windowEventRecordCount = 500;
+
+    // maximum total number of packet regions in all the windows
+    Size maxRegionCount = 250000;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_PACKET_CACHE_CONFIG_HPP
@@ -9,6 +9,7 @@
 #include <algorithm>
 
 #include "packet-checkpoints.hpp"
+#include "profiler.hpp"
 
 namespace jacques {
 
@@ -35,6 +36,7 @@ void PacketCheckpoints::_tryCreateCheckpoints(yactfr::ElementSequence& seq,
                                               const Size step,
                                               PacketCheckpointsBuildListener& packetCheckpointsBuildListener)
 {
+    const profiler::Span span {"PacketCheckpoints::_tryCreateCheckpoints"};
     auto it = seq.at(packetIndexEntry.offsetInDataStreamFileBytes());
 
     // we consider other errors (e.g., I/O) unrecoverable: do not catch them
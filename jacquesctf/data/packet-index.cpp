@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <algorithm>
+
+#include "packet-index.hpp"
+
+namespace jacques {
+
+void PacketIndex::append(PacketIndexEntry entry)
+{
+    assert(!_isFinished);
+    assert(entry.indexInDataStreamFile() == _entries.size());
+
+    // contiguous packets (see effectiveTotalSizeFrom())
+    assert(_entries.empty() ||
+           entry.offsetInDataStreamFileBytes() == _entries.back().endOffsetInDataStreamFileBytes());
+
+    const auto& effectiveTotalSize = entry.effectiveTotalSize();
+    const auto& beginTs = entry.beginningTimestamp();
+    const auto& endTs = entry.endTimestamp();
+
+    _endOffsetsBits.push_back(entry.offsetInDataStreamFileBits() +
+                              effectiveTotalSize.bits());
+    _totalEffectiveTotalSize += effectiveTotalSize;
+    _totalEffectiveContentSize += entry.effectiveContentSize();
+
+    if (entry.expectedTotalSize()) {
+        _totalExpectedTotalSize += *entry.expectedTotalSize();
+    }
+
+    if (entry.expectedContentSize()) {
+        _totalExpectedContentSize += *entry.expectedContentSize();
+    }
+
+    _maxEffectiveTotalSize = std::max(_maxEffectiveTotalSize,
+                                      effectiveTotalSize);
+
+    if (beginTs && (!_firstTs || *beginTs < *_firstTs)) {
+        _firstTs = *beginTs;
+    }
+
+    if (endTs && (!_lastTs || *endTs > *_lastTs)) {
+        _lastTs = *endTs;
+    }
+
+    _entries.push_back(std::move(entry));
+}
+
+template <typename ValueT, typename FuncT>
+void PacketIndex::_buildSortedColumn(_SortedColumn<ValueT>& column,
+                                     FuncT&& func)
+{
+    for (const auto& entry : _entries) {
+        const auto value = func(entry);
+
+        if (value) {
+            column.emplace_back(*value, entry.indexInDataStreamFile());
+        }
+    }
+
+    /*
+     * Packets are usually already sorted, but nothing requires it.
+     * Comparing the pairs keeps the data stream file order of packets
+     * having the same value.
+     */
+    std::sort(std::begin(column), std::end(column));
+    column.shrink_to_fit();
+}
+
+void PacketIndex::finish()
+{
+    if (_isFinished) {
+        return;
+    }
+
+    this->_buildSortedColumn(_sortedBeginCycles, [](const auto& entry) {
+        boost::optional<unsigned long long> value;
+
+        if (entry.beginningTimestamp() && entry.endTimestamp()) {
+            value = entry.beginningTimestamp()->cycles();
+        }
+
+        return value;
+    });
+    this->_buildSortedColumn(_sortedBeginNs, [](const auto& entry) {
+        boost::optional<long long> value;
+
+        if (entry.beginningTimestamp() && entry.endTimestamp()) {
+            value = entry.beginningTimestamp()->nsFromOrigin();
+        }
+
+        return value;
+    });
+    this->_buildSortedColumn(_sortedSeqNums, [](const auto& entry) {
+        return entry.seqNum();
+    });
+    _isFinished = true;
+}
+
+Index PacketIndex::indexContainingOffsetBits(const Index offsetBits) const
+{
+    assert(offsetBits < this->endOffsetInDataStreamFileBits());
+
+    const auto it = std::upper_bound(std::begin(_endOffsetsBits),
+                                     std::end(_endOffsetsBits), offsetBits);
+
+    assert(it != std::end(_endOffsetsBits));
+
+    const Index index = it - std::begin(_endOffsetsBits);
+
+    assert(offsetBits >= _entries[index].offsetInDataStreamFileBits());
+    return index;
+}
+
+const PacketIndexEntry *PacketIndex::entryWithSeqNum(const Index seqNum) const
+{
+    assert(_isFinished);
+
+    // first entry having this sequence number
+    const auto it = std::lower_bound(std::begin(_sortedSeqNums),
+                                     std::end(_sortedSeqNums),
+                                     std::make_pair(seqNum, Index {0}));
+
+    if (it == std::end(_sortedSeqNums) || it->first != seqNum) {
+        return nullptr;
+    }
+
+    return &_entries[it->second];
+}
+
+const PacketIndexEntry *PacketIndex::entryContainingNsFromOrigin(const long long nsFromOrigin) const
+{
+    return this->_entryContainingValue(_sortedBeginNs, nsFromOrigin,
+                                       [](const auto& entry) {
+        return entry.endTimestamp()->nsFromOrigin();
+    });
+}
+
+const PacketIndexEntry *PacketIndex::entryContainingCycles(const unsigned long long cycles) const
+{
+    return this->_entryContainingValue(_sortedBeginCycles, cycles,
+                                       [](const auto& entry) {
+        return entry.endTimestamp()->cycles();
+    });
+}
+
+} // namespace jacques
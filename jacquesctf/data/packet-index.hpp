@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_PACKET_INDEX_HPP
+#define _JACQUES_PACKET_INDEX_HPP
+
+#include <cassert>
+#include <algorithm>
+#include <vector>
+#include <utility>
+#include <boost/optional.hpp>
+#include <boost/core/noncopyable.hpp>
+
+#include "aliases.hpp"
+#include "packet-index-entry.hpp"
+#include "data-size.hpp"
+#include "timestamp.hpp"
+
+namespace jacques {
+
+/*
+ * Packet index of a data stream file.
+ *
+ * A packet index contains the packet index entries, which other objects
+ * refer to, as well as compact columns of the only values which lookups
+ * scan, so that a binary search doesn't touch the (large) entries:
+ *
+ * * End offsets.
+ *
+ * * Beginning timestamps (cycles and nanoseconds from origin) of the
+ *   entries having both timestamps, sorted, with their entry indexes.
+ *   This doesn't assume that the packets are sorted by time.
+ *
+ * * Sequence numbers, sorted, with their entry indexes. This doesn't
+ *   assume that sequence numbers are sorted.
+ *
+ * A lookup only reads the entry it finds (for example, to check its
+ * end timestamp). Packets are contiguous, so that the total size of
+ * packets is a difference of offsets, not a column.
+ *
+ * The index also keeps per-file aggregates (total sizes, maximum packet
+ * size, first and last timestamps), so that a view doesn't need to
+ * visit all the entries to show them.
+ *
+ * Call append() to add the entries in data stream file order, and then
+ * finish() once before any lookup.
+ */
+class PacketIndex :
+    boost::noncopyable
+{
+public:
+    using Entries = std::vector<PacketIndexEntry>;
+
+public:
+    PacketIndex() = default;
+
+    void append(PacketIndexEntry entry);
+    void finish();
+
+    Size size() const noexcept
+    {
+        return _entries.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return _entries.empty();
+    }
+
+    const PacketIndexEntry& operator[](const Index index) const
+    {
+        assert(index < _entries.size());
+        return _entries[index];
+    }
+
+    PacketIndexEntry& operator[](const Index index)
+    {
+        assert(index < _entries.size());
+        return _entries[index];
+    }
+
+    const PacketIndexEntry& back() const
+    {
+        assert(!_entries.empty());
+        return _entries.back();
+    }
+
+    const Entries& entries() const noexcept
+    {
+        return _entries;
+    }
+
+    Entries& entries() noexcept
+    {
+        return _entries;
+    }
+
+    // end offset (bits) of the last packet, or 0 if empty
+    Index endOffsetInDataStreamFileBits() const noexcept
+    {
+        return _endOffsetsBits.empty() ? 0 : _endOffsetsBits.back();
+    }
+
+    // index of the entry containing `offsetBits` (must exist)
+    Index indexContainingOffsetBits(Index offsetBits) const;
+
+    const PacketIndexEntry *entryWithSeqNum(Index seqNum) const;
+    const PacketIndexEntry *entryContainingNsFromOrigin(long long nsFromOrigin) const;
+    const PacketIndexEntry *entryContainingCycles(unsigned long long cycles) const;
+
+    // total effective size of the packets from index `index`
+    DataSize effectiveTotalSizeFrom(const Index index) const noexcept
+    {
+        assert(_isFinished);
+
+        if (index >= _entries.size()) {
+            return 0;
+        }
+
+        // each packet begins where the previous one ends
+        return DataSize::fromBytes(_entries.back().endOffsetInDataStreamFileBytes() -
+                                   _entries[index].offsetInDataStreamFileBytes());
+    }
+
+    const DataSize& totalEffectiveTotalSize() const noexcept
+    {
+        return _totalEffectiveTotalSize;
+    }
+
+    const DataSize& totalEffectiveContentSize() const noexcept
+    {
+        return _totalEffectiveContentSize;
+    }
+
+    const DataSize& totalExpectedTotalSize() const noexcept
+    {
+        return _totalExpectedTotalSize;
+    }
+
+    const DataSize& totalExpectedContentSize() const noexcept
+    {
+        return _totalExpectedContentSize;
+    }
+
+    const DataSize& maxEffectiveTotalSize() const noexcept
+    {
+        return _maxEffectiveTotalSize;
+    }
+
+    // earliest beginning timestamp of all the packets
+    const boost::optional<Timestamp>& firstTimestamp() const noexcept
+    {
+        return _firstTs;
+    }
+
+    // latest end timestamp of all the packets
+    const boost::optional<Timestamp>& lastTimestamp() const noexcept
+    {
+        return _lastTs;
+    }
+
+private:
+    // sorted values with their entry indexes
+    template <typename ValueT>
+    using _SortedColumn = std::vector<std::pair<ValueT, Index>>;
+
+private:
+    template <typename ValueT, typename FuncT>
+    void _buildSortedColumn(_SortedColumn<ValueT>& column, FuncT&& func);
+
+    /*
+     * Returns the entry of which the beginning value (sorted within
+     * `begins`) and the end value (`endFunc(entry)`) contain `value`.
+     */
+    template <typename ValueT, typename EndFuncT>
+    const PacketIndexEntry *_entryContainingValue(const _SortedColumn<ValueT>& begins,
+                                                  const ValueT value,
+                                                  EndFuncT&& endFunc) const
+    {
+        assert(_isFinished);
+
+        // last entry of which the beginning value is less than or equal to `value`
+        auto it = std::upper_bound(std::begin(begins), std::end(begins),
+                                   value,
+                                   [](const ValueT value,
+                                      const std::pair<ValueT, Index>& pair) {
+            return value < pair.first;
+        });
+
+        if (it == std::begin(begins)) {
+            return nullptr;
+        }
+
+        --it;
+
+        const auto& entry = _entries[it->second];
+
+        if (value >= endFunc(entry)) {
+            return nullptr;
+        }
+
+        return &entry;
+    }
+
+private:
+    Entries _entries;
+
+    // columns
+    std::vector<Index> _endOffsetsBits;
+    _SortedColumn<unsigned long long> _sortedBeginCycles;
+    _SortedColumn<long long> _sortedBeginNs;
+    _SortedColumn<Index> _sortedSeqNums;
+
+    // aggregates
+    DataSize _totalEffectiveTotalSize = 0;
+    DataSize _totalEffectiveContentSize = 0;
+    DataSize _totalExpectedTotalSize = 0;
+    DataSize _totalExpectedContentSize = 0;
+    DataSize _maxEffectiveTotalSize = 0;
+    boost::optional<Timestamp> _firstTs;
+    boost::optional<Timestamp> _lastTs;
+
+    bool _isFinished = false;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_PACKET_INDEX_HPP
@@ -6,61 +6,88 @@
  */
 
 #include <algorithm>
+#include <array>
 #include <yactfr/metadata/string-type.hpp>
 #include <yactfr/metadata/struct-type.hpp>
 
 #include "packet.hpp"
 #include "content-packet-region.hpp"
+#include "array-packet-region.hpp"
 #include "padding-packet-region.hpp"
 #include "error-packet-region.hpp"
+#include "stats.hpp"
+#include "profiler.hpp"
 
 namespace jacques {
 
 Packet::Packet(const PacketIndexEntry& indexEntry,
-               yactfr::ElementSequence& seq, const Metadata& metadata,
-               yactfr::DataSource::UP dataSrc,
+               FileHandlesAcquirer acquireFileHandles,
+               const Metadata& metadata,
                std::unique_ptr<MemoryMappedFile> mmapFile,
-               PacketCheckpointsBuildListener& packetCheckpointsBuildListener) :
+               PacketCheckpointsBuildListener& packetCheckpointsBuildListener,
+               const PacketCacheConfig& cacheConfig) :
     _indexEntry {&indexEntry},
     _metadata {&metadata},
-    _dataSrc {std::move(dataSrc)},
+    _acquireFileHandles {std::move(acquireFileHandles)},
     _mmapFile {std::move(mmapFile)},
-    _it {std::begin(seq)},
-    _endIt {std::end(seq)},
+
+    // released by the first `_ItsGuard` (_cachePreambleRegions())
+    _its {std::make_unique<_Its>(_acquireFileHandles())},
+
     _checkpoints {
-        seq, metadata, *_indexEntry, 20011, packetCheckpointsBuildListener,
+        _its->fileHandles->seq(), metadata, *_indexEntry, 20011,
+        packetCheckpointsBuildListener,
     },
-    _lruRegionCache {2000},
+    _offsetRegionCache {2000},
+    _cacheConfig {cacheConfig},
     _preambleSize {
         indexEntry.preambleSize() ? *indexEntry.preambleSize() :
         indexEntry.effectiveContentSize()
     }
 {
+    assert(_cacheConfig.windowCount >= 1);
+    assert(_cacheConfig.windowEventRecordCount >= 4);
     _mmapFile->map(_indexEntry->offsetInDataStreamFileBytes(),
                    _indexEntry->effectiveTotalSize());
+    this->_trySetEventRecordStaticSize();
     this->_cachePreambleRegions();
 }
 
-void Packet::_ensureEventRecordIsCached(const Index indexInPacket)
+void Packet::_ensureEventRecordsAreCached(const Index indexInPacket,
+                                          const Index lastIndexInPacket)
 {
-    assert(indexInPacket < _checkpoints.eventRecordCount());
+    assert(indexInPacket <= lastIndexInPacket);
+    assert(lastIndexInPacket < _checkpoints.eventRecordCount());
+
+    const auto windowContainsErs = [indexInPacket, lastIndexInPacket,
+                                    this](const _EventRecordCache& cache) {
+        return this->_eventRecordIsCached(cache, indexInPacket) &&
+               this->_eventRecordIsCached(cache, lastIndexInPacket);
+    };
 
-    // current cache?
-    if (this->_eventRecordIsCached(_curEventRecordCache, indexInPacket)) {
+    // current window?
+    if (windowContainsErs(_curEventRecordCache)) {
+        stats::inc(stats::Counter::CUR_EVENT_RECORD_CACHE_HITS);
         return;
     }
 
-    // last cache?
-    if (this->_eventRecordIsCached(_lastEventRecordCache, indexInPacket)) {
-        // this is the current cache now
-        _curRegionCache = std::move(_lastRegionCache);
-        _curEventRecordCache = std::move(_lastEventRecordCache);
-        return;
+    // other window?
+    for (auto it = std::begin(_otherWindows); it != std::end(_otherWindows);
+            ++it) {
+        if (windowContainsErs(it->eventRecordCache)) {
+            this->_activateWindow(it);
+            stats::inc(stats::Counter::OTHER_WINDOW_EVENT_RECORD_CACHE_HITS);
+            return;
+        }
     }
 
-    const auto halfMaxCacheSize = _eventRecordCacheMaxSize / 2;
-    const auto toCacheIndexInPacket = indexInPacket < halfMaxCacheSize ? 0 :
-                                      indexInPacket - halfMaxCacheSize;
+    stats::inc(stats::Counter::EVENT_RECORD_CACHE_MISSES);
+
+    const auto toCacheIndexInPacket = this->_newWindowFirstEventRecordIndex(indexInPacket);
+
+    assert(toCacheIndexInPacket <= indexInPacket);
+    assert(toCacheIndexInPacket + _cacheConfig.windowEventRecordCount >
+           lastIndexInPacket);
 
     // find nearest event record checkpoint
     const auto cp = _checkpoints.nearestCheckpointBeforeOrAtIndex(toCacheIndexInPacket);
@@ -68,23 +95,116 @@ void Packet::_ensureEventRecordIsCached(const Index indexInPacket)
     assert(cp);
 
     auto curIndex = cp->first->indexInPacket();
+    Size decodedElemCount = 0;
+
+    const _ItsGuard itsGuard {*this};
 
-    _it.restorePosition(cp->second);
+    _its->it.restorePosition(cp->second);
+    stats::inc(stats::Counter::CHECKPOINTS_RESTORED);
 
     while (true) {
-        if (_it->kind() == yactfr::Element::Kind::EVENT_RECORD_BEGINNING) {
+        if (_its->it->kind() == yactfr::Element::Kind::EVENT_RECORD_BEGINNING) {
             if (curIndex == toCacheIndexInPacket) {
-                const auto count = std::min(_eventRecordCacheMaxSize,
+                const auto count = std::min(_cacheConfig.windowEventRecordCount,
                                             _checkpoints.eventRecordCount() - curIndex);
 
+                stats::inc(stats::Counter::SEEK_DECODED_ELEMENTS,
+                           decodedElemCount);
+                this->_deactivateCurWindow();
                 this->_cacheRegionsFromErsAtCurIt(curIndex, count);
+                this->_trimWindows();
                 return;
             }
 
             ++curIndex;
         }
 
-        ++_it;
+        ++_its->it;
+        ++decodedElemCount;
+    }
+}
+
+Index Packet::_newWindowFirstEventRecordIndex(const Index indexInPacket) const
+{
+    const auto windowSize = _cacheConfig.windowEventRecordCount;
+    const auto margin = std::max(windowSize / 8, 1ULL);
+
+    // reference window: current one, or last current one if it's the preamble
+    const _EventRecordCache *refCache = nullptr;
+
+    if (!_curEventRecordCache.empty()) {
+        refCache = &_curEventRecordCache;
+    } else if (!_otherWindows.empty()) {
+        refCache = &_otherWindows.front().eventRecordCache;
+    }
+
+    // jump: center the requested event record
+    Index firstIndex = indexInPacket - std::min(indexInPacket,
+                                                windowSize / 2);
+
+    if (refCache) {
+        const auto refFirstIndex = refCache->front()->indexInPacket();
+        const auto refLastIndex = refCache->back()->indexInPacket();
+
+        if (indexInPacket > refLastIndex &&
+                indexInPacket - refLastIndex <= windowSize) {
+            // scrolling forward: extend the new window after
+            firstIndex = indexInPacket - std::min(indexInPacket, margin);
+        } else if (indexInPacket < refFirstIndex &&
+                refFirstIndex - indexInPacket <= windowSize) {
+            // scrolling backward: extend the new window before
+            const auto endIndex = indexInPacket + margin + 1;
+
+            firstIndex = endIndex - std::min(endIndex, windowSize);
+        }
+    }
+
+    // fill the new window if there are enough event records after
+    const auto erCount = _checkpoints.eventRecordCount();
+
+    if (firstIndex + windowSize > erCount) {
+        firstIndex = erCount > windowSize ? erCount - windowSize : 0;
+    }
+
+    return firstIndex;
+}
+
+void Packet::_deactivateCurWindow()
+{
+    // the current window is a copy of the preamble region cache when empty
+    if (!_curEventRecordCache.empty()) {
+        _otherWindows.push_front({
+            std::move(_curRegionCache), std::move(_curEventRecordCache),
+        });
+    }
+
+    _curRegionCache.clear();
+    _curEventRecordCache.clear();
+}
+
+void Packet::_activateWindow(const std::list<_Window>::iterator it)
+{
+    auto window = std::move(*it);
+
+    _otherWindows.erase(it);
+    this->_deactivateCurWindow();
+    _curRegionCache = std::move(window.regionCache);
+    _curEventRecordCache = std::move(window.eventRecordCache);
+}
+
+void Packet::_trimWindows()
+{
+    Size regionCount = _curRegionCache.size();
+
+    for (const auto& window : _otherWindows) {
+        regionCount += window.regionCache.size();
+    }
+
+    while (!_otherWindows.empty() &&
+            (_otherWindows.size() + 1 > _cacheConfig.windowCount ||
+             regionCount > _cacheConfig.maxRegionCount)) {
+        regionCount -= _otherWindows.back().regionCache.size();
+        _otherWindows.pop_back();
     }
 }
 
@@ -93,6 +213,7 @@ void Packet::_ensureOffsetInPacketBitsIsCached(const Index offsetInPacketBits)
     // current region cache?
     if (this->_regionCacheContainsOffsetInPacketBits(_curRegionCache,
                                                      offsetInPacketBits)) {
+        stats::inc(stats::Counter::CUR_REGION_CACHE_HITS);
         return;
     }
 
@@ -100,24 +221,29 @@ void Packet::_ensureOffsetInPacketBitsIsCached(const Index offsetInPacketBits)
     if (this->_regionCacheContainsOffsetInPacketBits(_preambleRegionCache,
                                                      offsetInPacketBits)) {
         // this is the current cache now
-        _lastRegionCache = std::move(_curRegionCache);
-        _lastEventRecordCache = std::move(_curEventRecordCache);
+        this->_deactivateCurWindow();
         _curRegionCache = _preambleRegionCache;
-        _curEventRecordCache.clear();
+        stats::inc(stats::Counter::PREAMBLE_REGION_CACHE_HITS);
         return;
     }
 
-    // last region cache?
-    if (this->_regionCacheContainsOffsetInPacketBits(_lastRegionCache,
-                                                     offsetInPacketBits)) {
-        // this is the current cache now
-        _curRegionCache = std::move(_lastRegionCache);
-        _curEventRecordCache = std::move(_lastEventRecordCache);
-        return;
+    // other window?
+    for (auto it = std::begin(_otherWindows); it != std::end(_otherWindows);
+            ++it) {
+        if (this->_regionCacheContainsOffsetInPacketBits(it->regionCache,
+                                                         offsetInPacketBits)) {
+            this->_activateWindow(it);
+            stats::inc(stats::Counter::OTHER_WINDOW_REGION_CACHE_HITS);
+            return;
+        }
     }
 
+    stats::inc(stats::Counter::REGION_CACHE_MISSES);
     assert(_checkpoints.eventRecordCount() > 0);
 
+    // keep the same iterators for both steps below
+    const _ItsGuard itsGuard {*this};
+
     const auto& lastEventRecord = *_checkpoints.lastEventRecord();
 
     if (offsetInPacketBits >= lastEventRecord.segment().offsetInPacketBits()) {
@@ -126,18 +252,51 @@ void Packet::_ensureOffsetInPacketBitsIsCached(const Index offsetInPacketBits)
         return;
     }
 
+    const auto curIndex = this->_eventRecordIndexBeforeOrAtOffsetInPacketBits(offsetInPacketBits);
+
+    /*
+     * Now we have its index: cache event records around this one.
+     *
+     * `offsetInPacketBits` can be within a padding region between this
+     * event record and the following one. The padding region before an
+     * event record only exists in a window which also contains the
+     * previous event record, so make sure that the current window
+     * contains both event records.
+     */
+    const auto lastIndex = std::min(curIndex + 1,
+                                    _checkpoints.eventRecordCount() - 1);
+
+    this->_ensureEventRecordsAreCached(curIndex, lastIndex);
+}
+
+Index Packet::_eventRecordIndexBeforeOrAtOffsetInPacketBits(const Index offsetInPacketBits)
+{
+    if (_eventRecordStaticSize) {
+        // all the event records have the same size: no decoding needed
+        const auto firstErOffsetInPacketBits = _checkpoints.firstEventRecord()->segment().offsetInPacketBits();
+
+        assert(offsetInPacketBits >= firstErOffsetInPacketBits);
+        stats::inc(stats::Counter::STATIC_SIZE_SEEKS);
+        return (offsetInPacketBits - firstErOffsetInPacketBits) /
+               _eventRecordStaticSize->bits();
+    }
+
     // find nearest event record checkpoint by offset
     const auto cp = _checkpoints.nearestCheckpointBeforeOrAtOffsetInPacketBits(offsetInPacketBits);
 
     assert(cp);
 
     auto curIndex = cp->first->indexInPacket();
+    Size decodedElemCount = 0;
 
-    _it.restorePosition(cp->second);
+    const _ItsGuard itsGuard {*this};
+
+    _its->it.restorePosition(cp->second);
+    stats::inc(stats::Counter::CHECKPOINTS_RESTORED);
 
     // find closest event record before or containing offset
     while (true) {
-        if (_it->kind() == yactfr::Element::Kind::EVENT_RECORD_BEGINNING) {
+        if (_its->it->kind() == yactfr::Element::Kind::EVENT_RECORD_BEGINNING) {
             if (this->_itOffsetInPacketBits() == offsetInPacketBits) {
                 break;
             } else if (this->_itOffsetInPacketBits() > offsetInPacketBits) {
@@ -147,39 +306,48 @@ void Packet::_ensureOffsetInPacketBitsIsCached(const Index offsetInPacketBits)
                 break;
             }
 
-        } else if (_it->kind() == yactfr::Element::Kind::EVENT_RECORD_END) {
+        } else if (_its->it->kind() == yactfr::Element::Kind::EVENT_RECORD_END) {
             ++curIndex;
         }
 
-        ++_it;
+        ++_its->it;
+        ++decodedElemCount;
     }
 
-    // no we have its index: cache event records around this one
-    this->_ensureEventRecordIsCached(curIndex);
+    stats::inc(stats::Counter::SEEK_DECODED_ELEMENTS, decodedElemCount);
+    return curIndex;
+}
+
+void Packet::_trySetEventRecordStaticSize()
+{
+    const auto dst = _indexEntry->dataStreamType();
+
+    if (!dst || _checkpoints.eventRecordCount() == 0) {
+        return;
+    }
+
+    const auto staticSize = _metadata->dataStreamTypeStaticEventRecordSize(*dst);
+
+    if (!staticSize) {
+        return;
+    }
 
     /*
-     * This scenario can happen:
-     *
-     * 1. _ensureEventRecordIsCached() above did not do anything because
-     *    the event record at `curIndex` is already in cache.
-     * 2. The event record at `curIndex` is the event record cache's
-     *    last one.
-     * 3. `offsetInPacketBits` is a padding region between two event
-     *    records.
-     * 4. `offsetInPacketBits` is greater than or equal to the cache's
-     *    last event record's end offset.
-     *
-     * Just in case, make sure that the following event record is also
-     * in cache. If it was not, then the caches will be cleared and many
-     * event records will be cached around the one at `curIndex`,
-     * therefore the packet region cache will include the padding
-     * region.
+     * The event records only have this size if the first one starts at
+     * an aligned offset. Also make sure that the last (complete) event
+     * record is where this size says it is.
      */
-    ++curIndex;
+    const auto firstErOffsetInPacketBits = _checkpoints.firstEventRecord()->segment().offsetInPacketBits();
+    const auto& lastEr = *_checkpoints.lastEventRecord();
 
-    if (curIndex < _checkpoints.eventRecordCount()) {
-        this->_ensureEventRecordIsCached(curIndex);
+    if (firstErOffsetInPacketBits % staticSize->alignment != 0 ||
+            lastEr.segment().offsetInPacketBits() !=
+            firstErOffsetInPacketBits +
+            lastEr.indexInPacket() * staticSize->size.bits()) {
+        return;
     }
+
+    _eventRecordStaticSize = staticSize->size;
 }
 
 void Packet::_cacheContentRegionAtCurIt(Scope::SP scope)
@@ -188,7 +356,7 @@ void Packet::_cacheContentRegionAtCurIt(Scope::SP scope)
 
     PacketRegion::SP region;
 
-    switch (_it->kind()) {
+    switch (_its->it->kind()) {
     case ElemKind::SIGNED_INT:
     case ElemKind::SIGNED_ENUM:
         region = this->_contentRegionFromBitArrayElemAtCurIt<yactfr::SignedIntElement>(scope);
@@ -213,17 +381,17 @@ void Packet::_cacheContentRegionAtCurIt(Scope::SP scope)
         // get appropriate data type
         const yactfr::DataType *type;
 
-        switch (_it->kind()) {
+        switch (_its->it->kind()) {
         case ElemKind::STRING_BEGINNING:
-            type = &static_cast<const yactfr::StringBeginningElement&>(*_it).type();
+            type = &static_cast<const yactfr::StringBeginningElement&>(*_its->it).type();
             break;
 
         case ElemKind::STATIC_TEXT_ARRAY_BEGINNING:
-            type = &static_cast<const yactfr::StaticTextArrayBeginningElement&>(*_it).type();
+            type = &static_cast<const yactfr::StaticTextArrayBeginningElement&>(*_its->it).type();
             break;
 
         case ElemKind::DYNAMIC_TEXT_ARRAY_BEGINNING:
-            type = &static_cast<const yactfr::DynamicTextArrayBeginningElement&>(*_it).type();
+            type = &static_cast<const yactfr::DynamicTextArrayBeginningElement&>(*_its->it).type();
             break;
         default:
             std::abort();
@@ -235,30 +403,18 @@ void Packet::_cacheContentRegionAtCurIt(Scope::SP scope)
         const auto bufStart = _mmapFile->addr() + this->_itOffsetInPacketBytes();
         auto bufEnd = bufStart;
 
-        ++_it;
+        ++_its->it;
 
-        while (_it->kind() != ElemKind::STRING_END &&
-                _it->kind() != ElemKind::STATIC_TEXT_ARRAY_END &&
-                _it->kind() != ElemKind::DYNAMIC_TEXT_ARRAY_END) {
-            assert(_it->kind() == ElemKind::SUBSTRING);
+        while (_its->it->kind() != ElemKind::STRING_END &&
+                _its->it->kind() != ElemKind::STATIC_TEXT_ARRAY_END &&
+                _its->it->kind() != ElemKind::DYNAMIC_TEXT_ARRAY_END) {
+            assert(_its->it->kind() == ElemKind::SUBSTRING);
 
             // "consume" this substring
-            bufEnd += static_cast<const yactfr::SubstringElement&>(*_it).size();
-            ++_it;
+            bufEnd += static_cast<const yactfr::SubstringElement&>(*_its->it).size();
+            ++_its->it;
         }
 
-        /*
-         * Find end of string in buffer. std::find() returns either
-         * the location of the (first) null character or `bufEnd`.
-         */
-        const auto bufStrEnd = std::find(bufStart, bufEnd, 0);
-
-        // create string value
-        std::string str {
-            reinterpret_cast<const char *>(bufStart),
-            static_cast<std::string::size_type>(bufStrEnd - bufStart)
-        };
-
         const PacketSegment segment {
             offsetStartBits,
             DataSize::fromBytes(bufEnd - bufStart)
@@ -267,8 +423,7 @@ void Packet::_cacheContentRegionAtCurIt(Scope::SP scope)
         // okay to move the scope here, it's never used afterwards
         region = std::make_shared<ContentPacketRegion>(segment,
                                                        std::move(scope),
-                                                       *type,
-                                                       ContentPacketRegion::Value {str});
+                                                       *type);
         break;
     }
 
@@ -279,13 +434,291 @@ void Packet::_cacheContentRegionAtCurIt(Scope::SP scope)
     assert(region);
     this->_trySetPreviousRegionOffsetInPacketBits(*region);
     _curRegionCache.push_back(std::move(region));
+    stats::inc(stats::Counter::CACHED_REGIONS);
 
     /*
      * Caller expects the iterator to be passed this packet region. Do
-     * it after caching the region because `++_it` could throw a
+     * it after caching the region because `++_its->it` could throw a
      * decoding error.
      */
-    ++_it;
+    ++_its->it;
+}
+
+bool Packet::_tryCacheArrayRegionsAtCurIt(const Scope::SP& scope)
+{
+    using ElemKind = yactfr::Element::Kind;
+
+    const yactfr::DataType *elemType;
+    ElemKind endElemKind;
+
+    if (_its->it->kind() == ElemKind::STATIC_ARRAY_BEGINNING) {
+        auto& elem = static_cast<const yactfr::StaticArrayBeginningElement&>(*_its->it);
+
+        elemType = &elem.type().elemType();
+        endElemKind = ElemKind::STATIC_ARRAY_END;
+    } else {
+        assert(_its->it->kind() == ElemKind::DYNAMIC_ARRAY_BEGINNING);
+
+        auto& elem = static_cast<const yactfr::DynamicArrayBeginningElement&>(*_its->it);
+
+        elemType = &elem.type().elemType();
+        endElemKind = ElemKind::DYNAMIC_ARRAY_END;
+    }
+
+    // contiguous integers or floating point numbers only
+    if (!elemType->isBitArrayType()) {
+        return false;
+    }
+
+    const Size elemSizeBits = elemType->asBitArrayType()->size();
+
+    if (elemSizeBits % elemType->alignment() != 0) {
+        return false;
+    }
+
+    // no content packet region for each element, just count them
+    boost::optional<Index> firstElemOffsetInPacketBits;
+    Size elemCount = 0;
+
+    ++_its->it;
+
+    while (_its->it->kind() != endElemKind) {
+        switch (_its->it->kind()) {
+        case ElemKind::SIGNED_INT:
+        case ElemKind::UNSIGNED_INT:
+        case ElemKind::SIGNED_ENUM:
+        case ElemKind::UNSIGNED_ENUM:
+        case ElemKind::FLOAT:
+            if (!firstElemOffsetInPacketBits) {
+                this->_tryCachePaddingRegionBeforeCurIt(scope);
+                firstElemOffsetInPacketBits = this->_itOffsetInPacketBits();
+            }
+
+            ++elemCount;
+            break;
+
+        default:
+            break;
+        }
+
+        ++_its->it;
+    }
+
+    if (elemCount >= _minArrayRegionElemCount) {
+        const PacketSegment segment {
+            *firstElemOffsetInPacketBits, elemCount * elemSizeBits
+        };
+        auto region = std::make_shared<ArrayPacketRegion>(segment, scope,
+                                                          *elemType,
+                                                          elemCount);
+
+        this->_trySetPreviousRegionOffsetInPacketBits(*region);
+        _curRegionCache.push_back(std::move(region));
+        stats::inc(stats::Counter::CACHED_REGIONS);
+        return true;
+    }
+
+    for (Index index = 0; index < elemCount; ++index) {
+        const PacketSegment segment {
+            *firstElemOffsetInPacketBits + index * elemSizeBits, elemSizeBits
+        };
+        auto region = std::make_shared<ContentPacketRegion>(segment, scope,
+                                                            *elemType);
+
+        this->_trySetPreviousRegionOffsetInPacketBits(*region);
+        _curRegionCache.push_back(std::move(region));
+        stats::inc(stats::Counter::CACHED_REGIONS);
+    }
+
+    return true;
+}
+
+PacketRegion::SP Packet::_arrayElemRegion(const PacketRegion::SP& region,
+                                          const Index offsetInPacketBits)
+{
+    auto& arrayRegion = static_cast<ArrayPacketRegion&>(*region);
+    const auto elemOffsetInPacketBits = arrayRegion.elemOffsetInPacketBits(offsetInPacketBits);
+    const PacketSegment segment {
+        elemOffsetInPacketBits, arrayRegion.elemSize()
+    };
+    auto elemRegion = std::make_shared<ContentPacketRegion>(segment,
+                                                            arrayRegion.scopePtr(),
+                                                            arrayRegion.dataType());
+
+    if (elemOffsetInPacketBits == arrayRegion.segment().offsetInPacketBits()) {
+        // first element
+        if (arrayRegion.previousRegionOffsetInPacketBits()) {
+            elemRegion->previousRegionOffsetInPacketBits(*arrayRegion.previousRegionOffsetInPacketBits());
+        }
+    } else {
+        elemRegion->previousRegionOffsetInPacketBits(elemOffsetInPacketBits -
+                                                     arrayRegion.elemSize().bits());
+    }
+
+    stats::inc(stats::Counter::ARRAY_ELEM_REGIONS);
+    return elemRegion;
+}
+
+boost::optional<Packet::_ErLayoutTemplateKey> Packet::_erLayoutTemplateKeyAtCurIt(const EventRecord& eventRecord) const
+{
+    if (!eventRecord.type()) {
+        return boost::none;
+    }
+
+    const auto alignment = _metadata->eventRecordTypeStaticLayoutAlignment(*eventRecord.type());
+
+    if (!alignment) {
+        return boost::none;
+    }
+
+    return _ErLayoutTemplateKey {
+        eventRecord.type(), this->_itOffsetInPacketBits() % *alignment
+    };
+}
+
+boost::optional<Packet::_ErLayoutTemplate> Packet::_erLayoutTemplateFromRegionCache(const Index firstRegionIndex,
+                                                                                    const Index layoutOffsetInPacketBits) const
+{
+    _ErLayoutTemplate layoutTemplate;
+
+    layoutTemplate.sizeBits = this->_itOffsetInPacketBits() -
+                              layoutOffsetInPacketBits;
+
+    for (auto it = std::begin(_curRegionCache) + firstRegionIndex;
+            it != std::end(_curRegionCache); ++it) {
+        const auto& region = **it;
+        _RegionTemplate regionTemplate {
+            region.segment().offsetInPacketBits() - layoutOffsetInPacketBits,
+            region.segment().size()->bits(), nullptr, boost::none, 0
+        };
+
+        if (const auto cRegion = dynamic_cast<const ContentPacketRegion *>(&region)) {
+            regionTemplate.dataType = &cRegion->dataType();
+
+            if (const auto aRegion = dynamic_cast<const ArrayPacketRegion *>(&region)) {
+                regionTemplate.elemCount = aRegion->elemCount();
+            }
+        } else if (!dynamic_cast<const PaddingPacketRegion *>(&region)) {
+            return boost::none;
+        }
+
+        if (region.scope()) {
+            const auto& scope = *region.scope();
+            const auto scopeIt = std::find_if(std::begin(layoutTemplate.scopes),
+                                              std::end(layoutTemplate.scopes),
+                                              [&scope](const auto& scopeTemplate) {
+                return scopeTemplate.scope == scope.scope();
+            });
+            const Index scopeIndex = scopeIt - std::begin(layoutTemplate.scopes);
+
+            if (scopeIt == std::end(layoutTemplate.scopes)) {
+                if ((scope.scope() != yactfr::Scope::EVENT_RECORD_SECOND_CONTEXT &&
+                        scope.scope() != yactfr::Scope::EVENT_RECORD_PAYLOAD) ||
+                        !scope.segment().size()) {
+                    return boost::none;
+                }
+
+                layoutTemplate.scopes.push_back({
+                    scope.scope(),
+                    scope.segment().offsetInPacketBits() - layoutOffsetInPacketBits,
+                    scope.segment().size()->bits(), scope.dataType()
+                });
+            }
+
+            regionTemplate.scopeIndex = scopeIndex;
+        }
+
+        layoutTemplate.regions.push_back(regionTemplate);
+    }
+
+    return layoutTemplate;
+}
+
+void Packet::_cacheRegionsFromErLayoutTemplateAtCurIt(const _ErLayoutTemplate& layoutTemplate,
+                                                      const EventRecord::SP& eventRecord)
+{
+    using ElemKind = yactfr::Element::Kind;
+
+    const auto layoutOffsetInPacketBits = this->_itOffsetInPacketBits();
+    std::array<Scope::SP, 2> scopes;
+
+    assert(layoutTemplate.scopes.size() <= scopes.size());
+
+    for (Index index = 0; index < layoutTemplate.scopes.size(); ++index) {
+        const auto& scopeTemplate = layoutTemplate.scopes[index];
+        const PacketSegment segment {
+            layoutOffsetInPacketBits + scopeTemplate.offsetInLayoutBits,
+            scopeTemplate.sizeBits
+        };
+
+        scopes[index] = std::make_shared<Scope>(eventRecord,
+                                                scopeTemplate.scope, segment);
+
+        if (scopeTemplate.dataType) {
+            scopes[index]->dataType(*scopeTemplate.dataType);
+        }
+    }
+
+    for (const auto& regionTemplate : layoutTemplate.regions) {
+        const auto offsetInPacketBits = layoutOffsetInPacketBits +
+                                        regionTemplate.offsetInLayoutBits;
+        Scope::SP scope;
+        PacketRegion::SP region;
+
+        if (regionTemplate.scopeIndex) {
+            scope = scopes[*regionTemplate.scopeIndex];
+        }
+
+        if (regionTemplate.dataType) {
+            const PacketSegment segment {
+                offsetInPacketBits, regionTemplate.sizeBits
+            };
+
+            if (regionTemplate.elemCount > 0) {
+                region = std::make_shared<ArrayPacketRegion>(segment,
+                                                             std::move(scope),
+                                                             *regionTemplate.dataType,
+                                                             regionTemplate.elemCount);
+            } else {
+                region = std::make_shared<ContentPacketRegion>(segment,
+                                                               std::move(scope),
+                                                               *regionTemplate.dataType);
+            }
+        } else {
+            // like _tryCachePaddingRegionBeforeCurIt()
+            assert(!_curRegionCache.empty());
+
+            const PacketSegment segment {
+                offsetInPacketBits, regionTemplate.sizeBits,
+                _curRegionCache.back()->segment().byteOrder()
+            };
+
+            region = std::make_shared<PaddingPacketRegion>(segment,
+                                                           std::move(scope));
+        }
+
+        this->_trySetPreviousRegionOffsetInPacketBits(*region);
+        _curRegionCache.push_back(std::move(region));
+        stats::inc(stats::Counter::CACHED_REGIONS);
+    }
+
+    // skip the layout's elements: only a first timestamp could be missing
+    while (_its->it->kind() != ElemKind::EVENT_RECORD_END) {
+        if (_its->it->kind() == ElemKind::CLOCK_VALUE &&
+                !eventRecord->firstTimestamp() && _metadata->isCorrelatable()) {
+            auto& elem = static_cast<const yactfr::ClockValueElement&>(*_its->it);
+
+            eventRecord->firstTimestamp(Timestamp {
+                elem.cycles(), _metadata->cyclesToNsConverter(elem.clockType())
+            });
+        }
+
+        ++_its->it;
+    }
+
+    assert(this->_itOffsetInPacketBits() ==
+           layoutOffsetInPacketBits + layoutTemplate.sizeBits);
+    stats::inc(stats::Counter::TEMPLATE_EVENT_RECORDS);
 }
 
 void Packet::_tryCachePaddingRegionBeforeCurIt(Scope::SP scope)
@@ -323,6 +756,7 @@ void Packet::_tryCachePaddingRegionBeforeCurIt(Scope::SP scope)
 
     this->_trySetPreviousRegionOffsetInPacketBits(*region);
     _curRegionCache.push_back(std::move(region));
+    stats::inc(stats::Counter::CACHED_REGIONS);
 }
 
 void Packet::_cachePreambleRegions()
@@ -332,8 +766,10 @@ void Packet::_cachePreambleRegions()
     assert(_preambleRegionCache.empty());
     assert(_curRegionCache.empty());
 
+    const _ItsGuard itsGuard {*this};
+
     // go to beginning of packet
-    _it.seekPacket(_indexEntry->offsetInDataStreamFileBytes());
+    _its->it.seekPacket(_indexEntry->offsetInDataStreamFileBytes());
 
     // special case: no event records and an error: cache everything now
     if (_checkpoints.error() && _checkpoints.eventRecordCount() == 0) {
@@ -348,7 +784,7 @@ void Packet::_cachePreambleRegions()
     try {
         while (!isDone) {
             // TODO: replace with element visitor
-            switch (_it->kind()) {
+            switch (_its->it->kind()) {
             case ElemKind::SIGNED_INT:
             case ElemKind::UNSIGNED_INT:
             case ElemKind::SIGNED_ENUM:
@@ -368,23 +804,23 @@ void Packet::_cachePreambleRegions()
                 // cache padding before scope
                 this->_tryCachePaddingRegionBeforeCurIt(curScope);
 
-                auto& elem = static_cast<const yactfr::ScopeBeginningElement&>(*_it);
+                auto& elem = static_cast<const yactfr::ScopeBeginningElement&>(*_its->it);
 
                 curScope = std::make_shared<Scope>(elem.scope());
                 curScope->segment().offsetInPacketBits(this->_itOffsetInPacketBits());
-                ++_it;
+                ++_its->it;
                 break;
             }
 
             case ElemKind::STRUCT_BEGINNING:
             {
                 if (curScope && !curScope->dataType()) {
-                    auto& elem = static_cast<const yactfr::StructBeginningElement&>(*_it);
+                    auto& elem = static_cast<const yactfr::StructBeginningElement&>(*_its->it);
 
                     curScope->dataType(elem.type());
                 }
 
-                ++_it;
+                ++_its->it;
                 break;
             }
 
@@ -394,7 +830,7 @@ void Packet::_cachePreambleRegions()
                 curScope->segment().size(this->_itOffsetInPacketBits() -
                                          curScope->segment().offsetInPacketBits());
                 curScope = nullptr;
-                ++_it;
+                ++_its->it;
                 break;
             }
 
@@ -406,8 +842,8 @@ void Packet::_cachePreambleRegions()
 
             case ElemKind::PACKET_CONTENT_END:
                 // cache padding before end of packet
-                while (_it->kind() != ElemKind::PACKET_END) {
-                    ++_it;
+                while (_its->it->kind() != ElemKind::PACKET_END) {
+                    ++_its->it;
                 }
 
                 this->_tryCachePaddingRegionBeforeCurIt(curScope);
@@ -415,7 +851,7 @@ void Packet::_cachePreambleRegions()
                 break;
 
             default:
-                ++_it;
+                ++_its->it;
                 break;
             }
         }
@@ -439,6 +875,7 @@ void Packet::_cachePreambleRegions()
 
             this->_trySetPreviousRegionOffsetInPacketBits(*region);
             _curRegionCache.push_back(std::move(region));
+            stats::inc(stats::Counter::CACHED_REGIONS);
         }
     }
 
@@ -454,14 +891,28 @@ void Packet::_cacheRegionsAtCurIt(const yactfr::Element::Kind endElemKind,
     Scope::SP curScope;
     bool isDone = false;
 
+    /*
+     * Layout templates only apply to complete event records: a
+     * decoding error could occur within the layout otherwise.
+     */
+    const auto useLayoutTemplates = endElemKind == ElemKind::EVENT_RECORD_END;
+
+    // true if the current event record's layout began
+    bool isInErLayout = false;
+
+    // layout template to record at the end of the current event record
+    boost::optional<_ErLayoutTemplateKey> recLayoutTemplateKey;
+    Index recFirstRegionIndex = 0;
+    Index recLayoutOffsetInPacketBits = 0;
+
     while (!isDone) {
-        if (_it->kind() == endElemKind) {
+        if (_its->it->kind() == endElemKind) {
             // done after this iteration
             isDone = true;
         }
 
         // TODO: replace with element visitor
-        switch (_it->kind()) {
+        switch (_its->it->kind()) {
         case ElemKind::SIGNED_INT:
         case ElemKind::UNSIGNED_INT:
         case ElemKind::SIGNED_ENUM:
@@ -476,28 +927,64 @@ void Packet::_cacheRegionsAtCurIt(const yactfr::Element::Kind endElemKind,
             this->_cacheContentRegionAtCurIt(curScope);
             break;
 
+        case ElemKind::STATIC_ARRAY_BEGINNING:
+        case ElemKind::DYNAMIC_ARRAY_BEGINNING:
+            /*
+             * _tryCacheArrayRegionsAtCurIt() moves the iterator to the
+             * end of the array if it caches its elements.
+             */
+            if (!this->_tryCacheArrayRegionsAtCurIt(curScope)) {
+                ++_its->it;
+            }
+
+            break;
+
         case ElemKind::SCOPE_BEGINNING:
         {
             // cache padding before scope
             this->_tryCachePaddingRegionBeforeCurIt(curScope);
 
-            auto& elem = static_cast<const yactfr::ScopeBeginningElement&>(*_it);
+            auto& elem = static_cast<const yactfr::ScopeBeginningElement&>(*_its->it);
+
+            if (useLayoutTemplates && curEr && !isInErLayout &&
+                    (elem.scope() == yactfr::Scope::EVENT_RECORD_SECOND_CONTEXT ||
+                     elem.scope() == yactfr::Scope::EVENT_RECORD_PAYLOAD)) {
+                isInErLayout = true;
+
+                const auto key = this->_erLayoutTemplateKeyAtCurIt(*curEr);
+
+                if (key) {
+                    const auto it = _erLayoutTemplates.find(*key);
+
+                    if (it == std::end(_erLayoutTemplates)) {
+                        // first one: record its layout
+                        recLayoutTemplateKey = key;
+                        recFirstRegionIndex = _curRegionCache.size();
+                        recLayoutOffsetInPacketBits = this->_itOffsetInPacketBits();
+                    } else if (it->second) {
+                        // moves the iterator to the end of the event record
+                        this->_cacheRegionsFromErLayoutTemplateAtCurIt(*it->second,
+                                                                       curEr);
+                        break;
+                    }
+                }
+            }
 
             curScope = std::make_shared<Scope>(curEr, elem.scope());
             curScope->segment().offsetInPacketBits(this->_itOffsetInPacketBits());
-            ++_it;
+            ++_its->it;
             break;
         }
 
         case ElemKind::STRUCT_BEGINNING:
         {
             if (curScope && !curScope->dataType()) {
-                auto& elem = static_cast<const yactfr::StructBeginningElement&>(*_it);
+                auto& elem = static_cast<const yactfr::StructBeginningElement&>(*_its->it);
 
                 curScope->dataType(elem.type());
             }
 
-            ++_it;
+            ++_its->it;
             break;
         }
 
@@ -508,7 +995,7 @@ void Packet::_cacheRegionsAtCurIt(const yactfr::Element::Kind endElemKind,
                 curScope = nullptr;
             }
 
-            ++_it;
+            ++_its->it;
             break;
 
         case ElemKind::EVENT_RECORD_BEGINNING:
@@ -519,45 +1006,55 @@ void Packet::_cacheRegionsAtCurIt(const yactfr::Element::Kind endElemKind,
 
             // immediately cache it because this loop could throw before the end
             _curEventRecordCache.push_back(curEr);
-            ++_it;
+            ++_its->it;
             break;
 
         case ElemKind::EVENT_RECORD_END:
             if (curEr) {
+                if (recLayoutTemplateKey) {
+                    _erLayoutTemplates[*recLayoutTemplateKey] =
+                        this->_erLayoutTemplateFromRegionCache(recFirstRegionIndex,
+                                                               recLayoutOffsetInPacketBits);
+                    recLayoutTemplateKey = boost::none;
+                }
+
                 curEr->segment().size(this->_itOffsetInPacketBits() -
                                       curEr->segment().offsetInPacketBits());
                 curScope = nullptr;
                 curEr = nullptr;
+                isInErLayout = false;
                 ++erIndexInPacket;
             }
 
-            ++_it;
+            ++_its->it;
             break;
 
         case ElemKind::EVENT_RECORD_TYPE:
             if (curEr) {
-                auto& elem = static_cast<const yactfr::EventRecordTypeElement&>(*_it);
+                auto& elem = static_cast<const yactfr::EventRecordTypeElement&>(*_its->it);
 
                 curEr->type(elem.eventRecordType());
             }
 
-            ++_it;
+            ++_its->it;
             break;
 
         case ElemKind::CLOCK_VALUE:
             if (curEr) {
                 if (!curEr->firstTimestamp() && _metadata->isCorrelatable()) {
-                    auto& elem = static_cast<const yactfr::ClockValueElement&>(*_it);
+                    auto& elem = static_cast<const yactfr::ClockValueElement&>(*_its->it);
 
-                    curEr->firstTimestamp(Timestamp {elem});
+                    curEr->firstTimestamp(Timestamp {
+                        elem.cycles(), _metadata->cyclesToNsConverter(elem.clockType())
+                    });
                 }
             }
 
-            ++_it;
+            ++_its->it;
             break;
 
         default:
-            ++_it;
+            ++_its->it;
             break;
         }
     }
@@ -567,7 +1064,7 @@ void Packet::_cacheRegionsFromOneErAtCurIt(const Index indexInPacket)
 {
     using ElemKind = yactfr::Element::Kind;
 
-    assert(_it->kind() == ElemKind::EVENT_RECORD_BEGINNING);
+    assert(_its->it->kind() == ElemKind::EVENT_RECORD_BEGINNING);
     this->_cacheRegionsAtCurIt(ElemKind::EVENT_RECORD_END, indexInPacket);
 }
 
@@ -596,6 +1093,7 @@ void Packet::_cacheRegionsAtCurItUntilError(const Index initErIndexInPacket)
 
             this->_trySetPreviousRegionOffsetInPacketBits(*region);
             _curRegionCache.push_back(std::move(region));
+            stats::inc(stats::Counter::CACHED_REGIONS);
         }
     }
 }
@@ -603,6 +1101,8 @@ void Packet::_cacheRegionsAtCurItUntilError(const Index initErIndexInPacket)
 void Packet::_cacheRegionsFromErsAtCurIt(const Index erIndexInPacket,
                                          const Size erCount)
 {
+    const profiler::Span span {"Packet::_cacheRegionsFromErsAtCurIt"};
+
     /*
      * This function's logic:
      *
@@ -622,7 +1122,7 @@ void Packet::_cacheRegionsFromErsAtCurIt(const Index erIndexInPacket,
 
     using ElemKind = yactfr::Element::Kind;
 
-    assert(_it->kind() == ElemKind::EVENT_RECORD_BEGINNING);
+    assert(_its->it->kind() == ElemKind::EVENT_RECORD_BEGINNING);
     _curRegionCache.clear();
     _curEventRecordCache.clear();
 
@@ -638,9 +1138,9 @@ void Packet::_cacheRegionsFromErsAtCurIt(const Index erIndexInPacket,
 
     for (auto index = erIndexInPacket;
             index < endErIndexInPacketBeforeLast; ++index) {
-        while (_it->kind() != ElemKind::EVENT_RECORD_BEGINNING) {
-            assert(_it->kind() != ElemKind::PACKET_CONTENT_END);
-            ++_it;
+        while (_its->it->kind() != ElemKind::EVENT_RECORD_BEGINNING) {
+            assert(_its->it->kind() != ElemKind::PACKET_CONTENT_END);
+            ++_its->it;
         }
 
         this->_cacheRegionsFromOneErAtCurIt(index);
@@ -658,8 +1158,8 @@ void Packet::_cacheRegionsFromErsAtCurIt(const Index erIndexInPacket,
             this->_cacheRegionsAtCurItUntilError(endErIndexInPacketBeforeLast);
         } else {
             // end of packet: also cache any padding before the end of packet
-            while (_it->kind() != ElemKind::PACKET_END) {
-                ++_it;
+            while (_its->it->kind() != ElemKind::PACKET_END) {
+                ++_its->it;
             }
 
             this->_tryCachePaddingRegionBeforeCurIt(nullptr);
@@ -669,30 +1169,41 @@ void Packet::_cacheRegionsFromErsAtCurIt(const Index erIndexInPacket,
 
 const PacketRegion& Packet::regionAtOffsetInPacketBits(const Index offsetInPacketBits)
 {
-    auto regionFromLru = _lruRegionCache.get(offsetInPacketBits);
+    auto regionFromCache = _offsetRegionCache.get(offsetInPacketBits);
 
-    if (regionFromLru) {
-        return **regionFromLru;
+    if (regionFromCache) {
+        stats::inc(stats::Counter::OFFSET_REGION_CACHE_HITS);
+        return **regionFromCache;
     }
 
+    stats::inc(stats::Counter::OFFSET_REGION_CACHE_MISSES);
+
     this->_ensureOffsetInPacketBitsIsCached(offsetInPacketBits);
 
     const auto it = this->_regionCacheItBeforeOrAtOffsetInPacketBits(offsetInPacketBits);
-    const auto& region = **it;
+    auto regionPtr = *it;
+
+    if (dynamic_cast<const ArrayPacketRegion *>(regionPtr.get())) {
+        // never return an array packet region: create the element's one
+        regionPtr = this->_arrayElemRegion(*it, offsetInPacketBits);
+        _lastArrayElemRegion = regionPtr;
+    }
+
+    const auto& region = *regionPtr;
 
     /*
      * Add both the requested offset and the actual packet region's offset
      * to the cache so that future requests using this exact offset hit
      * the cache.
      */
-    if (!_lruRegionCache.contains(offsetInPacketBits)) {
-        _lruRegionCache.insert(offsetInPacketBits, *it);
+    if (!_offsetRegionCache.contains(offsetInPacketBits)) {
+        _offsetRegionCache.insert(offsetInPacketBits, regionPtr);
     }
 
     const auto drOffsetInPacketBits = region.segment().offsetInPacketBits();
 
-    if (!_lruRegionCache.contains(drOffsetInPacketBits)) {
-        _lruRegionCache.insert(drOffsetInPacketBits, *it);
+    if (!_offsetRegionCache.contains(drOffsetInPacketBits)) {
+        _offsetRegionCache.insert(drOffsetInPacketBits, regionPtr);
     }
 
     return region;
@@ -9,13 +9,17 @@
 #define _JACQUES_PACKET_HPP
 
 #include <algorithm>
+#include <functional>
+#include <list>
+#include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 #include <yactfr/element-sequence.hpp>
 #include <yactfr/element-sequence-iterator.hpp>
-#include <yactfr/data-source.hpp>
 #include <yactfr/metadata/float-type.hpp>
 #include <yactfr/metadata/int-type.hpp>
+#include <boost/optional.hpp>
 #include <boost/core/noncopyable.hpp>
 
 #include "packet-index-entry.hpp"
@@ -25,10 +29,14 @@
 #include "packet-segment.hpp"
 #include "bit-array.hpp"
 #include "content-packet-region.hpp"
+#include "array-packet-region.hpp"
 #include "packet-checkpoints-build-listener.hpp"
 #include "metadata.hpp"
 #include "memory-mapped-file.hpp"
-#include "lru-cache.hpp"
+#include "data-stream-file-handles.hpp"
+#include "cache.hpp"
+#include "stats.hpp"
+#include "packet-cache-config.hpp"
 
 namespace jacques {
 
@@ -48,13 +56,20 @@ namespace jacques {
  *
  * The packet region cache is a sorted vector of contiguous shared
  * packet regions. The caching operation performed by
- * _ensureEventRecordIsCached() makes sure that all the packet regions
- * of at most `_eventRecordCacheMaxSize` event records starting at the
- * requested index minus `_eventRecordCacheMaxSize / 2` are in cache.
- * Substracting `_eventRecordCacheMaxSize / 2` makes packet regions and
- * event records available "around" the requested index, which makes
- * sense for a packet inspection activity because the user is typically
- * inspecting around a given offset.
+ * _ensureEventRecordsAreCached() makes sure that all the packet regions
+ * of at most `windowEventRecordCount` (see `PacketCacheConfig`)
+ * contiguous event records containing the requested ones are in cache.
+ * We call such a packet region cache and its event record cache a
+ * window.
+ *
+ * Where a new window starts depends on the direction of the requests.
+ * When the requested event record immediately follows the current
+ * window, the user is typically scrolling forward, so the new window
+ * mostly extends after the requested event record. When it immediately
+ * precedes the current window, the new window mostly extends before it.
+ * Otherwise (jump), the requested event record is centered within the
+ * new window, because the user is typically inspecting around a given
+ * offset.
  *
  * When a packet object is constructed, it caches everything known to be
  * in the preamble segment, that is, everything before the first event
@@ -102,29 +117,46 @@ namespace jacques {
  *     ...*******--******----...**********----********!!!!!!!!!!!!!!!
  *                 ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
  *
+ * The second context and payload of many event record types have a
+ * static layout. For those, _cacheRegionsAtCurIt() only builds the
+ * packet regions and scopes from the elements the first time it meets
+ * an event record of a given type (at a given offset modulo the
+ * layout's alignment), recording them as a layout template. The next
+ * event records of the same type get their packet regions from this
+ * template by adding their layout's offset.
+ *
+ * An array of at least `_minArrayRegionElemCount` contiguous integers
+ * or floating point numbers is a single array packet region in the
+ * packet region cache, so that the cost of caching it does not depend
+ * on its length. regionAtOffsetInPacketBits() creates the content
+ * packet region of a single element when the requested offset is
+ * within an array packet region.
+ *
  * Because elements are naturally sorted in the caches, we can perform a
  * binary search to find a specific element using one of its
  * intrinsically ordered properties (index, offset in packet,
  * timestamp).
  *
- * As of this version, when setting the preamble region cache as the
- * current cache, we move the current region cache (and current event
- * record cache) to temporary members from which the current caches can
- * be restored. This can be viewed as a double buffer, where you can
- * simultaneously have the preamble region cache and the last region
- * cache available. This helps in scenarios where the non-preamble
- * region cache is huge (contains a single, incomplete event with a
- * somewhat huge total packet size, for example) to avoid creating this
- * huge cache everytime the requests alternate between the preamble
- * region cache and the non-preamble region cache. This could be
- * generalized with an LRU cache of packet region caches.
+ * When a new window becomes the current one, the previous current
+ * window (unless it's the preamble region cache, which is always
+ * available) becomes the most recently used of the other windows,
+ * from which it can be restored without decoding anything. This helps
+ * when the requests alternate between distant locations of the packet
+ * (the preamble and some event record, or two search results, for
+ * example), especially when a window is huge (contains a single,
+ * incomplete event record with a somewhat huge total packet size, for
+ * example). We keep at most `windowCount` windows, including the
+ * current one, and we evict the least recently used other windows when
+ * all the windows contain more than `maxRegionCount` packet regions in
+ * total.
  *
- * There's also an LRU cache (offset in packet to packet region) for
- * frequently accessed packet regions by offset (with
- * regionAtOffsetInPacketBits()): when there's a cache miss, the method
- * calls _ensureOffsetInPacketBitsIsCached() to update the packet region
- * and event record caches and then adds the packet region entry to the
- * LRU cache. The LRU cache avoids performing a binary search by
+ * There's also an offset region cache (offset in packet to packet
+ * region, see `cache.hpp`) for frequently accessed packet regions by
+ * offset (with regionAtOffsetInPacketBits()): when there's a cache
+ * miss, the method calls _ensureOffsetInPacketBitsIsCached() to update
+ * the packet region and event record caches and then adds the packet
+ * region entry to the offset region cache. The offset region cache
+ * avoids performing a binary search by
  * _regionCacheItBeforeOrAtOffsetInPacketBits() every time.
  */
 class Packet :
@@ -133,13 +165,23 @@ class Packet :
 public:
     using SP = std::shared_ptr<Packet>;
 
+    // returns the open handles of the packet's data stream file
+    using FileHandlesAcquirer = std::function<DataStreamFileHandles::SP ()>;
+
 public:
+    /*
+     * The packet doesn't own the handles which `acquireFileHandles`
+     * returns: it only keeps them while it decodes, so that a file
+     * handle pool can close them between two decoding operations.
+     * Checkpoint positions remain valid with the reacquired handles
+     * because they only depend on the trace type of `metadata`.
+     */
     explicit Packet(const PacketIndexEntry& indexEntry,
-                    yactfr::ElementSequence& seq,
+                    FileHandlesAcquirer acquireFileHandles,
                     const Metadata& metadata,
-                    yactfr::DataSource::UP dataSrc,
                     std::unique_ptr<MemoryMappedFile> mmapFile,
-                    PacketCheckpointsBuildListener& packetCheckpointsBuildListener);
+                    PacketCheckpointsBuildListener& packetCheckpointsBuildListener,
+                    const PacketCacheConfig& cacheConfig = PacketCacheConfig {});
 
     template <typename ContainerT>
     void appendRegions(ContainerT& regions,
@@ -326,9 +368,111 @@ public:
     }
 
 private:
+    // minimum element count of an array packet region
+    static constexpr Size _minArrayRegionElemCount = 64;
+
     using _RegionCache = std::vector<PacketRegion::SP>;
     using _EventRecordCache = std::vector<EventRecord::SP>;
 
+    struct _Window
+    {
+        _RegionCache regionCache;
+        _EventRecordCache eventRecordCache;
+    };
+
+    /*
+     * Layout template of the second context and payload of an event
+     * record type. Offsets are relative to the beginning of the first
+     * of those two scopes (the layout's offset).
+     */
+    struct _ScopeTemplate
+    {
+        yactfr::Scope scope;
+        Index offsetInLayoutBits;
+        Size sizeBits;
+        const yactfr::DataType *dataType;
+    };
+
+    struct _RegionTemplate
+    {
+        Index offsetInLayoutBits;
+        Size sizeBits;
+
+        // `nullptr` for a padding packet region
+        const yactfr::DataType *dataType;
+
+        // index of the packet region's scope within the scope templates
+        boost::optional<Index> scopeIndex;
+
+        // element count of an array packet region, 0 otherwise
+        Size elemCount;
+    };
+
+    struct _ErLayoutTemplate
+    {
+        std::vector<_ScopeTemplate> scopes;
+        std::vector<_RegionTemplate> regions;
+
+        // from the layout's offset to the end of the event record
+        Size sizeBits;
+    };
+
+    // event record type and layout's offset modulo its alignment
+    using _ErLayoutTemplateKey = std::pair<const yactfr::EventRecordType *,
+                                           Index>;
+
+    // iterators of the element sequence of acquired file handles
+    struct _Its
+    {
+        explicit _Its(DataStreamFileHandles::SP fileHandles) :
+            fileHandles {std::move(fileHandles)},
+            it {std::begin(this->fileHandles->seq())},
+            endIt {std::end(this->fileHandles->seq())}
+        {
+        }
+
+        // keeps the element sequence and its file descriptor open
+        const DataStreamFileHandles::SP fileHandles;
+
+        yactfr::ElementSequenceIterator it;
+        yactfr::ElementSequenceIterator endIt;
+    };
+
+    /*
+     * Makes `_its` available while it exists, creating it from newly
+     * acquired file handles if needed. The last destroyed guard resets
+     * `_its`, releasing the file handles.
+     *
+     * Any method which positions `_its->it` (restoring a checkpoint or
+     * seeking a packet) must have a guard.
+     */
+    class _ItsGuard :
+        boost::noncopyable
+    {
+    public:
+        explicit _ItsGuard(Packet& packet) :
+            _packet {&packet}
+        {
+            if (!_packet->_its) {
+                _packet->_its = std::make_unique<_Its>(_packet->_acquireFileHandles());
+            }
+
+            ++_packet->_itsGuardCount;
+        }
+
+        ~_ItsGuard()
+        {
+            assert(_packet->_itsGuardCount > 0);
+
+            if (--_packet->_itsGuardCount == 0) {
+                _packet->_its = nullptr;
+            }
+        }
+
+    private:
+        Packet * const _packet;
+    };
+
 private:
     /*
      * Caches the whole packet preamble (single time): packet header,
@@ -340,22 +484,72 @@ private:
     void _cachePreambleRegions();
 
     /*
-     * Makes sure that the event record at index `indexInPacket` exists
-     * in the caches. If it does not exist, this method caches the
-     * requested event record as well as half of
-     * `_eventRecordCacheMaxSize` event records around it (if possible),
-     * centering the requested event record within its cache.
+     * Makes sure that the event records from index `indexInPacket` to
+     * index `lastIndexInPacket` (included) exist in the current window.
+     * If they do not, this method makes the other window containing
+     * them the current one or, if there's none, caches a new window
+     * containing them (see _newWindowFirstEventRecordIndex()).
      */
-    void _ensureEventRecordIsCached(Index indexInPacket);
+    void _ensureEventRecordsAreCached(Index indexInPacket,
+                                      Index lastIndexInPacket);
+
+    void _ensureEventRecordIsCached(const Index indexInPacket)
+    {
+        this->_ensureEventRecordsAreCached(indexInPacket, indexInPacket);
+    }
+
+    /*
+     * Returns the index of the first event record of a new window to
+     * contain the event record at index `indexInPacket`, depending on
+     * the position of the latter relative to the current window.
+     */
+    Index _newWindowFirstEventRecordIndex(Index indexInPacket) const;
+
+    /*
+     * Makes the current window the most recently used other window,
+     * unless it's the preamble region cache, and clears the current
+     * window.
+     */
+    void _deactivateCurWindow();
+
+    /*
+     * Makes the other window at `it` the current one.
+     */
+    void _activateWindow(std::list<_Window>::iterator it);
+
+    /*
+     * Evicts the least recently used other windows until the windows
+     * respect the window count and total packet region count limits.
+     */
+    void _trimWindows();
 
     /*
      * Makes sure that a packet region containing the bit
      * `offsetInPacketBits` exists in cache. If it does not exist, the
      * method finds the closest event record containing this bit and
-     * calls _ensureEventRecordIsCached() with its index.
+     * calls _ensureEventRecordsAreCached() with its index and the
+     * following one.
      */
     void _ensureOffsetInPacketBitsIsCached(Index offsetInPacketBits);
 
+    /*
+     * Returns the index of the event record which contains the bit
+     * `offsetInPacketBits` or, if this bit is within the padding
+     * between two event records, of the first one.
+     *
+     * If all the event records of this packet have the same static
+     * size, this method computes the index directly. Otherwise, it
+     * restores the nearest checkpoint and decodes from there.
+     */
+    Index _eventRecordIndexBeforeOrAtOffsetInPacketBits(Index offsetInPacketBits);
+
+    /*
+     * Sets `_eventRecordStaticSize` if all the event records of this
+     * packet have the same static size (see
+     * Metadata::dataStreamTypeStaticEventRecordSize()).
+     */
+    void _trySetEventRecordStaticSize();
+
     /*
      * Appends all the remaining packet regions starting at the current
      * iterator until any decoding error and then an error packet
@@ -386,6 +580,53 @@ private:
     void _cacheRegionsAtCurIt(yactfr::Element::Kind endElemKind,
                               Index erIndexInPacket);
 
+    /*
+     * If the array at the current iterator contains contiguous integers
+     * or floating point numbers, appends the packet regions of its
+     * elements to the current cache, as a single array packet region
+     * if there are at least `_minArrayRegionElemCount` elements, moves
+     * the current iterator to the end of the array, and returns true.
+     *
+     * Otherwise, returns false without moving the current iterator.
+     */
+    bool _tryCacheArrayRegionsAtCurIt(const Scope::SP& scope);
+
+    /*
+     * Creates the content packet region of the element of the array
+     * packet region `region` which contains the bit
+     * `offsetInPacketBits`.
+     */
+    PacketRegion::SP _arrayElemRegion(const PacketRegion::SP& region,
+                                      Index offsetInPacketBits);
+
+    /*
+     * Returns the layout template key of the event record `eventRecord`
+     * of which the layout begins at the current iterator, or
+     * `boost::none` if its type has no static layout.
+     */
+    boost::optional<_ErLayoutTemplateKey> _erLayoutTemplateKeyAtCurIt(const EventRecord& eventRecord) const;
+
+    /*
+     * Creates a layout template from the packet regions of the current
+     * cache starting at index `firstRegionIndex`, the layout's offset
+     * being `layoutOffsetInPacketBits` and the current iterator being
+     * at the end of the event record.
+     *
+     * Returns `boost::none` if those packet regions cannot make a
+     * template.
+     */
+    boost::optional<_ErLayoutTemplate> _erLayoutTemplateFromRegionCache(Index firstRegionIndex,
+                                                                        Index layoutOffsetInPacketBits) const;
+
+    /*
+     * Appends the packet regions of `layoutTemplate` to the current
+     * cache, the layout's offset being the current iterator's offset,
+     * and then moves the current iterator to the end of the event
+     * record `eventRecord`.
+     */
+    void _cacheRegionsFromErLayoutTemplateAtCurIt(const _ErLayoutTemplate& layoutTemplate,
+                                                  const EventRecord::SP& eventRecord);
+
     /*
      * Tries to append a padding packet region to the current cache,
      * where this packet region would be located just before the current
@@ -464,7 +705,8 @@ private:
 
     /*
      * Returns whether or not the event record having the index
-     * `indexInPacket` exists in the caches.
+     * `indexInPacket` exists in the event record cache
+     * `eventRecordCache`.
      */
     bool _eventRecordIsCached(const _EventRecordCache& eventRecordCache,
                               const Index indexInPacket) const
@@ -485,7 +727,7 @@ private:
      */
     Index _itOffsetInPacketBits() const noexcept
     {
-        return _it.offset() - _indexEntry->offsetInDataStreamFileBits();
+        return _its->it.offset() - _indexEntry->offsetInDataStreamFileBits();
     }
 
     /*
@@ -504,7 +746,7 @@ private:
     template <typename ElemT>
     ContentPacketRegion::SP _contentRegionFromBitArrayElemAtCurIt(Scope::SP scope)
     {
-        auto& elem = static_cast<const ElemT&>(*_it);
+        auto& elem = static_cast<const ElemT&>(*_its->it);
         const PacketSegment segment {
             this->_itOffsetInPacketBits(), elem.type().size()
         };
@@ -512,8 +754,7 @@ private:
         // okay to move the scope here, it's never used afterwards
         return std::make_shared<ContentPacketRegion>(segment,
                                                      std::move(scope),
-                                                     elem.type(),
-                                                     ContentPacketRegion::Value {elem.value()});
+                                                     elem.type());
     }
 
     void _trySetPreviousRegionOffsetInPacketBits(PacketRegion& region) const
@@ -522,7 +763,15 @@ private:
             return;
         }
 
-        region.previousRegionOffsetInPacketBits(_curRegionCache.back()->segment().offsetInPacketBits());
+        const auto& prevRegion = *_curRegionCache.back();
+
+        // previous packet region of an array's next one is its last element
+        if (const auto aRegion = dynamic_cast<const ArrayPacketRegion *>(&prevRegion)) {
+            region.previousRegionOffsetInPacketBits(aRegion->lastElemOffsetInPacketBits());
+            return;
+        }
+
+        region.previousRegionOffsetInPacketBits(prevRegion.segment().offsetInPacketBits());
     }
 
     template <typename ContainerT, typename IterT>
@@ -561,37 +810,42 @@ private:
             return nullptr;
         }
 
-        _it.restorePosition(cp->second);
+        const _ItsGuard itsGuard {*this};
+
+        _its->it.restorePosition(cp->second);
+        stats::inc(stats::Counter::CHECKPOINTS_RESTORED);
 
         auto curIndex = cp->first->indexInPacket();
         auto inEventRecord = false;
         boost::optional<Timestamp> firstTs;
         boost::optional<Index> indexInPacket;
 
-        while (_it != _endIt) {
-            switch (_it->kind()) {
+        while (_its->it != _its->endIt) {
+            switch (_its->it->kind()) {
             case yactfr::Element::Kind::EVENT_RECORD_BEGINNING:
                 inEventRecord = true;
                 firstTs = boost::none;
-                ++_it;
+                ++_its->it;
                 break;
 
             case yactfr::Element::Kind::CLOCK_VALUE:
             {
                 if (firstTs || !inEventRecord) {
-                    ++_it;
+                    ++_its->it;
                     break;
                 }
 
-                auto& elem = static_cast<const yactfr::ClockValueElement&>(*_it);
+                auto& elem = static_cast<const yactfr::ClockValueElement&>(*_its->it);
 
-                firstTs = Timestamp {elem};
+                firstTs = Timestamp {
+                    elem.cycles(), _metadata->cyclesToNsConverter(elem.clockType())
+                };
 
                 const auto erProp = std::forward<GetProcFuncT>(getProcFuncT)(*firstTs);
 
                 if (erProp == prop) {
                     indexInPacket = curIndex;
-                    _it = _endIt;
+                    _its->it = _its->endIt;
                 } else if (erProp > prop) {
                     // we're looking for the previous one
                     if (curIndex == 0) {
@@ -599,9 +853,9 @@ private:
                     }
 
                     indexInPacket = curIndex - 1;
-                    _it = _endIt;
+                    _its->it = _its->endIt;
                 } else {
-                    ++_it;
+                    ++_its->it;
                 }
 
                 break;
@@ -610,11 +864,11 @@ private:
             case yactfr::Element::Kind::EVENT_RECORD_END:
                 inEventRecord = false;
                 ++curIndex;
-                ++_it;
+                ++_its->it;
                 break;
 
             default:
-                ++_it;
+                ++_its->it;
                 break;
             }
         }
@@ -630,18 +884,36 @@ private:
 private:
     const PacketIndexEntry * const _indexEntry;
     const Metadata * const _metadata;
-    yactfr::DataSource::UP _dataSrc;
+
+    const FileHandlesAcquirer _acquireFileHandles;
     std::unique_ptr<MemoryMappedFile> _mmapFile;
-    yactfr::ElementSequenceIterator _it;
-    yactfr::ElementSequenceIterator _endIt;
+
+    // `nullptr` when no `_ItsGuard` exists (after construction)
+    std::unique_ptr<_Its> _its;
+
+    // number of existing `_ItsGuard` objects
+    Size _itsGuardCount = 0;
+
     PacketCheckpoints _checkpoints;
     _RegionCache _preambleRegionCache;
     _RegionCache _curRegionCache;
     _EventRecordCache _curEventRecordCache;
-    _RegionCache _lastRegionCache;
-    _EventRecordCache _lastEventRecordCache;
-    LruCache<Index, PacketRegion::SP> _lruRegionCache;
-    const Size _eventRecordCacheMaxSize = 500;
+
+    // other windows, most recently used first
+    std::list<_Window> _otherWindows;
+
+    Cache<Index, PacketRegion::SP> _offsetRegionCache;
+    const PacketCacheConfig _cacheConfig;
+
+    // size of each event record if they all have the same static size
+    boost::optional<DataSize> _eventRecordStaticSize;
+
+    // last element packet region which regionAtOffsetInPacketBits() created
+    PacketRegion::SP _lastArrayElemRegion;
+
+    // `boost::none` when the layout cannot make a template
+    std::map<_ErLayoutTemplateKey,
+             boost::optional<_ErLayoutTemplate>> _erLayoutTemplates;
     const DataSize _preambleSize;
 };
 
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <sstream>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <yactfr/data-block.hpp>
+
+#include "pread-data-source-factory.hpp"
+#include "io-error.hpp"
+#include "stats.hpp"
+
+namespace jacques {
+
+namespace {
+
+/*
+ * Data source of a `PreadDataSourceFactory`: see its description.
+ *
+ * The factory keeps the file descriptor open as long as it exists,
+ * and an element sequence keeps its factory.
+ */
+class PreadDataSource :
+    public yactfr::DataSource
+{
+public:
+    explicit PreadDataSource(const boost::filesystem::path& path, int fd,
+                             Size fileSize, Size bufSize,
+                             bool readAheadOnThread);
+    ~PreadDataSource();
+
+private:
+    struct _FreeDeleter
+    {
+        void operator()(std::uint8_t * const data) const noexcept
+        {
+            std::free(data);
+        }
+    };
+
+    struct _Buffer
+    {
+        std::unique_ptr<std::uint8_t, _FreeDeleter> data;
+        Size capacity = 0;
+        Index offset = 0;
+        Size size = 0;
+    };
+
+private:
+    boost::optional<yactfr::DataBlock> _data(Index offset, Size minSize) override;
+    void _fill(Index offset, Size minSize);
+    bool _tryUseReadAhead(Index offset, Size minSize);
+    void _readAhead();
+    void _ensureCapacity(_Buffer& buf, Size capacity);
+    Size _read(std::uint8_t *data, Index offset, Size size) const;
+
+private:
+    const boost::filesystem::path _path;
+    const int _fd;
+    const Size _fileSize;
+    const Size _alignment;
+    const Size _bufSize;
+    const bool _readAheadOnThread;
+    _Buffer _curBuf;
+
+    // read ahead buffer and its pending read (background thread)
+    _Buffer _nextBuf;
+    std::future<Size> _nextBufRead;
+};
+
+PreadDataSource::PreadDataSource(const boost::filesystem::path& path,
+                                 const int fd, const Size fileSize,
+                                 const Size bufSize,
+                                 const bool readAheadOnThread) :
+    _path {path},
+    _fd {fd},
+    _fileSize {fileSize},
+    _alignment {static_cast<Size>(sysconf(_SC_PAGE_SIZE))},
+    _bufSize {(bufSize + _alignment - 1) / _alignment * _alignment},
+    _readAheadOnThread {readAheadOnThread}
+{
+    assert(_alignment >= 1);
+    assert(_bufSize > 0);
+}
+
+PreadDataSource::~PreadDataSource()
+{
+    if (_nextBufRead.valid()) {
+        // the background read uses `_nextBuf`: wait for it
+        _nextBufRead.wait();
+    }
+}
+
+boost::optional<yactfr::DataBlock> PreadDataSource::_data(const Index offset,
+                                                          const Size minSize)
+{
+    if (offset + minSize > _fileSize) {
+        return boost::none;
+    }
+
+    if (offset < _curBuf.offset ||
+            offset + minSize > _curBuf.offset + _curBuf.size) {
+        this->_fill(offset, minSize);
+    }
+
+    const auto offsetInBuf = offset - _curBuf.offset;
+
+    return yactfr::DataBlock {
+        _curBuf.data.get() + offsetInBuf, _curBuf.size - offsetInBuf
+    };
+}
+
+void PreadDataSource::_fill(const Index offset, const Size minSize)
+{
+    if (!this->_tryUseReadAhead(offset, minSize)) {
+        const auto alignedOffset = offset / _alignment * _alignment;
+        const auto minBufSize = (offset - alignedOffset + minSize +
+                                 _alignment - 1) / _alignment * _alignment;
+        const auto size = std::max(_bufSize, minBufSize);
+
+        this->_ensureCapacity(_curBuf, size);
+        _curBuf.offset = alignedOffset;
+        _curBuf.size = this->_read(_curBuf.data.get(), alignedOffset, size);
+        stats::inc(stats::Counter::PREAD_READS);
+    }
+
+    assert(offset >= _curBuf.offset);
+    assert(offset + minSize <= _curBuf.offset + _curBuf.size);
+    this->_readAhead();
+}
+
+bool PreadDataSource::_tryUseReadAhead(const Index offset, const Size minSize)
+{
+    if (!_nextBufRead.valid()) {
+        return false;
+    }
+
+    // rethrows the I/O error of the background read, if any
+    _nextBuf.size = _nextBufRead.get();
+
+    if (offset < _nextBuf.offset ||
+            offset + minSize > _nextBuf.offset + _nextBuf.size) {
+        // not sequential
+        return false;
+    }
+
+    std::swap(_curBuf, _nextBuf);
+    stats::inc(stats::Counter::PREAD_READ_AHEAD_HITS);
+    return true;
+}
+
+void PreadDataSource::_readAhead()
+{
+    const auto nextOffset = _curBuf.offset + _curBuf.size;
+
+    if (nextOffset >= _fileSize) {
+        return;
+    }
+
+    if (!_readAheadOnThread) {
+        (void) posix_fadvise(_fd, static_cast<off_t>(nextOffset),
+                             static_cast<off_t>(_bufSize),
+                             POSIX_FADV_WILLNEED);
+        return;
+    }
+
+    assert(!_nextBufRead.valid());
+    this->_ensureCapacity(_nextBuf, _bufSize);
+    _nextBuf.offset = nextOffset;
+    _nextBuf.size = 0;
+    _nextBufRead = std::async(std::launch::async, [this, nextOffset]() {
+        return this->_read(_nextBuf.data.get(), nextOffset, _bufSize);
+    });
+}
+
+void PreadDataSource::_ensureCapacity(_Buffer& buf, const Size capacity)
+{
+    if (buf.capacity >= capacity) {
+        return;
+    }
+
+    void *data;
+
+    if (posix_memalign(&data, _alignment, capacity) != 0) {
+        throw std::bad_alloc {};
+    }
+
+    buf.data.reset(static_cast<std::uint8_t *>(data));
+    buf.capacity = capacity;
+    buf.size = 0;
+}
+
+Size PreadDataSource::_read(std::uint8_t * const data, const Index offset,
+                            const Size size) const
+{
+    const auto readSize = std::min(size, _fileSize - offset);
+    Size doneSize = 0;
+
+    while (doneSize < readSize) {
+        const auto ret = pread(_fd, data + doneSize,
+                               static_cast<size_t>(readSize - doneSize),
+                               static_cast<off_t>(offset + doneSize));
+
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            std::ostringstream ss;
+
+            ss << "Cannot read " << (readSize - doneSize) <<
+                  " bytes at offset " << (offset + doneSize) << ".";
+            throw IOError {_path, ss.str()};
+        }
+
+        if (ret == 0) {
+            // file is shorter than expected
+            break;
+        }
+
+        doneSize += static_cast<Size>(ret);
+    }
+
+    return doneSize;
+}
+
+} // namespace
+
+PreadDataSourceFactory::PreadDataSourceFactory(const boost::filesystem::path& path,
+                                               const Size bufSize,
+                                               const bool readAheadOnThread) :
+    _path {path},
+    _bufSize {bufSize},
+    _readAheadOnThread {readAheadOnThread},
+    _fileSize {boost::filesystem::file_size(path)}
+{
+    _fd = open(path.string().c_str(), O_RDONLY);
+
+    if (_fd < 0) {
+        throw IOError {path, "Cannot open file."};
+    }
+
+    // we read sequentially, and we read ahead ourselves
+    (void) posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+}
+
+PreadDataSourceFactory::~PreadDataSourceFactory()
+{
+    (void) close(_fd);
+}
+
+yactfr::DataSource::UP PreadDataSourceFactory::_createDataSource()
+{
+    return std::make_unique<PreadDataSource>(_path, _fd, _fileSize,
+                                             _bufSize, _readAheadOnThread);
+}
+
+} // namespace jacques
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_PREAD_DATA_SOURCE_FACTORY_HPP
+#define _JACQUES_PREAD_DATA_SOURCE_FACTORY_HPP
+
+#include <boost/filesystem.hpp>
+#include <yactfr/data-source-factory.hpp>
+#include <yactfr/data-source.hpp>
+
+#include "aliases.hpp"
+
+namespace jacques {
+
+/*
+ * Data source factory which reads a file with `pread()` instead of
+ * memory-mapping it.
+ *
+ * Each data source reads `bufSize` bytes at a time, from an offset
+ * aligned to the page size, into a buffer aligned to the page size.
+ * After each read, it reads ahead the following `bufSize` bytes:
+ *
+ * * If `readAheadOnThread` is false, it only asks the kernel to do so
+ *   (`POSIX_FADV_WILLNEED`).
+ *
+ * * Otherwise, it reads them on a background thread into a second
+ *   buffer, which becomes the current one if the next request is
+ *   within it.
+ *
+ * This gives predictable sequential throughput on storage where page
+ * faults are expensive (network file systems, for example): a page
+ * fault stalls the decoder for each page, while a single large read
+ * fetches many pages at once.
+ */
+class PreadDataSourceFactory :
+    public yactfr::DataSourceFactory
+{
+public:
+    explicit PreadDataSourceFactory(const boost::filesystem::path& path,
+                                    Size bufSize = 8 << 20,
+                                    bool readAheadOnThread = false);
+    ~PreadDataSourceFactory();
+
+private:
+    yactfr::DataSource::UP _createDataSource() override;
+
+private:
+    const boost::filesystem::path _path;
+    const Size _bufSize;
+    const bool _readAheadOnThread;
+    Size _fileSize;
+    int _fd;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_PREAD_DATA_SOURCE_FACTORY_HPP
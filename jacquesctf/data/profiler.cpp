@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cstdlib>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <boost/filesystem.hpp>
+
+#include "profiler.hpp"
+#include "io-error.hpp"
+
+namespace jacques {
+namespace profiler {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct RecordedSpan
+{
+    const char *name;
+    unsigned long long beginUs;
+    unsigned long long durUs;
+    Index threadId;
+};
+
+struct ThreadSpans;
+
+/*
+ * Registry of the live thread span buffers, and spans of the threads
+ * which exited.
+ */
+struct Registry
+{
+    std::mutex mutex;
+    std::unordered_set<ThreadSpans *> threadSpans;
+    std::vector<RecordedSpan> exitedSpans;
+    Index nextThreadId = 1;
+    Clock::time_point initTime;
+    std::string path;
+};
+
+Registry& registry()
+{
+    // never destroyed: threads can exit during static destruction
+    static auto reg = new Registry;
+
+    return *reg;
+}
+
+// span buffer of a single thread: only this thread appends to it
+struct ThreadSpans
+{
+    ThreadSpans()
+    {
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock {reg.mutex};
+
+        threadId = reg.nextThreadId++;
+        reg.threadSpans.insert(this);
+    }
+
+    ~ThreadSpans()
+    {
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock {reg.mutex};
+
+        reg.exitedSpans.insert(std::end(reg.exitedSpans),
+                               std::begin(spans), std::end(spans));
+        reg.threadSpans.erase(this);
+    }
+
+    // protects `spans` against finish()
+    std::mutex mutex;
+    std::vector<RecordedSpan> spans;
+    Index threadId;
+};
+
+thread_local ThreadSpans threadSpans;
+
+void writeSpan(std::ostream& os, const RecordedSpan& span, const bool isFirst)
+{
+    if (!isFirst) {
+        os << ",\n";
+    }
+
+    os << "{\"name\":\"";
+
+    for (auto ch = span.name; *ch; ++ch) {
+        if (*ch == '"' || *ch == '\\') {
+            os << '\\';
+        }
+
+        os << *ch;
+    }
+
+    os << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << span.threadId <<
+          ",\"ts\":" << span.beginUs << ",\"dur\":" << span.durUs << "}";
+}
+
+} // namespace
+
+namespace internal {
+
+bool isEnabled = false;
+
+unsigned long long nowUs() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                                 registry().initTime).count();
+}
+
+void addSpan(const char * const name, const unsigned long long beginUs,
+             const unsigned long long endUs)
+{
+    std::lock_guard<std::mutex> lock {threadSpans.mutex};
+
+    threadSpans.spans.push_back({name, beginUs, endUs - beginUs,
+                                 threadSpans.threadId});
+}
+
+} // namespace internal
+
+void init()
+{
+    const auto path = std::getenv("JACQUES_PROFILE");
+
+    if (!path || *path == '\0') {
+        return;
+    }
+
+    auto& reg = registry();
+
+    reg.path = path;
+    reg.initTime = Clock::now();
+    internal::isEnabled = true;
+}
+
+void finish()
+{
+    if (!internal::isEnabled) {
+        return;
+    }
+
+    internal::isEnabled = false;
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock {reg.mutex};
+    std::ofstream os {reg.path};
+
+    if (!os) {
+        throw IOError {reg.path, "Cannot open profile file."};
+    }
+
+    bool isFirst = true;
+
+    os << "{\"traceEvents\":[\n";
+
+    for (const auto& span : reg.exitedSpans) {
+        writeSpan(os, span, isFirst);
+        isFirst = false;
+    }
+
+    for (const auto threadSpans : reg.threadSpans) {
+        std::lock_guard<std::mutex> threadLock {threadSpans->mutex};
+
+        for (const auto& span : threadSpans->spans) {
+            writeSpan(os, span, isFirst);
+            isFirst = false;
+        }
+    }
+
+    os << "\n]}\n";
+}
+
+} // namespace profiler
+} // namespace jacques
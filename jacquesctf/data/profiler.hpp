@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_PROFILER_HPP
+#define _JACQUES_PROFILER_HPP
+
+#include <boost/core/noncopyable.hpp>
+
+#include "aliases.hpp"
+
+namespace jacques {
+namespace profiler {
+
+/*
+ * Scoped span profiler.
+ *
+ * When the `JACQUES_PROFILE` environment variable is set to a file
+ * path at init() time, each `Span` object records its name, its
+ * thread, its beginning time, and its duration. finish() writes all
+ * the recorded spans to this file as Chrome trace events (JSON) which
+ * any trace event viewer can open.
+ *
+ * When profiling is disabled, creating a span only tests a flag.
+ */
+
+namespace internal {
+
+extern bool isEnabled;
+
+// current time (µs) since init()
+unsigned long long nowUs() noexcept;
+
+void addSpan(const char *name, unsigned long long beginUs,
+             unsigned long long endUs);
+
+} // namespace internal
+
+// enables profiling if `JACQUES_PROFILE` is set
+void init();
+
+// writes the recorded spans, if profiling is enabled
+void finish();
+
+static inline bool isEnabled() noexcept
+{
+    return internal::isEnabled;
+}
+
+/*
+ * Records a span named `name` from its construction to its
+ * destruction. `name` must remain valid until finish().
+ */
+class Span :
+    boost::noncopyable
+{
+public:
+    explicit Span(const char * const name) noexcept :
+        _name {name}
+    {
+        if (internal::isEnabled) {
+            _beginUs = internal::nowUs();
+        }
+    }
+
+    ~Span()
+    {
+        if (internal::isEnabled) {
+            internal::addSpan(_name, _beginUs, internal::nowUs());
+        }
+    }
+
+private:
+    const char * const _name;
+    unsigned long long _beginUs = 0;
+};
+
+} // namespace profiler
+} // namespace jacques
+
+#endif // _JACQUES_PROFILER_HPP
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_SEARCH_PROGRESS_HPP
+#define _JACQUES_SEARCH_PROGRESS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <boost/optional.hpp>
+#include <boost/core/noncopyable.hpp>
+
+#include "aliases.hpp"
+#include "data-size.hpp"
+#include "packet-index-entry.hpp"
+
+namespace jacques {
+
+/*
+ * Progress and cancellation token of a long-running search.
+ *
+ * The searching threads call start() once, and then packetScanned()
+ * for each scanned packet; they stop scanning as soon as isCanceled()
+ * returns true, which they check between packets. Any other thread can
+ * call cancel() and read the progress at any time.
+ */
+class SearchProgress :
+    boost::noncopyable
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+public:
+    // the search is about to scan `packetCount` packets totalling `size`
+    void start(const Size packetCount, const DataSize& size) noexcept
+    {
+        _packetCount = packetCount;
+        _sizeBytes = size.bytes();
+        _scannedPacketCount = 0;
+        _scannedSizeBytes = 0;
+        _startTime = Clock::now().time_since_epoch().count();
+    }
+
+    void packetScanned(const PacketIndexEntry& entry) noexcept
+    {
+        ++_scannedPacketCount;
+        _scannedSizeBytes += entry.effectiveTotalSize().bytes();
+    }
+
+    void cancel() noexcept
+    {
+        _isCanceled = true;
+    }
+
+    bool isCanceled() const noexcept
+    {
+        return _isCanceled.load(std::memory_order_relaxed);
+    }
+
+    bool isStarted() const noexcept
+    {
+        return _startTime != 0;
+    }
+
+    Size packetCount() const noexcept
+    {
+        return _packetCount;
+    }
+
+    Size scannedPacketCount() const noexcept
+    {
+        return _scannedPacketCount;
+    }
+
+    DataSize scannedSize() const noexcept
+    {
+        return DataSize::fromBytes(_scannedSizeBytes);
+    }
+
+    // scanned bytes per second since start()
+    double bytesPerSecond() const noexcept
+    {
+        const auto elapsedSec = this->_elapsedSec();
+
+        if (elapsedSec <= 0.) {
+            return 0.;
+        }
+
+        return static_cast<double>(_scannedSizeBytes) / elapsedSec;
+    }
+
+    // estimated remaining time, in seconds, at the current rate
+    boost::optional<double> etaSec() const noexcept
+    {
+        const auto rate = this->bytesPerSecond();
+
+        if (rate <= 0.) {
+            return boost::none;
+        }
+
+        const Size scannedSizeBytes = _scannedSizeBytes;
+
+        if (scannedSizeBytes >= _sizeBytes) {
+            return 0.;
+        }
+
+        return static_cast<double>(_sizeBytes - scannedSizeBytes) / rate;
+    }
+
+private:
+    double _elapsedSec() const noexcept
+    {
+        if (!this->isStarted()) {
+            return 0.;
+        }
+
+        const Clock::duration elapsed {
+            Clock::now().time_since_epoch().count() - _startTime
+        };
+
+        return std::chrono::duration<double> {elapsed}.count();
+    }
+
+private:
+    std::atomic<Size> _packetCount {0};
+    std::atomic<Size> _sizeBytes {0};
+    std::atomic<Size> _scannedPacketCount {0};
+    std::atomic<Size> _scannedSizeBytes {0};
+
+    // `Clock::time_point` tick count, 0 until start()
+    std::atomic<Clock::rep> _startTime {0};
+
+    std::atomic_bool _isCanceled {false};
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_SEARCH_PROGRESS_HPP
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cstdlib>
+#include <mutex>
+#include <unordered_set>
+
+#include "stats.hpp"
+#include "utils.hpp"
+
+namespace jacques {
+namespace stats {
+namespace {
+
+/*
+ * Registry of the live thread counter blocks, and accumulated values
+ * of the blocks of the threads which exited.
+ */
+struct Registry
+{
+    std::mutex mutex;
+    std::unordered_set<const internal::ThreadCounters *> threadCounters;
+    std::array<Size, counterCount> exitedValues {};
+};
+
+Registry& registry()
+{
+    // never destroyed: threads can exit during static destruction
+    static auto reg = new Registry;
+
+    return *reg;
+}
+
+} // namespace
+
+namespace internal {
+
+thread_local ThreadCounters threadCounters;
+
+ThreadCounters::ThreadCounters()
+{
+    for (auto& value : values) {
+        value.store(0, std::memory_order_relaxed);
+    }
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock {reg.mutex};
+
+    reg.threadCounters.insert(this);
+}
+
+ThreadCounters::~ThreadCounters()
+{
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock {reg.mutex};
+
+    for (Index index = 0; index < counterCount; ++index) {
+        reg.exitedValues[index] += values[index].load(std::memory_order_relaxed);
+    }
+
+    reg.threadCounters.erase(this);
+}
+
+} // namespace internal
+
+Size value(const Counter counter)
+{
+    const auto index = static_cast<Index>(counter);
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock {reg.mutex};
+    auto value = reg.exitedValues[index];
+
+    for (const auto threadCounters : reg.threadCounters) {
+        value += threadCounters->values[index].load(std::memory_order_relaxed);
+    }
+
+    return value;
+}
+
+const char *name(const Counter counter)
+{
+    switch (counter) {
+    case Counter::PACKETS_CREATED:
+        return "Packets created";
+
+    case Counter::PACKET_HITS:
+        return "Packet hits";
+
+    case Counter::CUR_REGION_CACHE_HITS:
+        return "Current region cache hits";
+
+    case Counter::PREAMBLE_REGION_CACHE_HITS:
+        return "Preamble region cache hits";
+
+    case Counter::OTHER_WINDOW_REGION_CACHE_HITS:
+        return "Other window region cache hits";
+
+    case Counter::REGION_CACHE_MISSES:
+        return "Region cache misses";
+
+    case Counter::CUR_EVENT_RECORD_CACHE_HITS:
+        return "Current event record cache hits";
+
+    case Counter::OTHER_WINDOW_EVENT_RECORD_CACHE_HITS:
+        return "Other window event record cache hits";
+
+    case Counter::EVENT_RECORD_CACHE_MISSES:
+        return "Event record cache misses";
+
+    case Counter::OFFSET_REGION_CACHE_HITS:
+        return "Offset region cache hits";
+
+    case Counter::OFFSET_REGION_CACHE_MISSES:
+        return "Offset region cache misses";
+
+    case Counter::CHECKPOINTS_RESTORED:
+        return "Checkpoints restored";
+
+    case Counter::SEEK_DECODED_ELEMENTS:
+        return "Elements decoded to seek";
+
+    case Counter::STATIC_SIZE_SEEKS:
+        return "Static size seeks";
+
+    case Counter::CACHED_REGIONS:
+        return "Regions cached";
+
+    case Counter::TEMPLATE_EVENT_RECORDS:
+        return "Event records cached from a template";
+
+    case Counter::ARRAY_ELEM_REGIONS:
+        return "Array element regions created";
+
+    case Counter::FILE_HANDLES_OPENED:
+        return "File handles opened";
+
+    case Counter::FILE_HANDLES_CLOSED:
+        return "File handles closed";
+
+    case Counter::PREAD_READS:
+        return "pread() data source reads";
+
+    case Counter::PREAD_READ_AHEAD_HITS:
+        return "pread() data source read ahead hits";
+
+    default:
+        std::abort();
+    }
+}
+
+void print(std::ostream& os)
+{
+    for (Index index = 0; index < counterCount; ++index) {
+        const auto counter = static_cast<Counter>(index);
+
+        os << name(counter) << ": " <<
+              utils::sepNumber(value(counter), ',') <<
+              std::endl;
+    }
+}
+
+} // namespace stats
+} // namespace jacques
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_STATS_HPP
+#define _JACQUES_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <ostream>
+
+#include "aliases.hpp"
+
+namespace jacques {
+namespace stats {
+
+/*
+ * Data layer instrumentation counters.
+ *
+ * Each thread increments its own block of counters (relaxed atomic
+ * operations on a thread-local block, therefore without contention),
+ * and value() sums the blocks of all the threads, including the ones
+ * which exited, at any time.
+ */
+enum class Counter
+{
+    // packet objects created by DataStreamFile::packetAtIndex()
+    PACKETS_CREATED,
+
+    // DataStreamFile::packetAtIndex() calls returning an existing packet
+    PACKET_HITS,
+
+    // Packet::_ensureOffsetInPacketBitsIsCached() outcomes
+    CUR_REGION_CACHE_HITS,
+    PREAMBLE_REGION_CACHE_HITS,
+    OTHER_WINDOW_REGION_CACHE_HITS,
+    REGION_CACHE_MISSES,
+
+    // Packet::_ensureEventRecordsAreCached() outcomes
+    CUR_EVENT_RECORD_CACHE_HITS,
+    OTHER_WINDOW_EVENT_RECORD_CACHE_HITS,
+    EVENT_RECORD_CACHE_MISSES,
+
+    // Packet::regionAtOffsetInPacketBits() offset region cache outcomes
+    OFFSET_REGION_CACHE_HITS,
+    OFFSET_REGION_CACHE_MISSES,
+
+    // packet checkpoints restored to decode from
+    CHECKPOINTS_RESTORED,
+
+    // elements decoded only to reach an event record or an offset
+    SEEK_DECODED_ELEMENTS,
+
+    // event records found by offset without decoding (static size)
+    STATIC_SIZE_SEEKS,
+
+    // packet regions created and added to a packet region cache
+    CACHED_REGIONS,
+
+    // event records of which the packet regions come from a layout template
+    TEMPLATE_EVENT_RECORDS,
+
+    // element packet regions created from an array packet region
+    ARRAY_ELEM_REGIONS,
+
+    // data stream file handles which the file handle pool opened/closed
+    FILE_HANDLES_OPENED,
+    FILE_HANDLES_CLOSED,
+
+    // reads of pread data sources, and reads served by read ahead
+    PREAD_READS,
+    PREAD_READ_AHEAD_HITS,
+};
+
+constexpr Size counterCount = static_cast<Size>(Counter::PREAD_READ_AHEAD_HITS) + 1;
+
+namespace internal {
+
+struct ThreadCounters
+{
+    ThreadCounters();
+    ~ThreadCounters();
+
+    std::array<std::atomic<Size>, counterCount> values;
+};
+
+extern thread_local ThreadCounters threadCounters;
+
+} // namespace internal
+
+static inline void inc(const Counter counter, const Size count = 1) noexcept
+{
+    internal::threadCounters.values[static_cast<Index>(counter)].fetch_add(count,
+                                                                           std::memory_order_relaxed);
+}
+
+// current value of `counter`, summed over all the threads
+Size value(Counter counter);
+
+// human-readable name of `counter`
+const char *name(Counter counter);
+
+// prints all the counters, one per line, to `os`
+void print(std::ostream& os);
+
+} // namespace stats
+} // namespace jacques
+
+#endif // _JACQUES_STATS_HPP
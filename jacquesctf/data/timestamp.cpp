@@ -10,51 +10,35 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cinttypes>
+#include <cstring>
 #include <limits>
+#include <algorithm>
 #include <curses.h>
 #include <time.h>
 
 #include "timestamp.hpp"
+#include "utils.hpp"
 
 namespace jacques {
 
 Timestamp::Timestamp(const unsigned long long cycles,
                      const unsigned long long frequency,
-                     long long offsetSeconds,
+                     const long long offsetSeconds,
                      const unsigned long long offsetCycles) :
-    _cycles {cycles},
-    _freq {frequency}
-{
-    assert(offsetCycles < frequency);
-
-    const auto secondsInCycles = cycles / frequency;
-    constexpr auto nsInS = 1'000'000'000ULL;
-    constexpr auto llNsInS = static_cast<long long>(nsInS);
-
-    offsetSeconds += secondsInCycles;
-
-    const auto reducedCycles = cycles - secondsInCycles * frequency;
-    constexpr auto maxUll = std::numeric_limits<unsigned long long>::max();
-    unsigned long long offsetNsPart;
-
-    if (offsetCycles + reducedCycles <= maxUll / nsInS) {
-        offsetNsPart = (offsetCycles + reducedCycles) * nsInS / frequency;
-    } else {
-        /*
-         * FIXME: There could be a 1-ns error here, because we're
-         * converting to nanoseconds two times (offset and value) and
-         * adding those results: if the (real) results were to be 45.6
-         * ns and 12.7 ns, for example, which are in fact 45 and 12
-         * because of the integer divisions, then the result should be
-         * 58 ns, not 57 ns.
-         */
-        offsetNsPart = (offsetCycles * nsInS / frequency) +
-                       (reducedCycles * nsInS / frequency);
+    Timestamp {
+        cycles,
+        CyclesToNsConverter {frequency, offsetSeconds, offsetCycles},
     }
+{
+}
 
-    _nsFromOrigin = offsetSeconds * llNsInS +
-                    static_cast<long long>(offsetNsPart);
-
+Timestamp::Timestamp(const unsigned long long cycles,
+                     const CyclesToNsConverter& converter) :
+    _cycles {cycles},
+    _freq {converter.frequency()},
+    _nsFromOrigin {converter.nsFromOrigin(cycles)}
+{
+    constexpr auto llNsInS = 1'000'000'000LL;
     time_t secondsFloor;
 
     static_assert(sizeof(time_t) >= 8, "Expecting a 64-bit time_t.");
@@ -86,13 +70,9 @@ Timestamp::Timestamp(const unsigned long long cycles,
     _weekday = static_cast<Weekday>(tm.tm_wday);
 }
 
-Timestamp::Timestamp(unsigned long long cycles,
+Timestamp::Timestamp(const unsigned long long cycles,
                      const yactfr::ClockType& clockType) :
-    Timestamp {
-        cycles, clockType.freq(),
-        clockType.offset().seconds(),
-        clockType.offset().cycles(),
-    }
+    Timestamp {cycles, CyclesToNsConverter {clockType}}
 {
 }
 
@@ -109,25 +89,53 @@ Timestamp::Timestamp(const yactfr::PacketEndClockValueElement& elem) :
 void Timestamp::format(char * const buf, const Size bufSize,
                        const TimestampFormatMode formatMode) const
 {
+    assert(bufSize > 0);
+
+    std::array<char, 64> tmpBuf;
+    auto bufAt = tmpBuf.data();
+
     switch (formatMode) {
     case TimestampFormatMode::LONG:
-        std::snprintf(buf, bufSize, "%d-%02u-%02u %02u:%02u:%02u.%09u",
-                      _year, _month, _day, _hour, _minute, _second, _ns);
-        break;
+        bufAt += utils::formatDecimal(bufAt, static_cast<long long>(_year));
+        *bufAt++ = '-';
+        bufAt += utils::formatDecimal(bufAt, static_cast<unsigned long long>(_month),
+                                      boost::none, 2);
+        *bufAt++ = '-';
+        bufAt += utils::formatDecimal(bufAt, static_cast<unsigned long long>(_day),
+                                      boost::none, 2);
+        *bufAt++ = ' ';
+
+        // fall through (time of day)
 
     case TimestampFormatMode::SHORT:
-        std::snprintf(buf, bufSize, "%02u:%02u:%02u.%09u",
-                      _hour, _minute, _second, _ns);
+        bufAt += utils::formatDecimal(bufAt, static_cast<unsigned long long>(_hour),
+                                      boost::none, 2);
+        *bufAt++ = ':';
+        bufAt += utils::formatDecimal(bufAt, static_cast<unsigned long long>(_minute),
+                                      boost::none, 2);
+        *bufAt++ = ':';
+        bufAt += utils::formatDecimal(bufAt, static_cast<unsigned long long>(_second),
+                                      boost::none, 2);
+        *bufAt++ = '.';
+        bufAt += utils::formatDecimal(bufAt, static_cast<unsigned long long>(_ns),
+                                      boost::none, 9);
         break;
 
     case TimestampFormatMode::NS_FROM_ORIGIN:
-        std::snprintf(buf, bufSize, "%lld", _nsFromOrigin);
+        bufAt += utils::formatDecimal(bufAt, _nsFromOrigin);
         break;
 
     case TimestampFormatMode::CYCLES:
-        std::snprintf(buf, bufSize, "%llu", _cycles);
+        bufAt += utils::formatDecimal(bufAt, _cycles);
         break;
     }
+
+    // truncate like snprintf() does
+    const auto len = std::min(static_cast<Size>(bufAt - tmpBuf.data()),
+                              bufSize - 1);
+
+    std::memcpy(buf, tmpBuf.data(), len);
+    buf[len] = '\0';
 }
 
 std::string Timestamp::format(const TimestampFormatMode formatMode) const
@@ -17,6 +17,7 @@
 
 #include "aliases.hpp"
 #include "duration.hpp"
+#include "cycles-to-ns-converter.hpp"
 
 namespace jacques {
 
@@ -50,6 +51,8 @@ public:
                        unsigned long long offsetCycles);
     explicit Timestamp(unsigned long long cycles,
                        const yactfr::ClockType& clockType);
+    explicit Timestamp(unsigned long long cycles,
+                       const CyclesToNsConverter& converter);
     explicit Timestamp(const yactfr::ClockValueElement& elem);
     explicit Timestamp(const yactfr::PacketEndClockValueElement& elem);
     Timestamp& operator=(const Timestamp&) = default;
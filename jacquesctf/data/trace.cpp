@@ -13,18 +13,25 @@ namespace jacques {
 
 namespace bfs = boost::filesystem;
 
-Trace::Trace(const std::vector<bfs::path>& dataStreamFilePaths)
+Trace::Trace(const std::vector<bfs::path>& dataStreamFilePaths,
+             Metadata::TextCache * const metadataTextCache,
+             FileHandlePool * const fileHandlePool,
+             const DataSourceKind dataSourceKind,
+             const PacketCacheConfig& packetCacheConfig)
 {
     assert(!dataStreamFilePaths.empty());
 
     const auto metadataPath = dataStreamFilePaths.front().parent_path() / "metadata";
 
     assert(bfs::is_regular_file(metadataPath));
-    _metadata = std::make_unique<Metadata>(metadataPath);
+    _metadata = std::make_unique<Metadata>(metadataPath, metadataTextCache);
 
     for (const auto& dsfPath : dataStreamFilePaths) {
         _dataStreamFiles.push_back(std::make_unique<DataStreamFile>(dsfPath,
-                                                                    *_metadata));
+                                                                    *_metadata,
+                                                                    fileHandlePool,
+                                                                    dataSourceKind,
+                                                                    packetCacheConfig));
     }
 }
 
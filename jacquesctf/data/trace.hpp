@@ -17,6 +17,9 @@
 #include "utils.hpp"
 #include "data-stream-file.hpp"
 #include "metadata.hpp"
+#include "file-handle-pool.hpp"
+#include "data-source-kind.hpp"
+#include "packet-cache-config.hpp"
 
 namespace jacques {
 
@@ -27,7 +30,24 @@ public:
     using DataStreamFiles = std::vector<std::unique_ptr<DataStreamFile>>;
 
 public:
-    explicit Trace(const std::vector<boost::filesystem::path>& dataStreamFilePaths);
+    /*
+     * If `metadataTextCache` is not null, the trace's metadata object
+     * shares the parsed metadata text (trace type and data type maps)
+     * of any other trace which was built with the same cache and which
+     * has an identical metadata text.
+     *
+     * If `fileHandlePool` is not null, the data stream files acquire
+     * their open handles from it (see `DataStreamFile`).
+     *
+     * `dataSourceKind` is how the data stream files read their data,
+     * and `packetCacheConfig` is the caching configuration of their
+     * packets.
+     */
+    explicit Trace(const std::vector<boost::filesystem::path>& dataStreamFilePaths,
+                   Metadata::TextCache *metadataTextCache = nullptr,
+                   FileHandlePool *fileHandlePool = nullptr,
+                   DataSourceKind dataSourceKind = DataSourceKind::MEMORY_MAPPED_FILE,
+                   const PacketCacheConfig& packetCacheConfig = PacketCacheConfig {});
 
 public:
     const Metadata& metadata() const noexcept
@@ -40,9 +60,6 @@ public:
         return _dataStreamFiles;
     }
 
-private:
-    void _createMetadata(const boost::filesystem::path& path);
-
 private:
     DataStreamFiles _dataStreamFiles;
     std::unique_ptr<Metadata> _metadata;
@@ -14,8 +14,10 @@
 #include "data-stream-file-state.hpp"
 #include "message.hpp"
 #include "search-parser.hpp"
+#include "event-record-matcher.hpp"
 #include "state.hpp"
 #include "io-error.hpp"
+#include "profiler.hpp"
 
 namespace jacques {
 
@@ -176,28 +178,15 @@ void DataStreamFileState::gotoLastPacketRegion()
     _activePacketState->gotoLastPacketRegion();
 }
 
-bool DataStreamFileState::_gotoNextEventRecordWithProperty(const std::function<bool (const EventRecord&)>& compareFunc,
-                                                           const boost::optional<Index>& initPacketIndex,
-                                                           const boost::optional<Index>& initErIndex)
+std::pair<Index, Index> DataStreamFileState::_nextEventRecordSearchStart()
 {
-    if (!_activePacketState) {
-        return false;
-    }
+    assert(_activePacketState);
 
     Index startPacketIndex = _activePacketStateIndex + 1;
-    boost::optional<Index> startErIndex = 0;
+    Index startErIndex = 0;
 
-    if (initPacketIndex) {
-        startPacketIndex = *initPacketIndex;
-    }
-
-    if (initErIndex) {
-        startErIndex = *initErIndex;
-    }
-
-    if (_activePacketState->packet().eventRecordCount() > 0 && !initPacketIndex && !initErIndex) {
+    if (_activePacketState->packet().eventRecordCount() > 0) {
         const auto currentEventRecord = _activePacketState->currentEventRecord();
-        boost::optional<Index> erIndex;
 
         if (currentEventRecord) {
             if (currentEventRecord->indexInPacket() <
@@ -217,34 +206,46 @@ bool DataStreamFileState::_gotoNextEventRecordWithProperty(const std::function<b
         }
     }
 
-    for (auto packetIndex = startPacketIndex;
-            packetIndex < _dataStreamFile->packetCount(); ++packetIndex) {
-        auto& packetState = this->_packetState(packetIndex);
-        auto& packet = packetState.packet();
+    return {startPacketIndex, startErIndex};
+}
 
-        const auto iterStartErIndex = startErIndex ? *startErIndex : 0;
+boost::optional<DataStreamFileState::SearchMatch> DataStreamFileState::_curEventRecordPosition()
+{
+    if (!_activePacketState) {
+        return boost::none;
+    }
 
-        startErIndex = boost::none;
-        assert(iterStartErIndex < packet.eventRecordCount());
+    const auto eventRecord = _activePacketState->currentEventRecord();
 
-        for (Index erIndex = iterStartErIndex; erIndex < packet.eventRecordCount(); ++erIndex) {
-            const auto& eventRecord = packet.eventRecordAtIndexInPacket(erIndex);
+    if (!eventRecord) {
+        return boost::none;
+    }
 
-            if (compareFunc(eventRecord)) {
-                const auto offsetInPacketBits = eventRecord.segment().offsetInPacketBits();
+    return SearchMatch {_activePacketStateIndex, eventRecord->indexInPacket()};
+}
 
-                this->gotoPacket(packetIndex);
-                _activePacketState->gotoPacketRegionAtOffsetInPacketBits(offsetInPacketBits);
-                return true;
-            }
-        }
+bool DataStreamFileState::_gotoEventRecord(const Index packetIndex,
+                                           const Index erIndexInPacket)
+{
+    auto& packet = this->_packetState(packetIndex).packet();
+
+    if (erIndexInPacket >= packet.eventRecordCount()) {
+        return false;
     }
 
-    return false;
+    // the event record can become invalid through `this->gotoPacket()`
+    const auto offsetInPacketBits = packet.eventRecordAtIndexInPacket(erIndexInPacket).segment().offsetInPacketBits();
+
+    this->gotoPacket(packetIndex);
+    _activePacketState->gotoPacketRegionAtOffsetInPacketBits(offsetInPacketBits);
+    return true;
 }
 
-bool DataStreamFileState::search(const SearchQuery& query)
+bool DataStreamFileState::search(const SearchQuery& query,
+                                 SearchProgress * const progress)
 {
+    const profiler::Span span {"DataStreamFileState::search"};
+
     if (const auto sQuery = dynamic_cast<const PacketIndexSearchQuery *>(&query)) {
         long long reqIndex;
 
@@ -385,34 +386,27 @@ bool DataStreamFileState::search(const SearchQuery& query)
         }
 
         return true;
-    } else if (const auto sQuery = dynamic_cast<const EventRecordTypeIdSearchQuery *>(&query)) {
-        if (sQuery->value() < 0) {
+    } else if (EventRecordMatcher::isSupported(query)) {
+        if (!_activePacketState) {
             return false;
         }
 
-        const auto compareFunc = [sQuery](const EventRecord& eventRecord) {
-            if (!eventRecord.type()) {
-                return false;
-            }
-
-            return eventRecord.type()->id() == static_cast<Index>(sQuery->value());
-        };
+        const EventRecordMatcher matcher {query, _dataStreamFile->metadata()};
 
-        return this->_gotoNextEventRecordWithProperty(compareFunc);
-    } else if (const auto sQuery = dynamic_cast<const EventRecordTypeNameSearchQuery *>(&query)) {
-        const auto compareFunc = [sQuery](const EventRecord& eventRecord) {
-            if (!eventRecord.type()) {
-                return false;
-            }
+        if (matcher.isEmpty()) {
+            return false;
+        }
 
-            if (!eventRecord.type()->name()) {
-                return false;
-            }
+        const auto start = this->_nextEventRecordSearchStart();
+        const auto match = _dataStreamFile->findEventRecord(start.first,
+                                                            start.second,
+                                                            matcher, progress);
 
-            return sQuery->matches(*eventRecord.type()->name());
-        };
+        if (!match) {
+            return false;
+        }
 
-        return this->_gotoNextEventRecordWithProperty(compareFunc);
+        return this->_gotoEventRecord(match->first, match->second);
     } else if (const auto sQuery = dynamic_cast<const TimestampSearchQuery *>(&query)) {
         if (!_activePacketState) {
             return false;
@@ -497,6 +491,106 @@ bool DataStreamFileState::search(const SearchQuery& query)
     return false;
 }
 
+bool DataStreamFileState::searchAll(const SearchQuery& query,
+                                    SearchProgress * const progress)
+{
+    const profiler::Span span {"DataStreamFileState::searchAll"};
+
+    this->clearSearchMatches();
+
+    if (!EventRecordMatcher::isSupported(query)) {
+        return false;
+    }
+
+    const EventRecordMatcher matcher {query, _dataStreamFile->metadata()};
+
+    if (matcher.isEmpty()) {
+        return false;
+    }
+
+    // empty if canceled
+    _searchMatches = _dataStreamFile->findEventRecords(matcher, progress);
+    return !_searchMatches.empty();
+}
+
+void DataStreamFileState::clearSearchMatches()
+{
+    _searchMatches.clear();
+    _searchMatches.shrink_to_fit();
+    _curSearchMatchIndex = boost::none;
+}
+
+bool DataStreamFileState::gotoSearchMatch(const Index index)
+{
+    if (index >= _searchMatches.size()) {
+        return false;
+    }
+
+    const auto& match = _searchMatches[index];
+
+    // set before moving: observers can read it
+    _curSearchMatchIndex = index;
+    return this->_gotoEventRecord(match.first, match.second);
+}
+
+bool DataStreamFileState::gotoPreviousSearchMatch()
+{
+    if (_searchMatches.empty() || !_activePacketState) {
+        return false;
+    }
+
+    const auto pos = this->_curEventRecordPosition();
+
+    if (_curSearchMatchIndex && pos &&
+            *pos == _searchMatches[*_curSearchMatchIndex]) {
+        // still at the current match: step
+        if (*_curSearchMatchIndex == 0) {
+            return false;
+        }
+
+        return this->gotoSearchMatch(*_curSearchMatchIndex - 1);
+    }
+
+    // moved since: find the last match before the current position
+    const auto it = std::lower_bound(std::begin(_searchMatches),
+                                     std::end(_searchMatches),
+                                     pos ? *pos :
+                                     SearchMatch {_activePacketStateIndex, 0});
+
+    if (it == std::begin(_searchMatches)) {
+        return false;
+    }
+
+    return this->gotoSearchMatch(it - std::begin(_searchMatches) - 1);
+}
+
+bool DataStreamFileState::gotoNextSearchMatch()
+{
+    if (_searchMatches.empty() || !_activePacketState) {
+        return false;
+    }
+
+    const auto pos = this->_curEventRecordPosition();
+
+    if (_curSearchMatchIndex && pos &&
+            *pos == _searchMatches[*_curSearchMatchIndex]) {
+        // still at the current match: step
+        return this->gotoSearchMatch(*_curSearchMatchIndex + 1);
+    }
+
+    // moved since: find the first match after the current position
+    const auto start = this->_nextEventRecordSearchStart();
+    const auto it = std::lower_bound(std::begin(_searchMatches),
+                                     std::end(_searchMatches),
+                                     SearchMatch {start.first, start.second});
+
+    if (it == std::end(_searchMatches)) {
+        return false;
+    }
+
+    return this->gotoSearchMatch(it - std::begin(_searchMatches));
+}
+
 void DataStreamFileState::analyzeAllPackets(PacketCheckpointsBuildListener& buildListener)
 {
     for (auto& pktIndexEntry : _dataStreamFile->packetIndexEntries()) {
@@ -9,6 +9,7 @@
 #define _JACQUES_DATA_STREAM_FILE_STATE_HPP
 
 #include <vector>
+#include <utility>
 #include <boost/filesystem.hpp>
 #include <boost/optional.hpp>
 #include <yactfr/memory-mapped-file-view-factory.hpp>
@@ -22,6 +23,7 @@
 #include "event-record.hpp"
 #include "metadata.hpp"
 #include "packet-state.hpp"
+#include "search-progress.hpp"
 
 namespace jacques {
 
@@ -30,6 +32,12 @@ class State;
 class DataStreamFileState :
     boost::noncopyable
 {
+    friend class State;
+
+public:
+    // packet index and event record index within this packet
+    using SearchMatch = std::pair<Index, Index>;
+
 public:
     explicit DataStreamFileState(State& state,
                                  DataStreamFile& dataStreamFile,
@@ -44,7 +52,14 @@ public:
     void gotoNextPacketRegion();
     void gotoPacketContext();
     void gotoLastPacketRegion();
-    bool search(const SearchQuery& query);
+    bool search(const SearchQuery& query,
+                SearchProgress *progress = nullptr);
+    bool searchAll(const SearchQuery& query,
+                   SearchProgress *progress = nullptr);
+    void clearSearchMatches();
+    bool gotoSearchMatch(Index index);
+    bool gotoPreviousSearchMatch();
+    bool gotoNextSearchMatch();
     void analyzeAllPackets(PacketCheckpointsBuildListener& buildListener);
 
     DataStreamFile& dataStreamFile() noexcept
@@ -132,6 +147,18 @@ public:
         return _dataStreamFile->metadata();
     }
 
+    // matches of the last searchAll() call, in data stream file order
+    const std::vector<SearchMatch>& searchMatches() const noexcept
+    {
+        return _searchMatches;
+    }
+
+    // index of the current search match within searchMatches()
+    const boost::optional<Index>& curSearchMatchIndex() const noexcept
+    {
+        return _curSearchMatchIndex;
+    }
+
     State& state() noexcept
     {
         return *_state;
@@ -145,9 +172,9 @@ public:
 private:
     PacketState& _packetState(Index index);
     void _gotoPacket(Index index);
-    bool _gotoNextEventRecordWithProperty(const std::function<bool (const EventRecord&)>& compareFunc,
-                                          const boost::optional<Index>& initPacketIndex = boost::none,
-                                          const boost::optional<Index>& initErIndex = boost::none);
+    std::pair<Index, Index> _nextEventRecordSearchStart();
+    boost::optional<SearchMatch> _curEventRecordPosition();
+    bool _gotoEventRecord(Index packetIndex, Index erIndexInPacket);
 
 private:
     State * const _state;
@@ -156,6 +183,8 @@ private:
     std::vector<std::unique_ptr<PacketState>> _packetStates;
     std::shared_ptr<PacketCheckpointsBuildListener> _packetCheckpointsBuildListener;
     DataStreamFile * const _dataStreamFile;
+    std::vector<SearchMatch> _searchMatches;
+    boost::optional<Index> _curSearchMatchIndex;
 };
 
 } // namespace jacques
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+
+#include "event-record-matcher.hpp"
+
+namespace jacques {
+
+EventRecordMatcher::EventRecordMatcher(const SearchQuery& query,
+                                       const Metadata& metadata)
+{
+    assert(EventRecordMatcher::isSupported(query));
+
+    if (const auto sQuery = dynamic_cast<const EventRecordTypeNameSearchQuery *>(&query)) {
+        _ertNameMatcher = std::make_unique<const EventRecordTypeNameMatcher>(*sQuery,
+                                                                             *metadata.traceType());
+    } else if (const auto sQuery = dynamic_cast<const EventRecordTypeIdSearchQuery *>(&query)) {
+        if (sQuery->value() >= 0) {
+            _ertId = static_cast<yactfr::TypeId>(sQuery->value());
+        }
+    } else if (const auto sQuery = dynamic_cast<const FieldValueSearchQuery *>(&query)) {
+        _fieldValueMatcher = std::make_unique<const FieldValueMatcher>(*sQuery,
+                                                                       metadata);
+    }
+}
+
+bool EventRecordMatcher::isSupported(const SearchQuery& query)
+{
+    return dynamic_cast<const EventRecordTypeNameSearchQuery *>(&query) ||
+           dynamic_cast<const EventRecordTypeIdSearchQuery *>(&query) ||
+           dynamic_cast<const FieldValueSearchQuery *>(&query);
+}
+
+} // namespace jacques
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_EVENT_RECORD_MATCHER_HPP
+#define _JACQUES_EVENT_RECORD_MATCHER_HPP
+
+#include <string>
+#include <memory>
+#include <boost/optional.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <yactfr/metadata/fwd.hpp>
+#include <yactfr/metadata/event-record-type.hpp>
+
+#include "aliases.hpp"
+#include "metadata.hpp"
+#include "search-parser.hpp"
+#include "event-record-type-name-matcher.hpp"
+#include "field-value-matcher.hpp"
+
+namespace jacques {
+
+/*
+ * Event record matcher built from a search query which targets
+ * event record properties: event record type name, event record type
+ * ID, or field value.
+ *
+ * This is what DataStreamFile::findEventRecord() and
+ * DataStreamFile::findEventRecords() expect.
+ */
+class EventRecordMatcher :
+    boost::noncopyable
+{
+public:
+    // `query` must satisfy isSupported()
+    explicit EventRecordMatcher(const SearchQuery& query,
+                                const Metadata& metadata);
+
+    static bool isSupported(const SearchQuery& query);
+
+    // true if no event record can ever match
+    bool isEmpty() const noexcept
+    {
+        if (_fieldValueMatcher) {
+            return _fieldValueMatcher->isEmpty();
+        }
+
+        return !_ertNameMatcher && !_ertId;
+    }
+
+    bool eventRecordTypeMatches(const yactfr::EventRecordType& eventRecordType) const
+    {
+        if (_ertNameMatcher) {
+            return _ertNameMatcher->matches(eventRecordType);
+        }
+
+        return _ertId && eventRecordType.id() == *_ertId;
+    }
+
+    bool hasDataType(const yactfr::DataType& dataType) const
+    {
+        return _fieldValueMatcher && _fieldValueMatcher->hasDataType(dataType);
+    }
+
+    bool signedIntMatches(const yactfr::DataType& dataType,
+                          const long long value) const
+    {
+        return _fieldValueMatcher &&
+               _fieldValueMatcher->signedIntMatches(dataType, value);
+    }
+
+    bool unsignedIntMatches(const yactfr::DataType& dataType,
+                            const unsigned long long value) const
+    {
+        return _fieldValueMatcher &&
+               _fieldValueMatcher->unsignedIntMatches(dataType, value);
+    }
+
+    bool floatMatches(const yactfr::DataType& dataType,
+                      const double value) const
+    {
+        return _fieldValueMatcher &&
+               _fieldValueMatcher->floatMatches(dataType, value);
+    }
+
+    bool stringMatches(const yactfr::DataType& dataType,
+                       const std::string& value) const
+    {
+        return _fieldValueMatcher &&
+               _fieldValueMatcher->stringMatches(dataType, value);
+    }
+
+private:
+    std::unique_ptr<const EventRecordTypeNameMatcher> _ertNameMatcher;
+    boost::optional<yactfr::TypeId> _ertId;
+    std::unique_ptr<const FieldValueMatcher> _fieldValueMatcher;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_EVENT_RECORD_MATCHER_HPP
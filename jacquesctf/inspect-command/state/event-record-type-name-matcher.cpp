@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <algorithm>
+
+#include "event-record-type-name-matcher.hpp"
+
+namespace jacques {
+
+EventRecordTypeNameMatcher::EventRecordTypeNameMatcher(const EventRecordTypeNameSearchQuery& query,
+                                                       const yactfr::TraceType& traceType)
+{
+    for (const auto& dst : traceType.dataStreamTypes()) {
+        auto& info = _dstInfos[dst.get()];
+        yactfr::TypeId maxId = 0;
+
+        for (const auto& ert : dst->eventRecordTypes()) {
+            maxId = std::max(maxId, ert->id());
+        }
+
+        // dense table unless the IDs are really sparse
+        info.isDense = maxId < 4 * dst->eventRecordTypes().size() + 256;
+
+        if (info.isDense) {
+            info.flags.assign(maxId + 1, 0);
+        }
+
+        for (const auto& ert : dst->eventRecordTypes()) {
+            if (!ert->name() || !query.matches(*ert->name())) {
+                continue;
+            }
+
+            if (info.isDense) {
+                info.flags[ert->id()] = 1;
+            } else {
+                info.ids.insert(ert->id());
+            }
+        }
+    }
+}
+
+} // namespace jacques
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_EVENT_RECORD_TYPE_NAME_MATCHER_HPP
+#define _JACQUES_EVENT_RECORD_TYPE_NAME_MATCHER_HPP
+
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include <boost/core/noncopyable.hpp>
+#include <yactfr/metadata/trace-type.hpp>
+#include <yactfr/metadata/data-stream-type.hpp>
+#include <yactfr/metadata/event-record-type.hpp>
+
+#include "aliases.hpp"
+#include "search-parser.hpp"
+
+namespace jacques {
+
+/*
+ * Event record type name matcher precompiled from a name search query
+ * and a trace type.
+ *
+ * The event record types of a trace type are known before decoding
+ * anything, so this matcher resolves the query's globbing pattern once
+ * for each event record type, making matches() a single table lookup
+ * instead of a pattern matching operation for each decoded event
+ * record.
+ *
+ * There's one dense table of flags per data stream type, indexed by
+ * event record type ID. If the IDs of a data stream type are too sparse
+ * for a dense table, the matcher keeps the set of matching IDs instead.
+ *
+ * matches() doesn't modify the matcher: many threads can use the same
+ * matcher concurrently.
+ */
+class EventRecordTypeNameMatcher :
+    boost::noncopyable
+{
+public:
+    explicit EventRecordTypeNameMatcher(const EventRecordTypeNameSearchQuery& query,
+                                        const yactfr::TraceType& traceType);
+
+    bool matches(const yactfr::EventRecordType& eventRecordType) const
+    {
+        const auto it = _dstInfos.find(eventRecordType.dataStreamType());
+
+        if (it == std::end(_dstInfos)) {
+            return false;
+        }
+
+        const auto& info = it->second;
+
+        if (info.isDense) {
+            return eventRecordType.id() < info.flags.size() &&
+                   info.flags[eventRecordType.id()];
+        }
+
+        return info.ids.find(eventRecordType.id()) != std::end(info.ids);
+    }
+
+private:
+    struct _DstInfo
+    {
+        // flags indexed by event record type ID
+        std::vector<std::uint8_t> flags;
+
+        // matching IDs (when `flags` is empty)
+        std::unordered_set<yactfr::TypeId> ids;
+
+        bool isDense = true;
+    };
+
+private:
+    std::unordered_map<const yactfr::DataStreamType *, _DstInfo> _dstInfos;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_EVENT_RECORD_TYPE_NAME_MATCHER_HPP
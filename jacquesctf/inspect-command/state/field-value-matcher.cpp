@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cstdlib>
+#include <limits>
+#include <yactfr/metadata/data-type.hpp>
+#include <yactfr/metadata/enum-type.hpp>
+
+#include "field-value-matcher.hpp"
+
+namespace jacques {
+
+template <typename ValueT>
+static bool compare(const ValueT& lhs, const FieldValueSearchQuery::Operator op,
+                    const ValueT& rhs)
+{
+    using Op = FieldValueSearchQuery::Operator;
+
+    switch (op) {
+    case Op::EQ:
+        return lhs == rhs;
+
+    case Op::NE:
+        return lhs != rhs;
+
+    case Op::LT:
+        return lhs < rhs;
+
+    case Op::LE:
+        return lhs <= rhs;
+
+    case Op::GT:
+        return lhs > rhs;
+
+    case Op::GE:
+        return lhs >= rhs;
+
+    default:
+        std::abort();
+    }
+}
+
+template <typename ValueT, typename RangesT>
+static bool isInRanges(const ValueT value, const RangesT& ranges)
+{
+    for (const auto& range : ranges) {
+        if (value >= range.first && value <= range.second) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename EnumTypeT, typename RangesT>
+static void setEnumMemberRanges(const EnumTypeT& enumType,
+                                const std::string& name, RangesT& ranges)
+{
+    const auto it = enumType.members().find(name);
+
+    if (it == std::end(enumType.members())) {
+        // no such member: no range (never equal)
+        return;
+    }
+
+    for (const auto& range : it->second.ranges()) {
+        ranges.emplace_back(range.lower(), range.upper());
+    }
+}
+
+static bool isEventRecordScope(const yactfr::Scope scope)
+{
+    return scope != yactfr::Scope::PACKET_HEADER &&
+           scope != yactfr::Scope::PACKET_CONTEXT;
+}
+
+FieldValueMatcher::FieldValueMatcher(const FieldValueSearchQuery& query,
+                                     const Metadata& metadata) :
+    _op {query.op()},
+    _value {query.value()}
+{
+    if (const auto value = boost::get<long long>(&_value)) {
+        _intValue = *value;
+        _isIntValueNegative = *value < 0;
+        _uintValue = static_cast<unsigned long long>(*value);
+        _realValue = static_cast<double>(*value);
+    } else if (const auto value = boost::get<unsigned long long>(&_value)) {
+        _uintValue = *value;
+        _isIntValueSigned = *value <= static_cast<unsigned long long>(std::numeric_limits<long long>::max());
+        _intValue = static_cast<long long>(*value);
+        _realValue = static_cast<double>(*value);
+    } else if (const auto value = boost::get<double>(&_value)) {
+        _realValue = *value;
+    }
+
+    for (const auto& dtPathPair : metadata.dataTypePaths()) {
+        const auto& dtPath = dtPathPair.second;
+
+        if (query.scope()) {
+            if (dtPath.scope != *query.scope()) {
+                continue;
+            }
+        } else if (!isEventRecordScope(dtPath.scope)) {
+            continue;
+        }
+
+        if (dtPath.path != query.path()) {
+            continue;
+        }
+
+        this->_addEntry(*dtPathPair.first);
+    }
+}
+
+void FieldValueMatcher::_addEntry(const yactfr::DataType& dataType)
+{
+    using Op = FieldValueSearchQuery::Operator;
+
+    const auto isString = dataType.isStringType() ||
+                          dataType.isStaticTextArrayType() ||
+                          dataType.isDynamicTextArrayType();
+    const auto isEnum = dataType.isSignedEnumType() ||
+                        dataType.isUnsignedEnumType();
+    const auto isInt = isEnum || dataType.isSignedIntType() ||
+                       dataType.isUnsignedIntType();
+    _Entry entry;
+
+    if (const auto value = boost::get<std::string>(&_value)) {
+        if (isString) {
+            entry.kind = _Kind::STRING;
+        } else if (isEnum && (_op == Op::EQ || _op == Op::NE)) {
+            // check enumeration types first: they're also integer types
+            entry.kind = _Kind::ENUM_MEMBER;
+
+            if (dataType.isSignedEnumType()) {
+                setEnumMemberRanges(*dataType.asSignedEnumType(), *value,
+                                    entry.signedRanges);
+            } else {
+                setEnumMemberRanges(*dataType.asUnsignedEnumType(), *value,
+                                    entry.unsignedRanges);
+            }
+        } else {
+            return;
+        }
+    } else if ((boost::get<long long>(&_value) ||
+                boost::get<unsigned long long>(&_value)) && isInt) {
+        entry.kind = _Kind::INT;
+    } else if (isInt || dataType.isFloatType()) {
+        entry.kind = _Kind::REAL;
+    } else {
+        return;
+    }
+
+    _entries.emplace(&dataType, std::move(entry));
+}
+
+bool FieldValueMatcher::signedIntMatches(const yactfr::DataType& dataType,
+                                         const long long value) const
+{
+    using Op = FieldValueSearchQuery::Operator;
+
+    const auto entry = this->_entry(dataType);
+
+    if (!entry) {
+        return false;
+    }
+
+    switch (entry->kind) {
+    case _Kind::INT:
+        if (!_isIntValueSigned) {
+            // `value` is always less than a value above `LLONG_MAX`
+            return _op == Op::NE || _op == Op::LT || _op == Op::LE;
+        }
+
+        return compare(value, _op, _intValue);
+
+    case _Kind::REAL:
+        return compare(static_cast<double>(value), _op, _realValue);
+
+    case _Kind::ENUM_MEMBER:
+        return isInRanges(value, entry->signedRanges) == (_op == Op::EQ);
+
+    default:
+        return false;
+    }
+}
+
+bool FieldValueMatcher::unsignedIntMatches(const yactfr::DataType& dataType,
+                                           const unsigned long long value) const
+{
+    using Op = FieldValueSearchQuery::Operator;
+
+    const auto entry = this->_entry(dataType);
+
+    if (!entry) {
+        return false;
+    }
+
+    switch (entry->kind) {
+    case _Kind::INT:
+        if (_isIntValueNegative) {
+            // `value` is always greater than a negative value
+            return _op == Op::NE || _op == Op::GT || _op == Op::GE;
+        }
+
+        return compare(value, _op, _uintValue);
+
+    case _Kind::REAL:
+        return compare(static_cast<double>(value), _op, _realValue);
+
+    case _Kind::ENUM_MEMBER:
+        return isInRanges(value, entry->unsignedRanges) == (_op == Op::EQ);
+
+    default:
+        return false;
+    }
+}
+
+bool FieldValueMatcher::floatMatches(const yactfr::DataType& dataType,
+                                     const double value) const
+{
+    const auto entry = this->_entry(dataType);
+
+    if (!entry || entry->kind != _Kind::REAL) {
+        return false;
+    }
+
+    return compare(value, _op, _realValue);
+}
+
+bool FieldValueMatcher::stringMatches(const yactfr::DataType& dataType,
+                                      const std::string& value) const
+{
+    const auto entry = this->_entry(dataType);
+
+    if (!entry || entry->kind != _Kind::STRING) {
+        return false;
+    }
+
+    return compare(value, _op, boost::get<std::string>(_value));
+}
+
+} // namespace jacques
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_FIELD_VALUE_MATCHER_HPP
+#define _JACQUES_FIELD_VALUE_MATCHER_HPP
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <unordered_map>
+#include <boost/core/noncopyable.hpp>
+#include <yactfr/metadata/fwd.hpp>
+
+#include "aliases.hpp"
+#include "metadata.hpp"
+#include "search-parser.hpp"
+
+namespace jacques {
+
+/*
+ * Field value matcher precompiled from a field value search query and
+ * metadata.
+ *
+ * The matcher resolves the query's field path once: it only knows the
+ * data types which the path designates and for which the query's value
+ * makes sense. For an enumeration member name, it also resolves the
+ * member's ranges once, so that matching an enumeration field is a
+ * range test instead of a member lookup.
+ *
+ * The *Matches() methods return false for a data type which the
+ * matcher doesn't know, so that a caller can pass any decoded value.
+ */
+class FieldValueMatcher :
+    boost::noncopyable
+{
+public:
+    explicit FieldValueMatcher(const FieldValueSearchQuery& query,
+                               const Metadata& metadata);
+
+    bool hasDataType(const yactfr::DataType& dataType) const
+    {
+        return _entries.find(&dataType) != std::end(_entries);
+    }
+
+    // true if no field can ever match
+    bool isEmpty() const noexcept
+    {
+        return _entries.empty();
+    }
+
+    bool signedIntMatches(const yactfr::DataType& dataType,
+                          long long value) const;
+    bool unsignedIntMatches(const yactfr::DataType& dataType,
+                            unsigned long long value) const;
+    bool floatMatches(const yactfr::DataType& dataType, double value) const;
+    bool stringMatches(const yactfr::DataType& dataType,
+                       const std::string& value) const;
+
+private:
+    enum class _Kind
+    {
+        // integer field, integer query value
+        INT,
+
+        // real comparison (floating point number field or real query value)
+        REAL,
+
+        // string field, string query value
+        STRING,
+
+        // enumeration field, member name query value
+        ENUM_MEMBER,
+    };
+
+    struct _Entry
+    {
+        _Kind kind;
+
+        // ranges of the enumeration member (`ENUM_MEMBER` kind)
+        std::vector<std::pair<long long, long long>> signedRanges;
+        std::vector<std::pair<unsigned long long, unsigned long long>> unsignedRanges;
+    };
+
+private:
+    void _addEntry(const yactfr::DataType& dataType);
+
+    const _Entry *_entry(const yactfr::DataType& dataType) const
+    {
+        const auto it = _entries.find(&dataType);
+
+        if (it == std::end(_entries)) {
+            return nullptr;
+        }
+
+        return &it->second;
+    }
+
+private:
+    const FieldValueSearchQuery::Operator _op;
+    const FieldValueSearchQuery::Value _value;
+    bool _isIntValueNegative = false;
+
+    // signed value (only when it's within the `long long` range)
+    long long _intValue = 0;
+    bool _isIntValueSigned = true;
+
+    // unsigned value (only when `_isIntValueNegative` is false)
+    unsigned long long _uintValue = 0;
+
+    double _realValue = 0.;
+    std::unordered_map<const yactfr::DataType *, _Entry> _entries;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_FIELD_VALUE_MATCHER_HPP
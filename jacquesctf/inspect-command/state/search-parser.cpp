@@ -6,6 +6,8 @@
  */
 
 #include <cstdlib>
+#include <cctype>
+#include <cerrno>
 
 #include "search-parser.hpp"
 
@@ -71,6 +73,17 @@ EventRecordTypeIdSearchQuery::EventRecordTypeIdSearchQuery(const long long value
 {
 }
 
+FieldValueSearchQuery::FieldValueSearchQuery(const boost::optional<yactfr::Scope>& scope,
+                                             std::vector<std::string>&& path,
+                                             const Operator op, Value&& value) :
+    SearchQuery {false},
+    _scope {scope},
+    _path {std::move(path)},
+    _op {op},
+    _value {std::move(value)}
+{
+}
+
 SearchParser::SearchParser()
 {
 }
@@ -140,6 +153,10 @@ std::unique_ptr<const SearchQuery> SearchParser::parse(const std::string& input)
         ret = this->_parseEventRecordTypeName(it, std::end(input), isDiff, mul);
         break;
 
+    case '=':
+        ret = this->_parseFieldValue(it, std::end(input), isDiff, mul);
+        break;
+
     default:
         return nullptr;
     }
@@ -197,7 +214,7 @@ boost::optional<long long> SearchParser::_parseInt(std::string::const_iterator&
                 continue;
             }
 
-            if (!std::isdigit(*it)) {
+            if (!std::isdigit(static_cast<unsigned char>(*it))) {
                 break;
             }
 
@@ -414,4 +431,203 @@ std::unique_ptr<const SearchQuery> SearchParser::_parseEventRecordTypeName(std::
     return std::make_unique<const EventRecordTypeNameSearchQuery>(std::move(pattern));
 }
 
+static bool isFieldValueOpChar(const char ch)
+{
+    return ch == '=' || ch == '!' || ch == '<' || ch == '>';
+}
+
+static bool isWhitespace(const char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\v';
+}
+
+std::unique_ptr<const SearchQuery> SearchParser::_parseFieldValue(std::string::const_iterator& it,
+                                                                  std::string::const_iterator end,
+                                                                  const bool isDiff,
+                                                                  const long long mul)
+{
+    if (it == end) {
+        return nullptr;
+    }
+
+    if (isDiff || mul != 1) {
+        return nullptr;
+    }
+
+    // skip '='
+    ++it;
+
+    // field path: `[SCOPE/]NAME[/NAME]...`
+    std::vector<std::string> path;
+    std::string name;
+
+    while (it != end && !isWhitespace(*it) && !isFieldValueOpChar(*it)) {
+        if (*it == '/') {
+            if (name.empty()) {
+                return nullptr;
+            }
+
+            path.push_back(std::move(name));
+            name.clear();
+        } else {
+            name += *it;
+        }
+
+        ++it;
+    }
+
+    if (name.empty()) {
+        return nullptr;
+    }
+
+    path.push_back(std::move(name));
+
+    boost::optional<yactfr::Scope> scope;
+
+    if (path.size() > 1) {
+        // same scope names as the data type details
+        if (path.front() == "ERH") {
+            scope = yactfr::Scope::EVENT_RECORD_HEADER;
+        } else if (path.front() == "ER1C") {
+            scope = yactfr::Scope::EVENT_RECORD_FIRST_CONTEXT;
+        } else if (path.front() == "ER2C") {
+            scope = yactfr::Scope::EVENT_RECORD_SECOND_CONTEXT;
+        } else if (path.front() == "ERP") {
+            scope = yactfr::Scope::EVENT_RECORD_PAYLOAD;
+        }
+
+        if (scope) {
+            path.erase(std::begin(path));
+        }
+    }
+
+    this->_skipWhitespaces(it, end);
+
+    // operator
+    std::string opStr;
+
+    while (it != end && isFieldValueOpChar(*it)) {
+        opStr += *it;
+        ++it;
+    }
+
+    FieldValueSearchQuery::Operator op;
+
+    if (opStr == "==" || opStr == "=") {
+        op = FieldValueSearchQuery::Operator::EQ;
+    } else if (opStr == "!=") {
+        op = FieldValueSearchQuery::Operator::NE;
+    } else if (opStr == "<") {
+        op = FieldValueSearchQuery::Operator::LT;
+    } else if (opStr == "<=") {
+        op = FieldValueSearchQuery::Operator::LE;
+    } else if (opStr == ">") {
+        op = FieldValueSearchQuery::Operator::GT;
+    } else if (opStr == ">=") {
+        op = FieldValueSearchQuery::Operator::GE;
+    } else {
+        return nullptr;
+    }
+
+    this->_skipWhitespaces(it, end);
+
+    auto value = this->_parseFieldValueValue(it, end);
+
+    if (!value) {
+        return nullptr;
+    }
+
+    return std::make_unique<const FieldValueSearchQuery>(scope, std::move(path),
+                                                         op, std::move(*value));
+}
+
+boost::optional<FieldValueSearchQuery::Value> SearchParser::_parseFieldValueValue(std::string::const_iterator& it,
+                                                                                  std::string::const_iterator end)
+{
+    if (it == end) {
+        return boost::none;
+    }
+
+    if (*it == '"') {
+        // quoted string: `\` escapes the next character
+        std::string str;
+
+        ++it;
+
+        while (true) {
+            if (it == end) {
+                return boost::none;
+            }
+
+            if (*it == '"') {
+                ++it;
+                break;
+            }
+
+            if (*it == '\\') {
+                ++it;
+
+                if (it == end) {
+                    return boost::none;
+                }
+            }
+
+            str += *it;
+            ++it;
+        }
+
+        return FieldValueSearchQuery::Value {std::move(str)};
+    }
+
+    std::string token;
+
+    while (it != end && !isWhitespace(*it)) {
+        token += *it;
+        ++it;
+    }
+
+    assert(!token.empty());
+
+    if (std::isdigit(static_cast<unsigned char>(token.front())) || token.front() == '-' ||
+            token.front() == '+' || token.front() == '.') {
+        const auto isHex = token.find("0x") != std::string::npos ||
+                           token.find("0X") != std::string::npos;
+        char *strEnd;
+
+        errno = 0;
+
+        if (!isHex && token.find_first_of(".eE") != std::string::npos) {
+            const auto value = std::strtod(token.c_str(), &strEnd);
+
+            if (*strEnd != '\0' || errno == ERANGE) {
+                return boost::none;
+            }
+
+            return FieldValueSearchQuery::Value {value};
+        }
+
+        if (token.front() == '-') {
+            const auto value = std::strtoll(token.c_str(), &strEnd, 0);
+
+            if (*strEnd != '\0' || errno == ERANGE) {
+                return boost::none;
+            }
+
+            return FieldValueSearchQuery::Value {value};
+        }
+
+        // full unsigned range (64-bit unsigned integer fields)
+        const auto value = std::strtoull(token.c_str(), &strEnd, 0);
+
+        if (*strEnd != '\0' || errno == ERANGE) {
+            return boost::none;
+        }
+
+        return FieldValueSearchQuery::Value {value};
+    }
+
+    // bare word: enumeration member name or string
+    return FieldValueSearchQuery::Value {std::move(token)};
+}
+
 } // namespace jacques
@@ -10,7 +10,10 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include <boost/optional.hpp>
+#include <boost/variant.hpp>
+#include <yactfr/metadata/fwd.hpp>
 
 #include "utils.hpp"
 
@@ -141,6 +144,64 @@ public:
     explicit EventRecordTypeIdSearchQuery(long long value);
 };
 
+class FieldValueSearchQuery :
+    public SearchQuery
+{
+public:
+    enum class Operator
+    {
+        EQ,
+        NE,
+        LT,
+        LE,
+        GT,
+        GE,
+    };
+
+    /*
+     * An integer value compares to integer and enumeration fields, a
+     * real value to floating point number fields, and a string value
+     * to string fields and to enumeration fields (member name).
+     *
+     * A negative integer value is a `long long`, and a non-negative
+     * one is an `unsigned long long`.
+     */
+    using Value = boost::variant<long long, unsigned long long, double,
+                                 std::string>;
+
+public:
+    explicit FieldValueSearchQuery(const boost::optional<yactfr::Scope>& scope,
+                                   std::vector<std::string>&& path,
+                                   Operator op, Value&& value);
+
+    // no scope means any event record scope
+    const boost::optional<yactfr::Scope>& scope() const noexcept
+    {
+        return _scope;
+    }
+
+    const std::vector<std::string>& path() const noexcept
+    {
+        return _path;
+    }
+
+    Operator op() const noexcept
+    {
+        return _op;
+    }
+
+    const Value& value() const noexcept
+    {
+        return _value;
+    }
+
+private:
+    const boost::optional<yactfr::Scope> _scope;
+    const std::vector<std::string> _path;
+    const Operator _op;
+    const Value _value;
+};
+
 class SearchParser
 {
 public:
@@ -167,6 +228,11 @@ private:
     std::unique_ptr<const SearchQuery> _parseEventRecordTypeName(std::string::const_iterator& it,
                                                                  std::string::const_iterator end,
                                                                  bool isDiff, long long mul);
+    std::unique_ptr<const SearchQuery> _parseFieldValue(std::string::const_iterator& it,
+                                                        std::string::const_iterator end,
+                                                        bool isDiff, long long mul);
+    boost::optional<FieldValueSearchQuery::Value> _parseFieldValueValue(std::string::const_iterator& it,
+                                                                        std::string::const_iterator end);
 };
 
 } // namespace jacques
@@ -8,18 +8,25 @@
 #include <cassert>
 #include <algorithm>
 #include <map>
+#include <thread>
+#include <tuple>
 
 #include "state.hpp"
 #include "trace.hpp"
 #include "search-parser.hpp"
+#include "event-record-matcher.hpp"
 #include "message.hpp"
+#include "utils.hpp"
+#include "profiler.hpp"
 
 namespace jacques {
 
 namespace bfs = boost::filesystem;
 
 State::State(const std::vector<bfs::path>& paths,
-             std::shared_ptr<PacketCheckpointsBuildListener> packetCheckpointsBuildListener)
+             std::shared_ptr<PacketCheckpointsBuildListener> packetCheckpointsBuildListener,
+             const DataSourceKind dataSourceKind,
+             const PacketCacheConfig& packetCacheConfig)
 {
     assert(!paths.empty());
 
@@ -30,18 +37,37 @@ State::State(const std::vector<bfs::path>& paths,
         tracePaths[path.parent_path()].push_back(path);
     }
 
-    // create traces
+    /*
+     * Create traces concurrently: each trace parses its own metadata
+     * stream, except that traces sharing an identical metadata text
+     * (typical of a fleet of hosts) share a single parsed trace type
+     * thanks to the common metadata text cache.
+     */
+    std::vector<const std::vector<bfs::path> *> traceDsfPaths;
+
     for (const auto& tracePathPathsPair : tracePaths) {
-        auto trace = std::make_unique<Trace>(tracePathPathsPair.second);
+        traceDsfPaths.push_back(&tracePathPathsPair.second);
+    }
+
+    Metadata::TextCache metadataTextCache;
+
+    _traces.resize(traceDsfPaths.size());
+    utils::parallelFor(traceDsfPaths.size(), [&](const Index index) {
+        _traces[index] = std::make_unique<Trace>(*traceDsfPaths[index],
+                                                 &metadataTextCache,
+                                                 &_fileHandlePool,
+                                                 dataSourceKind,
+                                                 packetCacheConfig);
+    });
 
+    // create data stream file states (in trace path order)
+    for (auto& trace : _traces) {
         for (auto& dataStreamFile : trace->dataStreamFiles()) {
             auto dsfState = std::make_unique<DataStreamFileState>(*this,
                                                                   *dataStreamFile,
                                                                   packetCheckpointsBuildListener);
             _dataStreamFileStates.push_back(std::move(dsfState));
         }
-
-        _traces.push_back(std::move(trace));
     }
 
     _activeDataStreamFileStateIndex = 0;
@@ -108,9 +134,182 @@ void State::_notify(const Message msg)
     }
 }
 
-bool State::search(const SearchQuery& query)
+bool State::search(const SearchQuery& query, SearchProgress * const progress)
+{
+    return this->activeDataStreamFileState().search(query, progress);
+}
+
+bool State::searchTrace(const SearchQuery& query,
+                        SearchProgress * const progress)
 {
-    return this->activeDataStreamFileState().search(query);
+    const profiler::Span span {"State::searchTrace"};
+
+    if (!EventRecordMatcher::isSupported(query)) {
+        // not an event record property: nothing to search trace-wide
+        return this->search(query, progress);
+    }
+
+    using SearchMatch = DataStreamFileState::SearchMatch;
+
+    const auto dsfCount = _dataStreamFileStates.size();
+    const auto activeIndex = _activeDataStreamFileStateIndex;
+    const auto& activeMetadata = _activeDataStreamFileState->dataStreamFile().metadata();
+
+    /*
+     * Only the data stream files of the active trace are candidates:
+     * the clocks of two traces don't share an origin. Each trace has
+     * its own metadata object.
+     */
+    std::vector<Index> dsfIndexes;
+
+    for (Index index = 0; index < dsfCount; ++index) {
+        if (&_dataStreamFileStates[index]->dataStreamFile().metadata() == &activeMetadata) {
+            dsfIndexes.push_back(index);
+        }
+    }
+
+    /*
+     * Reference timestamp: only a match which follows the current
+     * event record in time, when it has a timestamp, is a candidate.
+     * Two event records having the same timestamp are ordered by data
+     * stream file index.
+     */
+    boost::optional<Timestamp> refTs;
+
+    if (const auto eventRecord = this->currentEventRecord()) {
+        refTs = eventRecord->firstTimestamp();
+    }
+
+    if (!activeMetadata.isCorrelatable()) {
+        refTs = boost::none;
+    }
+
+    // first event record to consider, per data stream file
+    std::vector<SearchMatch> starts(dsfCount, SearchMatch {0, 0});
+    Size packetCount = 0;
+    Size sizeBytes = 0;
+
+    for (const auto index : dsfIndexes) {
+        auto& dsfState = *_dataStreamFileStates[index];
+        const auto& dsf = dsfState.dataStreamFile();
+        SearchMatch start {0, 0};
+
+        if (index == activeIndex) {
+            if (dsfState.hasActivePacketState()) {
+                start = dsfState._nextEventRecordSearchStart();
+            }
+        } else if (refTs) {
+            // skip the packets which end before the reference timestamp
+            const auto& entries = dsf.packetIndexEntries();
+            const auto it = std::find_if(std::begin(entries),
+                                         std::end(entries),
+                                         [&refTs](const auto& entry) {
+                return !entry.endTimestamp() ||
+                       entry.endTimestamp()->nsFromOrigin() >= refTs->nsFromOrigin();
+            });
+
+            start.first = it - std::begin(entries);
+        }
+
+        starts[index] = start;
+
+        if (start.first < dsf.packetCount()) {
+            packetCount += dsf.packetCount() - start.first;
+            sizeBytes += dsf.effectiveTotalSizeFromPacket(start.first).bytes();
+        }
+    }
+
+    if (progress) {
+        // started once for all the data stream files
+        progress->start(packetCount, DataSize::fromBytes(sizeBytes));
+    }
+
+    /*
+     * Search the data stream files concurrently, one data stream file
+     * per worker. Share the hardware threads between the data stream
+     * files so that the packet scanning workers of each data stream
+     * file don't multiply the thread count.
+     */
+    const auto hwThreadCount = static_cast<Size>(std::max(std::thread::hardware_concurrency(),
+                                                          1U));
+    const auto maxWorkerCount = std::max(hwThreadCount / dsfIndexes.size(),
+                                         static_cast<Size>(1));
+    std::vector<boost::optional<SearchMatch>> matches(dsfCount);
+    std::vector<boost::optional<Timestamp>> matchTimestamps(dsfCount);
+
+    utils::parallelFor(dsfIndexes.size(), [&](const Index i) {
+        const auto index = dsfIndexes[i];
+        auto& dsf = _dataStreamFileStates[index]->dataStreamFile();
+        const EventRecordMatcher matcher {query, dsf.metadata()};
+
+        if (matcher.isEmpty()) {
+            return;
+        }
+
+        /*
+         * Within another data stream file, skip the event records which
+         * precede the current one while scanning (same timestamp: a
+         * preceding data stream file precedes).
+         */
+        boost::optional<long long> minNsFromOrigin;
+
+        if (index != activeIndex && refTs) {
+            minNsFromOrigin = refTs->nsFromOrigin() +
+                              (index < activeIndex ? 1 : 0);
+        }
+
+        const auto& start = starts[index];
+        const auto match = dsf.findEventRecord(start.first, start.second,
+                                               matcher, progress,
+                                               maxWorkerCount,
+                                               minNsFromOrigin);
+
+        if (!match) {
+            // no match or canceled
+            return;
+        }
+
+        matches[index] = match;
+        matchTimestamps[index] = dsf.eventRecordFirstTimestamp(match->first,
+                                                               match->second);
+    });
+
+    if (progress && progress->isCanceled()) {
+        return false;
+    }
+
+    /*
+     * Choose the match having the earliest timestamp. A match without
+     * a timestamp comes after all the timestamped ones; between two of
+     * them, choose the first data stream file from the active one.
+     */
+    boost::optional<Index> bestIndex;
+    const auto matchKey = [&](const Index index) {
+        const auto& ts = matchTimestamps[index];
+
+        return std::make_tuple(!ts, ts ? ts->nsFromOrigin() : 0LL,
+                               (index + dsfCount - activeIndex) % dsfCount);
+    };
+
+    for (Index index = 0; index < dsfCount; ++index) {
+        if (!matches[index]) {
+            continue;
+        }
+
+        if (!bestIndex || matchKey(index) < matchKey(*bestIndex)) {
+            bestIndex = index;
+        }
+    }
+
+    if (!bestIndex) {
+        return false;
+    }
+
+    const auto match = *matches[*bestIndex];
+
+    this->gotoDataStreamFile(*bestIndex);
+    return _activeDataStreamFileState->_gotoEventRecord(match.first,
+                                                        match.second);
 }
 
 StateObserverGuard::StateObserverGuard(State& state,
@@ -18,6 +18,9 @@
 #include "search-parser.hpp"
 #include "packet-checkpoints-build-listener.hpp"
 #include "trace.hpp"
+#include "file-handle-pool.hpp"
+#include "data-source-kind.hpp"
+#include "packet-cache-config.hpp"
 
 namespace jacques {
 
@@ -49,13 +52,18 @@ public:
 
 public:
     explicit State(const std::vector<boost::filesystem::path>& paths,
-                   std::shared_ptr<PacketCheckpointsBuildListener> packetCheckpointsBuildListener);
+                   std::shared_ptr<PacketCheckpointsBuildListener> packetCheckpointsBuildListener,
+                   DataSourceKind dataSourceKind = DataSourceKind::MEMORY_MAPPED_FILE,
+                   const PacketCacheConfig& packetCacheConfig = PacketCacheConfig {});
     Index addObserver(const Observer& observer);
     void removeObserver(Index id);
     void gotoDataStreamFile(Index index);
     void gotoPreviousDataStreamFile();
     void gotoNextDataStreamFile();
-    bool search(const SearchQuery& query);
+    bool search(const SearchQuery& query,
+                SearchProgress *progress = nullptr);
+    bool searchTrace(const SearchQuery& query,
+                     SearchProgress *progress = nullptr);
 
     DataStreamFileState& activeDataStreamFileState() const
     {
@@ -122,6 +130,27 @@ public:
         _activeDataStreamFileState->gotoLastPacketRegion();
     }
 
+    bool searchAll(const SearchQuery& query,
+                   SearchProgress * const progress = nullptr)
+    {
+        return _activeDataStreamFileState->searchAll(query, progress);
+    }
+
+    bool gotoSearchMatch(const Index index)
+    {
+        return _activeDataStreamFileState->gotoSearchMatch(index);
+    }
+
+    bool gotoPreviousSearchMatch()
+    {
+        return _activeDataStreamFileState->gotoPreviousSearchMatch();
+    }
+
+    bool gotoNextSearchMatch()
+    {
+        return _activeDataStreamFileState->gotoNextSearchMatch();
+    }
+
     bool hasActivePacketState() const noexcept
     {
         return _activeDataStreamFileState->hasActivePacketState();
@@ -175,6 +204,10 @@ private:
     std::vector<std::unique_ptr<DataStreamFileState>> _dataStreamFileStates;
     DataStreamFileState *_activeDataStreamFileState;
     Index _activeDataStreamFileStateIndex = 0;
+
+    // shared by all the data stream files of all the traces
+    FileHandlePool _fileHandlePool;
+
     std::vector<std::unique_ptr<Trace>> _traces;
 };
 
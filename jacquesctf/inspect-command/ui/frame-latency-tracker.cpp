@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "frame-latency-tracker.hpp"
+#include "utils.hpp"
+
+namespace jacques {
+
+constexpr Size FrameLatencyTracker::bucketCount;
+
+FrameLatencyTracker::FrameLatencyTracker(const Duration budget) :
+    _budget {budget}
+{
+}
+
+void FrameLatencyTracker::endFrame() noexcept
+{
+    _lastLatency = std::chrono::duration_cast<Duration>(Clock::now() -
+                                                        _frameStartTime);
+    _maxLatency = std::max(_maxLatency, _lastLatency);
+    ++_frameCount;
+
+    // find the bucket: smallest `i` such that latency <= 2^(i + 1) µs
+    Index index = 0;
+
+    while (index < bucketCount - 1 &&
+            _lastLatency > bucketUpperBound(index)) {
+        ++index;
+    }
+
+    ++_buckets[index];
+
+    if (_lastLatency > _budget) {
+        ++_slowFrameCount;
+        _isDegraded = true;
+    }
+}
+
+FrameLatencyTracker::Duration FrameLatencyTracker::percentile(const double p) const noexcept
+{
+    if (_frameCount == 0) {
+        return Duration {0};
+    }
+
+    const auto rank = std::max(static_cast<Size>(std::ceil(p * _frameCount)),
+                               1ULL);
+    Size count = 0;
+
+    for (Index index = 0; index < bucketCount; ++index) {
+        count += _buckets[index];
+
+        if (count >= rank) {
+            return bucketUpperBound(index);
+        }
+    }
+
+    return bucketUpperBound(bucketCount - 1);
+}
+
+void FrameLatencyTracker::print(std::ostream& os) const
+{
+    os << "Frames: " << utils::sepNumber(_frameCount, ',') << std::endl <<
+          "Frames over budget (" << _budget.count() << " us): " <<
+          utils::sepNumber(_slowFrameCount, ',') << std::endl <<
+          "Max latency: " << _maxLatency.count() << " us" << std::endl <<
+          "p50 latency: <= " << this->percentile(.5).count() << " us" << std::endl <<
+          "p95 latency: <= " << this->percentile(.95).count() << " us" << std::endl <<
+          "p99 latency: <= " << this->percentile(.99).count() << " us" << std::endl;
+
+    for (Index index = 0; index < bucketCount; ++index) {
+        if (_buckets[index] == 0) {
+            continue;
+        }
+
+        os << "  <= " << bucketUpperBound(index).count() << " us: " <<
+              utils::sepNumber(_buckets[index], ',') << std::endl;
+    }
+}
+
+} // namespace jacques
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_FRAME_LATENCY_TRACKER_HPP
+#define _JACQUES_FRAME_LATENCY_TRACKER_HPP
+
+#include <array>
+#include <chrono>
+#include <ostream>
+#include <boost/core/noncopyable.hpp>
+
+#include "aliases.hpp"
+
+namespace jacques {
+
+/*
+ * Key-to-frame latency tracker.
+ *
+ * Call startFrame() when getch() returns a user key and endFrame() when
+ * the resulting frame is on the terminal (after doupdate()). The
+ * tracker records each latency into a histogram of which bucket `i`
+ * contains the latencies from 2^i µs (excluded, except for bucket 0) to
+ * 2^(i + 1) µs (included).
+ *
+ * When a frame exceeds the frame budget, the tracker becomes degraded:
+ * the UI is expected to skip expensive decorations until the user
+ * input settles, at which point the UI calls settle().
+ */
+class FrameLatencyTracker :
+    boost::noncopyable
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Duration = std::chrono::microseconds;
+
+    static constexpr Size bucketCount = 24;
+
+public:
+    explicit FrameLatencyTracker(Duration budget = Duration {33000});
+
+    void startFrame() noexcept
+    {
+        _frameStartTime = Clock::now();
+    }
+
+    /*
+     * Records the latency of the current frame, making the tracker
+     * degraded if it exceeds the budget.
+     */
+    void endFrame() noexcept;
+
+    void settle() noexcept
+    {
+        _isDegraded = false;
+    }
+
+    bool isDegraded() const noexcept
+    {
+        return _isDegraded;
+    }
+
+    Duration budget() const noexcept
+    {
+        return _budget;
+    }
+
+    Size frameCount() const noexcept
+    {
+        return _frameCount;
+    }
+
+    // frames which exceeded the budget
+    Size slowFrameCount() const noexcept
+    {
+        return _slowFrameCount;
+    }
+
+    Duration lastLatency() const noexcept
+    {
+        return _lastLatency;
+    }
+
+    Duration maxLatency() const noexcept
+    {
+        return _maxLatency;
+    }
+
+    Size bucketFrameCount(const Index index) const noexcept
+    {
+        return _buckets[index];
+    }
+
+    // upper bound of the bucket at `index`
+    static Duration bucketUpperBound(const Index index) noexcept
+    {
+        return Duration {1LL << (index + 1)};
+    }
+
+    /*
+     * Upper bound of the bucket which contains the latency of the
+     * `p` (0 to 1) percentile of all the recorded frames.
+     */
+    Duration percentile(double p) const noexcept;
+
+    // prints a summary and the non-empty buckets to `os`
+    void print(std::ostream& os) const;
+
+private:
+    const Duration _budget;
+    Clock::time_point _frameStartTime;
+    std::array<Size, bucketCount> _buckets {};
+    Size _frameCount = 0;
+    Size _slowFrameCount = 0;
+    Duration _lastLatency {0};
+    Duration _maxLatency {0};
+    bool _isDegraded = false;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_FRAME_LATENCY_TRACKER_HPP
@@ -7,6 +7,9 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <cstdio>
+#include <functional>
+#include <memory>
 #include <curses.h>
 #include <signal.h>
 #include <unistd.h>
@@ -22,7 +25,12 @@
 #include "data-stream-files-screen.hpp"
 #include "data-types-screen.hpp"
 #include "trace-info-screen.hpp"
+#include "search-matches-screen.hpp"
+#include "stats-screen.hpp"
 #include "status-view.hpp"
+#include "frame-latency-view.hpp"
+#include "frame-latency-tracker.hpp"
+#include "key-script.hpp"
 #include "packet-index-build-progress-view.hpp"
 #include "packet-checkpoints-build-progress-view.hpp"
 #include "simple-message-view.hpp"
@@ -39,6 +47,10 @@ namespace jacques {
 
 static bool screenInited = false;
 
+// headless terminal (`replay` command) and its output file
+static SCREEN *headlessScreen = nullptr;
+static std::FILE *headlessOutFile = nullptr;
+
 /*
  * Releases the terminal.
  */
@@ -48,6 +60,13 @@ static void finiScreen()
         endwin();
         screenInited = false;
     }
+
+    if (headlessScreen) {
+        delscreen(headlessScreen);
+        headlessScreen = nullptr;
+        std::fclose(headlessOutFile);
+        headlessOutFile = nullptr;
+    }
 }
 
 /*
@@ -59,13 +78,10 @@ static bool termSizeOk()
 }
 
 /*
- * Initializes and takes control of the terminal.
+ * Configures the current terminal.
  */
-static void initScreen()
+static void setupScreen()
 {
-    initscr();
-    screenInited = true;
-
     if (!has_colors() || !termSizeOk()) {
         finiScreen();
 
@@ -102,6 +118,48 @@ static void initScreen()
     use_default_colors();
 }
 
+/*
+ * Initializes and takes control of the terminal.
+ */
+static void initScreen()
+{
+    initscr();
+    screenInited = true;
+    setupScreen();
+}
+
+/*
+ * Initializes a headless terminal of `width` × `height` characters
+ * which reads its user keys from `inFile`.
+ *
+ * ncurses still renders everything into its in-memory virtual screen
+ * and computes the terminal updates, but writes them to `/dev/null`.
+ */
+static void initHeadlessScreen(std::FILE * const inFile,
+                               const unsigned int width,
+                               const unsigned int height)
+{
+    headlessOutFile = std::fopen("/dev/null", "w");
+
+    if (!headlessOutFile) {
+        throw CommandError {"Cannot open `/dev/null`."};
+    }
+
+    headlessScreen = newterm("xterm-256color", headlessOutFile, inFile);
+
+    if (!headlessScreen) {
+        std::fclose(headlessOutFile);
+        headlessOutFile = nullptr;
+        throw CommandError {
+            "Cannot create a headless `xterm-256color` terminal."
+        };
+    }
+
+    screenInited = true;
+    resize_term(static_cast<int>(height), static_cast<int>(width));
+    setupScreen();
+}
+
 static void sigHandler(const int signo)
 {
     if (signo == SIGINT) {
@@ -241,7 +299,20 @@ public:
     }
 };
 
-static void startInteractive(const InspectConfig& cfg)
+/*
+ * While degraded, the inspect screen is restored when there's no user
+ * key for this duration (ms).
+ */
+static constexpr int inputSettleTimeoutMs = 150;
+
+/*
+ * Called after each frame with the user key and the frame's latency.
+ */
+using FrameFunc = std::function<void (int, FrameLatencyTracker::Duration)>;
+
+static void startInteractive(const InspectConfig& cfg,
+                             FrameLatencyTracker& latencyTracker,
+                             const FrameFunc& frameFunc = nullptr)
 {
     auto stylist = std::make_unique<const Stylist>();
 
@@ -252,7 +323,9 @@ static void startInteractive(const InspectConfig& cfg)
     auto packetCheckpointsBuildProgressUpdater = std::make_shared<PacketCheckpointsBuildProgressUpdater>(*stylist,
                                                                                                          redrawCurScreen);
     auto state = std::make_unique<State>(cfg.paths(),
-                                         packetCheckpointsBuildProgressUpdater);
+                                         packetCheckpointsBuildProgressUpdater,
+                                         cfg.dataSourceKind(),
+                                         cfg.packetCacheConfig());
 
     if (state->dataStreamFileStates().empty()) {
         throw CommandError {"All data stream files to inspect are empty."};
@@ -301,6 +374,12 @@ static void startInteractive(const InspectConfig& cfg)
                                                                    cfg,
                                                                    *stylist,
                                                                    *state);
+    const auto searchMatchesScreen = std::make_unique<SearchMatchesScreen>(screenRect,
+                                                                           cfg,
+                                                                           *stylist,
+                                                                           *state);
+    const auto statsScreen = std::make_unique<StatsScreen>(screenRect, cfg,
+                                                           *stylist, *state);
     const std::vector<Screen *> screens {
         inspectScreen.get(),
         packetsScreen.get(),
@@ -308,6 +387,8 @@ static void startInteractive(const InspectConfig& cfg)
         helpScreen.get(),
         dataTypesScreen.get(),
         traceInfoScreen.get(),
+        searchMatchesScreen.get(),
+        statsScreen.get(),
     };
 
     // goto first packet if available: this creates it and shows the progress
@@ -337,6 +418,16 @@ static void startInteractive(const InspectConfig& cfg)
     curScreen->isVisible(true);
     doupdate();
 
+    // key-to-frame latency overlay (hidden key)
+    const auto latencyViewRect = [&screenRect]() {
+        return Rectangle {
+            {screenRect.w - FrameLatencyView::width, 0},
+            FrameLatencyView::width, FrameLatencyView::height
+        };
+    };
+    const auto latencyView = std::make_unique<FrameLatencyView>(latencyViewRect(),
+                                                                *stylist,
+                                                                latencyTracker);
     Screen *prevScreen = nullptr;
     bool done = false;
     bool wantsToQuit = false;
@@ -345,6 +436,39 @@ static void startInteractive(const InspectConfig& cfg)
         const auto ch = getch();
         bool refreshStatus = true;
 
+        if (latencyTracker.isDegraded()) {
+            /*
+             * Reset the input settle timeout: the end of this iteration
+             * sets it again if the UI is still degraded, and a screen
+             * shown by this key can set its own timeout.
+             */
+            timeout(-1);
+
+            if (ch == ERR) {
+                // user input settled: restore the decorations
+                latencyTracker.settle();
+                inspectScreen->isDegraded(false);
+
+                if (curScreen == inspectScreen.get() &&
+                        latencyView->isVisible()) {
+                    latencyView->redraw(true);
+                }
+
+                doupdate();
+                continue;
+            }
+        }
+
+        if (ch == ERR && cfg.isReplay()) {
+            // end of the key script: quit whatever the current state
+            done = true;
+            continue;
+        }
+
+        if (ch != ERR) {
+            latencyTracker.startFrame();
+        }
+
         if (wantsToQuit) {
             if (ch == 'y' || ch == 'Y') {
                 done = true;
@@ -382,6 +506,7 @@ static void startInteractive(const InspectConfig& cfg)
 
             statusView->moveAndResize(Rectangle {{0, screenRect.h},
                                                  screenRect.w, 1});
+            latencyView->moveAndResize(latencyViewRect());
 
             for (auto screen : screens) {
                 screen->resize(screenRect.w, screenRect.h);
@@ -446,6 +571,37 @@ static void startInteractive(const InspectConfig& cfg)
             curScreen->isVisible(true);
             break;
 
+        case 'm':
+            if (curScreen == searchMatchesScreen.get()) {
+                break;
+            }
+
+            curScreen->isVisible(false);
+            curScreen = searchMatchesScreen.get();
+            curScreen->isVisible(true);
+            break;
+
+        case 'L':
+            // hidden: key-to-frame latency overlay
+            latencyView->isVisible(!latencyView->isVisible());
+
+            if (!latencyView->isVisible()) {
+                curScreen->redraw();
+            }
+
+            break;
+
+        case 'S':
+            // hidden: data layer statistics
+            if (curScreen == statsScreen.get()) {
+                break;
+            }
+
+            curScreen->isVisible(false);
+            curScreen = statsScreen.get();
+            curScreen->isVisible(true);
+            break;
+
         case 'h':
         case 'H':
         case '?':
@@ -513,7 +669,34 @@ static void startInteractive(const InspectConfig& cfg)
             statusView->refresh();
         }
 
+        if (latencyView->isVisible()) {
+            // shows the latency of the previous frame
+            latencyView->redraw(true);
+        }
+
         doupdate();
+
+        if (ch == ERR) {
+            continue;
+        }
+
+        latencyTracker.endFrame();
+
+        if (frameFunc) {
+            frameFunc(ch, latencyTracker.lastLatency());
+        }
+
+        if (latencyTracker.isDegraded()) {
+            if (curScreen == inspectScreen.get()) {
+                // too slow: skip expensive decorations until input settles
+                inspectScreen->isDegraded(true);
+                timeout(inputSettleTimeoutMs);
+            } else {
+                // left the inspect screen: nothing to restore later
+                latencyTracker.settle();
+                inspectScreen->isDegraded(false);
+            }
+        }
     }
 }
 
@@ -528,15 +711,78 @@ void inspectCommand(const InspectConfig& cfg)
      */
     refresh();
 
+    FrameLatencyTracker latencyTracker;
+
     // release the terminal whatever the outcome
     try {
-        startInteractive(cfg);
+        startInteractive(cfg, latencyTracker);
     } catch (...) {
         finiScreen();
         throw;
     }
 
     finiScreen();
+
+    if (cfg.printStats()) {
+        std::cerr << "Key-to-frame latency:" << std::endl;
+        latencyTracker.print(std::cerr);
+    }
+}
+
+void replayCommand(const ReplayConfig& cfg)
+{
+    const auto entries = parseKeyScript(cfg.keyScriptPath());
+
+    // the headless terminal reads its user keys from this file
+    const std::unique_ptr<std::FILE, decltype(&std::fclose)> inFile {
+        std::tmpfile(), std::fclose
+    };
+
+    if (!inFile) {
+        throw CommandError {"Cannot create a temporary file."};
+    }
+
+    registerSignals();
+    initHeadlessScreen(inFile.get(), cfg.width(), cfg.height());
+
+    FrameLatencyTracker latencyTracker;
+    std::vector<std::pair<std::string, FrameLatencyTracker::Duration>> frames;
+
+    try {
+        /*
+         * Append Ctrl+D to close any open input box, and then `Q` to
+         * quit.
+         */
+        const auto input = keyScriptInput(entries) + "\x04" "Q";
+
+        if (std::fwrite(input.data(), 1, input.size(), inFile.get()) != input.size() ||
+                std::fflush(inFile.get()) != 0) {
+            throw CommandError {"Cannot write to a temporary file."};
+        }
+
+        std::rewind(inFile.get());
+        refresh();
+        startInteractive(cfg, latencyTracker,
+                         [&frames](const int key,
+                                   const FrameLatencyTracker::Duration latency) {
+            const auto name = keyname(key);
+
+            frames.emplace_back(name ? name : "?", latency);
+        });
+    } catch (...) {
+        finiScreen();
+        throw;
+    }
+
+    finiScreen();
+
+    for (Index index = 0; index < frames.size(); ++index) {
+        std::cout << index << ' ' << frames[index].second.count() << ' ' <<
+                     frames[index].first << '\n';
+    }
+
+    std::cout.flush();
+    latencyTracker.print(std::cerr);
 }
 
 } // namespace jacques
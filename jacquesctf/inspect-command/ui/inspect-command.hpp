@@ -20,6 +20,7 @@ enum class KeyHandlingReaction
 };
 
 class InspectConfig;
+class ReplayConfig;
 
 /*
  * Stats the interactive (ncurses) part of Jacques CTF.
@@ -30,6 +31,15 @@ class InspectConfig;
  */
 void inspectCommand(const InspectConfig& cfg);
 
+/*
+ * Runs the interactive part of Jacques CTF on a headless terminal,
+ * reading the user keys from the key script of `cfg`, and then prints
+ * the latency of each frame (one line per user key: frame index,
+ * latency (µs), and key name) to the standard output and a latency
+ * summary to the standard error.
+ */
+void replayCommand(const ReplayConfig& cfg);
+
 } // namespace jacques
 
 #endif // _JACQUES_INSPECT_COMMAND_HPP
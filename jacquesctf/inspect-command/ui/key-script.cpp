@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <curses.h>
+#include <term.h>
+#include <boost/filesystem.hpp>
+
+#include "key-script.hpp"
+#include "command-error.hpp"
+
+namespace jacques {
+
+static const std::unordered_map<std::string, std::string> keyCapNames {
+    {"up", "kcuu1"},
+    {"down", "kcud1"},
+    {"left", "kcub1"},
+    {"right", "kcuf1"},
+    {"pgup", "kpp"},
+    {"pgdn", "knp"},
+    {"home", "khome"},
+    {"end", "kend"},
+    {"backspace", "kbs"},
+    {"f1", "kf1"},
+    {"f2", "kf2"},
+    {"f3", "kf3"},
+    {"f4", "kf4"},
+    {"f5", "kf5"},
+    {"f6", "kf6"},
+    {"f7", "kf7"},
+    {"f8", "kf8"},
+    {"f9", "kf9"},
+    {"f10", "kf10"},
+    {"f11", "kf11"},
+    {"f12", "kf12"},
+};
+
+static const std::unordered_map<std::string, std::string> keyChars {
+    // `nonl()` mode: the return key is a carriage return
+    {"enter", "\r"},
+    {"tab", "\t"},
+    {"esc", "\x1b"},
+    {"space", " "},
+    {"hash", "#"},
+};
+
+static CommandError syntaxError(const boost::filesystem::path& path,
+                                const Index lineNo, const std::string& msg)
+{
+    std::ostringstream ss;
+
+    ss << "`" << path.string() << "`:" << lineNo << ": " << msg;
+    return CommandError {ss.str()};
+}
+
+std::vector<KeyScriptEntry> parseKeyScript(const boost::filesystem::path& path)
+{
+    std::ifstream file {path.string()};
+
+    if (!file) {
+        std::ostringstream ss;
+
+        ss << "Cannot open key script `" << path.string() << "`.";
+        throw CommandError {ss.str()};
+    }
+
+    std::vector<KeyScriptEntry> entries;
+    std::string line;
+    Index lineNo = 0;
+
+    while (std::getline(file, line)) {
+        ++lineNo;
+
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        static const std::string textPrefix {"text "};
+
+        if (line.compare(0, textPrefix.size(), textPrefix) == 0) {
+            entries.push_back({"", line.substr(textPrefix.size()), 1});
+            continue;
+        }
+
+        std::istringstream lineSs {line};
+        std::string key;
+        long long count = 1;
+
+        lineSs >> key;
+
+        if (key.empty()) {
+            continue;
+        }
+
+        if (!lineSs.eof()) {
+            lineSs >> count;
+
+            if (!lineSs || count < 1) {
+                throw syntaxError(path, lineNo, "Invalid key count.");
+            }
+        }
+
+        KeyScriptEntry entry {"", "", static_cast<Size>(count)};
+
+        if (key.size() == 1) {
+            entry.chars = key;
+        } else if (key.size() == 2 && key[0] == '^') {
+            entry.chars = std::string(1, key[1] & 0x1f);
+        } else if (keyCapNames.count(key) > 0) {
+            entry.capName = keyCapNames.at(key);
+        } else if (keyChars.count(key) > 0) {
+            entry.chars = keyChars.at(key);
+        } else {
+            throw syntaxError(path, lineNo, "Unknown key `" + key + "`.");
+        }
+
+        entries.push_back(std::move(entry));
+    }
+
+    return entries;
+}
+
+std::string keyScriptInput(const std::vector<KeyScriptEntry>& entries)
+{
+    std::string input;
+
+    for (const auto& entry : entries) {
+        std::string chars = entry.chars;
+
+        if (!entry.capName.empty()) {
+            const auto str = tigetstr(entry.capName.c_str());
+
+            if (!str || str == reinterpret_cast<char *>(-1)) {
+                std::ostringstream ss;
+
+                ss << "Terminal has no `" << entry.capName << "` key.";
+                throw CommandError {ss.str()};
+            }
+
+            chars = str;
+        }
+
+        for (Index i = 0; i < entry.count; ++i) {
+            input += chars;
+        }
+    }
+
+    return input;
+}
+
+} // namespace jacques
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_KEY_SCRIPT_HPP
+#define _JACQUES_KEY_SCRIPT_HPP
+
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "aliases.hpp"
+
+namespace jacques {
+
+/*
+ * Key script entry: `count` times the key(s) of which the input is
+ * either the terminfo string named `capName` (if not empty) or
+ * `chars`.
+ */
+struct KeyScriptEntry
+{
+    std::string capName;
+    std::string chars;
+    Size count;
+};
+
+/*
+ * Parses the key script file `path`.
+ *
+ * A key script contains one entry per line:
+ *
+ *     KEY [COUNT]
+ *
+ * where KEY is either a single character, a control character (`^X`),
+ * or one of `up`, `down`, `left`, `right`, `pgup`, `pgdn`, `home`,
+ * `end`, `backspace`, `enter`, `tab`, `esc`, `space`, `hash`, and `f1`
+ * to `f12`, and COUNT (default: 1) is the number of times to press it.
+ *
+ * A `text TEXT` line types TEXT (the rest of the line) once.
+ *
+ * Empty lines and lines starting with `#` are ignored.
+ *
+ * Throws `CommandError` on syntax error.
+ */
+std::vector<KeyScriptEntry> parseKeyScript(const boost::filesystem::path& path);
+
+/*
+ * Returns the terminal input bytes of the key script entries
+ * `entries`, as the current ncurses terminal expects them.
+ *
+ * Throws `CommandError` if the current terminal doesn't have a key.
+ */
+std::string keyScriptInput(const std::vector<KeyScriptEntry>& entries);
+
+} // namespace jacques
+
+#endif // _JACQUES_KEY_SCRIPT_HPP
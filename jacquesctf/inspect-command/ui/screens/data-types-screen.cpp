@@ -15,7 +15,7 @@ DataTypesScreen::DataTypesScreen(const Rectangle& rect,
                                  const InspectConfig& cfg,
                                  const Stylist& stylist, State& state) :
     Screen {rect, cfg, stylist, state},
-    _searchController {*this, stylist}
+    _searchController {*this, cfg, stylist}
 {
     const auto viewRects = this->_viewRects();
     _dstTableView = std::make_unique<DataStreamTypeTableView>(std::get<0>(viewRects),
@@ -18,6 +18,7 @@
 #include "inspect-screen.hpp"
 #include "stylist.hpp"
 #include "state.hpp"
+#include "event-record-matcher.hpp"
 #include "packet-data-view.hpp"
 
 namespace jacques {
@@ -28,7 +29,7 @@ InspectScreen::InspectScreen(const Rectangle& rect, const InspectConfig& cfg,
     _decErrorView {
         std::make_unique<PacketDecodingErrorDetailsView>(rect, stylist, state)
     },
-    _searchController {*this, stylist},
+    _searchController {*this, cfg, stylist},
     _tsFormatModeWheel {
         TimestampFormatMode::LONG,
         TimestampFormatMode::NS_FROM_ORIGIN,
@@ -323,6 +324,16 @@ void InspectScreen::_restoreStateSnapshot(const _StateSnapshot& snapshot)
     }
 }
 
+void InspectScreen::isDegraded(const bool isDegraded)
+{
+    _pdView->isDegraded(isDegraded);
+    _sdteView->isFrozen(isDegraded);
+
+    if (!isDegraded && this->isVisible()) {
+        this->_refreshViews();
+    }
+}
+
 void InspectScreen::_refreshViews()
 {
     _pdView->refresh();
@@ -339,21 +350,22 @@ void InspectScreen::_setLastOffsetInRowBits()
     }
 }
 
-void InspectScreen::_search(const SearchQuery& query, const bool animate)
+void InspectScreen::_search(const SearchQuery& query, const _SearchKind kind)
 {
-    if (dynamic_cast<const EventRecordTypeNameSearchQuery *>(&query) ||
-            dynamic_cast<const EventRecordTypeIdSearchQuery *>(&query)) {
-        std::atomic_bool stop {false};
-        std::thread t {[this, &stop, &query]() {
-            this->_state().search(query);
-            stop = true;
-        }};
-
-        if (animate) {
-            _searchController.animate(stop);
-        }
+    assert(kind != _SearchKind::ALL);
+
+    if (EventRecordMatcher::isSupported(query)) {
+        // this can take a while: show the progress and allow canceling
+        _searchController.animateWhile([this, &query, kind](auto& progress) {
+            if (kind == _SearchKind::TRACE) {
+                this->_state().searchTrace(query, &progress);
+            } else {
+                this->_state().search(query, &progress);
+            }
+        });
 
-        t.join();
+        // remove the search box
+        this->_redraw();
     } else {
         this->_state().search(query);
     }
@@ -634,8 +646,7 @@ KeyHandlingReaction InspectScreen::_handleKey(const int key)
                 // start from initial state
                 this->_restoreStateSnapshot(snapshot);
 
-                if (!dynamic_cast<const EventRecordTypeNameSearchQuery *>(&query) &&
-                        !dynamic_cast<const EventRecordTypeIdSearchQuery *>(&query)) {
+                if (!EventRecordMatcher::isSupported(query)) {
                     // this makes the appropriate views update and redraw
                     this->_state().search(query);
                 }
@@ -659,7 +670,7 @@ KeyHandlingReaction InspectScreen::_handleKey(const int key)
             break;
         }
 
-        this->_search(*query);
+        this->_search(*query, _SearchKind::DATA_STREAM_FILE);
 
         /*
          * If we didn't move, the state snapshot will be identical and
@@ -668,6 +679,54 @@ KeyHandlingReaction InspectScreen::_handleKey(const int key)
         this->_snapshotState();
 
         _lastQuery = std::move(query);
+        _lastSearchKind = _SearchKind::DATA_STREAM_FILE;
+        this->_redraw();
+        this->_tryShowDecodingError();
+        break;
+    }
+
+    case 'T':
+    {
+        auto query = _searchController.start();
+
+        if (!query) {
+            // canceled or invalid
+            this->_redraw();
+            break;
+        }
+
+        // can switch the active data stream file
+        this->_search(*query, _SearchKind::TRACE);
+        this->_snapshotState();
+        _lastQuery = std::move(query);
+        _lastSearchKind = _SearchKind::TRACE;
+        this->_redraw();
+        this->_tryShowDecodingError();
+        break;
+    }
+
+    case 'F':
+    {
+        auto query = _searchController.start();
+
+        if (!query) {
+            // canceled or invalid
+            this->_redraw();
+            break;
+        }
+
+        // scan the whole data stream file once
+        const auto isComplete = _searchController.animateWhile([this, &query](auto& progress) {
+            this->_state().searchAll(*query, &progress);
+        });
+
+        if (isComplete) {
+            this->_state().gotoNextSearchMatch();
+        }
+
+        this->_snapshotState();
+        _lastQuery = std::move(query);
+        _lastSearchKind = _SearchKind::ALL;
         this->_redraw();
         this->_tryShowDecodingError();
         break;
@@ -678,7 +737,28 @@ KeyHandlingReaction InspectScreen::_handleKey(const int key)
             break;
         }
 
-        this->_search(*_lastQuery, false);
+        if (_lastSearchKind == _SearchKind::ALL &&
+                !this->_state().activeDataStreamFileState().searchMatches().empty()) {
+            // no decoding: step within the search matches
+            this->_state().gotoNextSearchMatch();
+        } else if (_lastSearchKind == _SearchKind::TRACE) {
+            this->_search(*_lastQuery, _SearchKind::TRACE);
+        } else {
+            this->_search(*_lastQuery, _SearchKind::DATA_STREAM_FILE);
+        }
+
+        this->_snapshotState();
+        this->_tryShowDecodingError();
+        break;
+
+    case '>':
+        this->_state().gotoNextSearchMatch();
+        this->_snapshotState();
+        this->_tryShowDecodingError();
+        break;
+
+    case '<':
+        this->_state().gotoPreviousSearchMatch();
         this->_snapshotState();
         this->_tryShowDecodingError();
         break;
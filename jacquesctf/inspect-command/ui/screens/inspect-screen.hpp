@@ -40,6 +40,14 @@ public:
                            const Stylist& stylist, State& state);
     ~InspectScreen();
 
+    /*
+     * Sets whether or not the screen is degraded, that is, whether or
+     * not it skips its expensive decorations (previous/next packet
+     * region emphasis, ASCII characters, sub data type explorer
+     * updates) to keep up with the user input.
+     */
+    void isDegraded(bool isDegraded);
+
 private:
     struct _StateSnapshot
     {
@@ -63,6 +71,18 @@ private:
         Rectangle pd;
     };
 
+    // kind of search which `_lastQuery` was
+    enum class _SearchKind {
+        // next match within the active data stream file
+        DATA_STREAM_FILE,
+
+        // all matches within the active data stream file
+        ALL,
+
+        // next match within all the data stream files
+        TRACE,
+    };
+
     enum class _ErtViewDisplayMode {
         HIDDEN,
         SHORT,
@@ -86,7 +106,7 @@ private:
     void _gotoBookmark(unsigned int id);
     void _refreshViews();
     void _setLastOffsetInRowBits();
-    void _search(const SearchQuery& query, bool animate = true);
+    void _search(const SearchQuery& query, _SearchKind kind);
 
 private:
     std::unique_ptr<EventRecordTableView> _ertView;
@@ -96,6 +116,8 @@ private:
     std::unique_ptr<PacketDecodingErrorDetailsView> _decErrorView;
     SearchController _searchController;
     std::unique_ptr<const SearchQuery> _lastQuery;
+    _SearchKind _lastSearchKind = _SearchKind::DATA_STREAM_FILE;
+
     CycleWheel<TimestampFormatMode> _tsFormatModeWheel;
     CycleWheel<utils::SizeFormatMode> _dsFormatModeWheel;
     const Size _maxStateSnapshots = 500;
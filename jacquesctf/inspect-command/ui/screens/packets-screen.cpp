@@ -25,7 +25,7 @@ PacketsScreen::PacketsScreen(const Rectangle& rect, const InspectConfig& cfg,
                              const Stylist& stylist, State& state) :
     Screen {rect, cfg, stylist, state},
     _ptView {std::make_unique<PacketTableView>(rect, stylist, state)},
-    _searchController {*this, stylist},
+    _searchController {*this, cfg, stylist},
     _tsFormatModeWheel {
         TimestampFormatMode::LONG,
         TimestampFormatMode::NS_FROM_ORIGIN,
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <curses.h>
+
+#include "config.hpp"
+#include "search-match-table-view.hpp"
+#include "search-matches-screen.hpp"
+#include "search-parser.hpp"
+#include "state.hpp"
+#include "stylist.hpp"
+
+namespace jacques {
+
+SearchMatchesScreen::SearchMatchesScreen(const Rectangle& rect,
+                                         const InspectConfig& cfg,
+                                         const Stylist& stylist,
+                                         State& state) :
+    Screen {rect, cfg, stylist, state},
+    _view {std::make_unique<SearchMatchTableView>(rect, stylist, state)},
+    _searchController {*this, cfg, stylist},
+    _tsFormatModeWheel {
+        TimestampFormatMode::LONG,
+        TimestampFormatMode::NS_FROM_ORIGIN,
+        TimestampFormatMode::CYCLES,
+    },
+    _dsFormatModeWheel {
+        utils::SizeFormatMode::FULL_FLOOR_WITH_EXTRA_BITS,
+        utils::SizeFormatMode::BYTES_FLOOR_WITH_EXTRA_BITS,
+        utils::SizeFormatMode::BITS,
+    }
+{
+    _view->focus();
+}
+
+void SearchMatchesScreen::_redraw()
+{
+    _view->redraw();
+}
+
+void SearchMatchesScreen::_resized()
+{
+    _view->moveAndResize(this->rect());
+    _searchController.parentScreenResized(*this);
+}
+
+void SearchMatchesScreen::_visibilityChanged()
+{
+    _view->isVisible(this->isVisible());
+
+    if (this->isVisible()) {
+        _view->searchMatchesChanged();
+    }
+}
+
+KeyHandlingReaction SearchMatchesScreen::_handleKey(const int key)
+{
+    switch (key) {
+    case KEY_UP:
+        _view->prev();
+        break;
+
+    case KEY_DOWN:
+        _view->next();
+        break;
+
+    case KEY_PPAGE:
+        _view->pageUp();
+        break;
+
+    case KEY_NPAGE:
+        _view->pageDown();
+        break;
+
+    case KEY_END:
+        _view->selectLast();
+        break;
+
+    case KEY_HOME:
+        _view->selectFirst();
+        break;
+
+    case 'c':
+        _view->centerSelectedRow();
+        break;
+
+    case 't':
+        _tsFormatModeWheel.next();
+        _view->timestampFormatMode(_tsFormatModeWheel.currentValue());
+        break;
+
+    case 's':
+        _dsFormatModeWheel.next();
+        _view->dataSizeFormatMode(_dsFormatModeWheel.currentValue());
+        break;
+
+    case '/':
+    case 'g':
+    case 'F':
+    {
+        const auto query = _searchController.start();
+
+        if (query) {
+            // canceling leaves no search matches
+            _searchController.animateWhile([this, &query](auto& progress) {
+                this->_state().searchAll(*query, &progress);
+            });
+        }
+
+        _view->searchMatchesChanged();
+        break;
+    }
+
+    case '\n':
+    case '\r':
+        if (!this->_state().gotoSearchMatch(_view->selectedSearchMatchIndex())) {
+            break;
+        }
+
+        return KeyHandlingReaction::RETURN_TO_INSPECT;
+
+    case KEY_F(3):
+        this->_state().gotoPreviousDataStreamFile();
+        break;
+
+    case KEY_F(4):
+        this->_state().gotoNextDataStreamFile();
+        break;
+
+    default:
+        break;
+    }
+
+    _view->refresh();
+    return KeyHandlingReaction::CONTINUE;
+}
+
+} // namespace jacques
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_SEARCH_MATCHES_SCREEN_HPP
+#define _JACQUES_SEARCH_MATCHES_SCREEN_HPP
+
+#include "aliases.hpp"
+#include "stylist.hpp"
+#include "state.hpp"
+#include "search-match-table-view.hpp"
+#include "search-controller.hpp"
+#include "screen.hpp"
+#include "cycle-wheel.hpp"
+#include "data-size.hpp"
+
+namespace jacques {
+
+class SearchMatchesScreen :
+    public Screen
+{
+public:
+    explicit SearchMatchesScreen(const Rectangle& rect,
+                                 const InspectConfig& cfg,
+                                 const Stylist& stylist, State& state);
+
+private:
+    void _redraw() override;
+    void _resized() override;
+    KeyHandlingReaction _handleKey(int key) override;
+    void _visibilityChanged() override;
+
+private:
+    std::unique_ptr<SearchMatchTableView> _view;
+    SearchController _searchController;
+    CycleWheel<TimestampFormatMode> _tsFormatModeWheel;
+    CycleWheel<utils::SizeFormatMode> _dsFormatModeWheel;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_SEARCH_MATCHES_SCREEN_HPP
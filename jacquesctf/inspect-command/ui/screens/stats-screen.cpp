@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <curses.h>
+
+#include "config.hpp"
+#include "stats-screen.hpp"
+#include "stats-view.hpp"
+#include "stylist.hpp"
+#include "state.hpp"
+
+namespace jacques {
+
+StatsScreen::StatsScreen(const Rectangle& rect, const InspectConfig& cfg,
+                         const Stylist& stylist, State& state) :
+    Screen {rect, cfg, stylist, state},
+    _view {std::make_unique<StatsView>(rect, stylist)}
+{
+    _view->focus();
+}
+
+void StatsScreen::_redraw()
+{
+    _view->redraw();
+}
+
+void StatsScreen::_resized()
+{
+    _view->moveAndResize(this->rect());
+}
+
+void StatsScreen::_visibilityChanged()
+{
+    _view->isVisible(this->isVisible());
+
+    // refresh the counters every second while visible
+    timeout(this->isVisible() ? 1000 : -1);
+
+    if (this->isVisible()) {
+        _view->redraw();
+    }
+}
+
+KeyHandlingReaction StatsScreen::_handleKey(const int key)
+{
+    switch (key) {
+    case KEY_UP:
+        _view->prev();
+        break;
+
+    case KEY_DOWN:
+        _view->next();
+        break;
+
+    case KEY_PPAGE:
+        _view->pageUp();
+        break;
+
+    case KEY_NPAGE:
+        _view->pageDown();
+        break;
+
+    case ERR:
+        // getch() timeout: read the counters again
+        _view->redraw();
+        break;
+
+    default:
+        break;
+    }
+
+    _view->refresh();
+    return KeyHandlingReaction::CONTINUE;
+}
+
+} // namespace jacques
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_STATS_SCREEN_HPP
+#define _JACQUES_STATS_SCREEN_HPP
+
+#include "aliases.hpp"
+#include "stylist.hpp"
+#include "state.hpp"
+#include "screen.hpp"
+#include "stats-view.hpp"
+
+namespace jacques {
+
+/*
+ * Hidden screen showing the data layer instrumentation counters.
+ *
+ * While this screen is visible, getch() times out every second so that
+ * the view shows the counters live.
+ */
+class StatsScreen :
+    public Screen
+{
+public:
+    explicit StatsScreen(const Rectangle& rect, const InspectConfig& cfg,
+                         const Stylist& stylist, State& state);
+
+private:
+    void _redraw() override;
+    void _resized() override;
+    KeyHandlingReaction _handleKey(int key) override;
+    void _visibilityChanged() override;
+
+private:
+    std::unique_ptr<StatsView> _view;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_STATS_SCREEN_HPP
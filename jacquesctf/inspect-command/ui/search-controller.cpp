@@ -16,11 +16,13 @@
 namespace jacques {
 
 SearchController::SearchController(const Screen& parentScreen,
+                                   const InspectConfig& cfg,
                                    const Stylist& stylist) :
     _searchView {
         std::make_unique<SearchInputView>(SearchController::_viewRect(parentScreen),
                                           stylist)
-    }
+    },
+    _isReplay {cfg.isReplay()}
 {
 }
 
@@ -69,6 +71,9 @@ std::unique_ptr<const SearchQuery> SearchController::startLive(const std::string
         } else if (ch == 4) {
             // ctrl+d
             break;
+        } else if (ch == ERR && _isReplay) {
+            // end of the key script
+            break;
         } else if (std::isprint(ch)) {
             if (buf.size() == lineLen - 1) {
                 // no space
@@ -98,7 +103,8 @@ void SearchController::parentScreenResized(const Screen& parentScreen)
     _searchView->moveAndResize(SearchController::_viewRect(parentScreen));
 }
 
-void SearchController::animate(std::atomic_bool& stop) const
+void SearchController::animate(std::atomic_bool& stop,
+                               SearchProgress& progress) const
 {
     using namespace std::chrono_literals;
 
@@ -106,18 +112,39 @@ void SearchController::animate(std::atomic_bool& stop) const
 
     _searchView->isVisible(true);
 
-    while (true) {
-        if (stop) {
-            return;
+    /*
+     * Poll the keyboard to let the user cancel, except when replaying:
+     * this would consume the next keys of the key script.
+     */
+    if (!_isReplay) {
+        nodelay(stdscr, TRUE);
+    }
+
+    while (!stop) {
+        const auto ch = _isReplay ? ERR : getch();
+
+        if (ch == 4 || ch == 27) {
+            // ctrl+d or escape
+            progress.cancel();
         }
 
         _searchView->animateBorder(animIndex);
         ++animIndex;
+
+        // the progress doesn't need to be that fresh
+        if (animIndex % 4 == 1) {
+            _searchView->drawProgress(progress);
+        }
+
         _searchView->refresh(true);
         doupdate();
         std::this_thread::sleep_for(50ms);
     }
 
+    if (!_isReplay) {
+        nodelay(stdscr, FALSE);
+    }
+
     _searchView->isVisible(false);
 }
 
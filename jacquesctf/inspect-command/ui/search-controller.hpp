@@ -10,10 +10,13 @@
 
 #include <memory>
 #include <atomic>
+#include <thread>
 
 #include "search-input-view.hpp"
+#include "search-progress.hpp"
 #include "screen.hpp"
 #include "stylist.hpp"
+#include "config.hpp"
 
 namespace jacques {
 
@@ -24,11 +27,12 @@ public:
 
 public:
     explicit SearchController(const Screen& parentScreen,
+                              const InspectConfig& cfg,
                               const Stylist& stylist);
     std::unique_ptr<const SearchQuery> startLive(const std::string& init,
                                                  const LiveUpdateFunc& liveUpdateFunc);
     void parentScreenResized(const Screen& parentScreen);
-    void animate(std::atomic_bool& stop) const;
+    void animate(std::atomic_bool& stop, SearchProgress& progress) const;
 
     std::unique_ptr<const SearchQuery> start(const std::string& init)
     {
@@ -40,6 +44,32 @@ public:
         return this->start(std::string {});
     }
 
+    /*
+     * Calls `func(progress)` from another thread, `progress` being a
+     * search progress object, animating the search box and showing this
+     * progress until it returns.
+     *
+     * Meanwhile, the user can cancel `progress` with Ctrl+D or Esc,
+     * except when replaying a key script: polling the keyboard would
+     * consume the next keys of the script, depending on timing.
+     *
+     * Returns false if the user canceled the search.
+     */
+    template <typename FuncT>
+    bool animateWhile(FuncT&& func) const
+    {
+        SearchProgress progress;
+        std::atomic_bool stop {false};
+        std::thread t {[&func, &stop, &progress]() {
+            func(progress);
+            stop = true;
+        }};
+
+        this->animate(stop, progress);
+        t.join();
+        return !progress.isCanceled();
+    }
+
 private:
     void _tryLiveUpdate(const std::string& buf,
                         const LiveUpdateFunc& liveUpdateFunc)
@@ -68,6 +98,9 @@ private:
 
 private:
     std::unique_ptr<SearchInputView> _searchView;
+
+    // true when replaying a key script (`replay` command)
+    const bool _isReplay;
 };
 
 } // namespace jacques
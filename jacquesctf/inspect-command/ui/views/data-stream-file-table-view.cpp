@@ -212,6 +212,7 @@ void DataStreamFileTableView::timestampFormatMode(const TimestampFormatMode tsFo
     }
 
     _tsFormatMode = tsFormatMode;
+    this->_invalidateCellCache();
     this->_redrawRows();
 }
 
@@ -219,6 +220,7 @@ void DataStreamFileTableView::dataSizeFormatMode(const utils::SizeFormatMode dat
 {
     static_cast<DataSizeTableViewCell&>(*_row[1]).formatMode(dataSizeFormatMode);
     _sizeFormatMode = dataSizeFormatMode;
+    this->_invalidateCellCache();
     this->_redrawRows();
 }
 
@@ -191,6 +191,7 @@ void EventRecordTableView::timestampFormatMode(const TimestampFormatMode tsForma
     }
 
     _tsFormatMode = tsFormatMode;
+    this->_invalidateCellCache();
     this->_redrawRows();
 }
 
@@ -199,6 +200,7 @@ void EventRecordTableView::dataSizeFormatMode(const utils::SizeFormatMode dsForm
     static_cast<DataSizeTableViewCell&>(*_row[1]).formatMode(dsFormatMode);
     static_cast<DataSizeTableViewCell&>(*_row[2]).formatMode(dsFormatMode);
     _sizeFormatMode = dsFormatMode;
+    this->_invalidateCellCache();
     this->_redrawRows();
 }
 
@@ -221,6 +223,7 @@ void EventRecordTableView::_stateChanged(const Message msg)
          */
         this->_selectionIndex(0, false);
         this->_isSelectionHighlightEnabled(false, false);
+        this->_invalidateCellCache();
     }
 
     if (_state->hasActivePacketState() &&
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include "frame-latency-view.hpp"
+#include "stylist.hpp"
+#include "utils.hpp"
+
+namespace jacques {
+
+constexpr Size FrameLatencyView::width;
+constexpr Size FrameLatencyView::height;
+
+FrameLatencyView::FrameLatencyView(const Rectangle& rect,
+                                   const Stylist& stylist,
+                                   const FrameLatencyTracker& tracker) :
+    View {rect, "Frame latency", DecorationStyle::BORDERS, stylist},
+    _tracker {&tracker}
+{
+}
+
+void FrameLatencyView::_drawProp(const Index y, const char * const key,
+                                 const long long value)
+{
+    this->_moveCursor({0, y});
+    this->_stylist().traceInfoViewPropKey(*this);
+    this->_safePrint("%s:", key);
+    this->_moveCursor({11, y});
+    this->_stylist().traceInfoViewPropValue(*this);
+    this->_safePrint("%s", utils::sepNumber(value, ',').c_str());
+}
+
+void FrameLatencyView::_redrawContent()
+{
+    this->_stylist().std(*this);
+    this->_clearContent();
+
+    const auto& tracker = *_tracker;
+
+    this->_drawProp(0, "Frames", static_cast<long long>(tracker.frameCount()));
+    this->_drawProp(1, "Slow", static_cast<long long>(tracker.slowFrameCount()));
+    this->_drawProp(2, "Last (us)", tracker.lastLatency().count());
+    this->_drawProp(3, "p50 (us)", tracker.percentile(.5).count());
+    this->_drawProp(4, "p99 (us)", tracker.percentile(.99).count());
+    this->_drawProp(5, "Max (us)", tracker.maxLatency().count());
+
+    if (tracker.isDegraded()) {
+        this->_moveCursor({0, 6});
+        this->_stylist().error(*this);
+        this->_safePrint("%s", "Degraded");
+    }
+}
+
+} // namespace jacques
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_FRAME_LATENCY_VIEW_HPP
+#define _JACQUES_FRAME_LATENCY_VIEW_HPP
+
+#include "view.hpp"
+#include "frame-latency-tracker.hpp"
+
+namespace jacques {
+
+/*
+ * Debug overlay which shows the key-to-frame latency summary of a
+ * frame latency tracker.
+ */
+class FrameLatencyView :
+    public View
+{
+public:
+    static constexpr Size width = 30;
+    static constexpr Size height = 9;
+
+public:
+    explicit FrameLatencyView(const Rectangle& rect, const Stylist& stylist,
+                              const FrameLatencyTracker& tracker);
+
+private:
+    void _redrawContent() override;
+    void _drawProp(Index y, const char *key, long long value);
+
+private:
+    const FrameLatencyTracker * const _tracker;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_FRAME_LATENCY_VIEW_HPP
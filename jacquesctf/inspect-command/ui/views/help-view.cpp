@@ -43,6 +43,7 @@ void HelpView::_buildRows()
         _KeyRow {"p", "Go to \"Packets\" screen"},
         _KeyRow {"d", "Go to \"Data types\" screen"},
         _KeyRow {"i", "Go to \"Trace info\" screen"},
+        _KeyRow {"m", "Go to \"Search matches\" screen"},
         _KeyRow {"h, H, ?", "Go to \"Help\" screen"},
         _KeyRow {"q, Esc", "Quit current screen or go to \"Packet inspection\" screen"},
         _KeyRow {"r, Ctrl+l", "Hard refresh screen"},
@@ -103,7 +104,11 @@ void HelpView::_buildRows()
         _KeyRow {"$", "Go to offset within packet (bytes)"},
         _KeyRow {"N, *", "Go to event record with timestamp (ns)"},
         _KeyRow {"k", "Go to event record with timestamp (cycles)"},
-        _KeyRow {"n", "Repeat previous search"},
+        _KeyRow {"n", "Repeat previous search/go to next search match"},
+        _KeyRow {"F", "Find all event records (see syntax below)"},
+        _KeyRow {"T", "Search event record in all data stream files"},
+        _KeyRow {">", "Go to next search match"},
+        _KeyRow {"<", "Go to previous search match"},
         _EmptyRow {},
         _SectionRow {"\"Data stream files\" screen keys"},
         _SubSectionRow {"Presentation"},
@@ -157,6 +162,29 @@ void HelpView::_buildRows()
         _KeyRow {"Enter", "Accept selection and return to \"Packet inspection\" screen"},
         _KeyRow {"q", "Discard selection and return to \"Packet inspection\" screen"},
         _EmptyRow {},
+        _SectionRow {"\"Search matches\" screen keys"},
+        _SubSectionRow {"Presentation"},
+        _KeyRow {"s", "Cycle size columns's format"},
+        _KeyRow {"t", "Cycle timestamp columns's format"},
+        _KeyRow {"c", "Center selected row"},
+        _EmptyRow {},
+        _SubSectionRow {"Navigation"},
+        _KeyRow {"Up", "Select previous row"},
+        _KeyRow {"Down", "Select next row"},
+        _KeyRow {"Pg up", "Jump to previous page"},
+        _KeyRow {"Pg down", "Jump to next page"},
+        _KeyRow {"Home", "Select first row"},
+        _KeyRow {"End", "Select last row"},
+        _KeyRow {"F3", "Go to previous data stream file"},
+        _KeyRow {"F4", "Go to next data stream file"},
+        _EmptyRow {},
+        _SubSectionRow {"Search"},
+        _KeyRow {"/, g, F", "Find all event records (see syntax below)"},
+        _EmptyRow {},
+        _SubSectionRow {"Action"},
+        _KeyRow {"Enter", "Go to selected match in \"Packet inspection\" screen"},
+        _KeyRow {"q", "Return to \"Packet inspection\" screen"},
+        _EmptyRow {},
         _SectionRow {"\"Data types\" screen keys"},
         _SubSectionRow {"Presentation"},
         _KeyRow {"c", "Center selected table row"},
@@ -198,6 +226,7 @@ void HelpView::_buildRows()
         _KeyRow {"Ctrl+w", "Clear input"},
         _KeyRow {"Enter", "Search if input is not empty, else cancel"},
         _KeyRow {"Ctrl+d", "Cancel"},
+        _KeyRow {"Ctrl+d, Esc", "Cancel running search"},
         _EmptyRow {},
         _SectionRow {"Search syntax"},
         _TextRow {"X is a constant integer which you can write in decimal, hexadecimal"},
@@ -230,6 +259,7 @@ void HelpView::_buildRows()
         _EmptyRow {},
         _SearchSyntaxRow {"Next event record with type name Z", "/Z"},
         _SearchSyntaxRow {"Next event record with type ID X", "%X"},
+        _SearchSyntaxRow {"Next event record with field F and value X", "=F OP X  =SCOPE/F OP X"},
     };
 
     _ssRowFmtPos = 0;
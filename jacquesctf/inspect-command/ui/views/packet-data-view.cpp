@@ -10,6 +10,9 @@
 #include <cstdio>
 #include <algorithm>
 #include <cstdlib>
+#include <array>
+#include <iterator>
+#include <cctype>
 
 #include "stylist.hpp"
 #include "packet-data-view.hpp"
@@ -23,6 +26,8 @@
 
 namespace jacques {
 
+constexpr Index PacketDataView::_Chars::noPacketRegionOffset;
+
 PacketDataView::PacketDataView(const Rectangle& rect,
                                const Stylist& stylist, State& state,
                                const InspectScreen::Bookmarks& bookmarks) :
@@ -62,7 +67,7 @@ void PacketDataView::_stateChanged(const Message msg)
     }
 }
 
-void PacketDataView::_setBaseAndEndOffsetInPacketBitsFromOffset(const Index offsetInPacketBits)
+Index PacketDataView::_centeredBaseOffsetInPacketBits(const Index offsetInPacketBits) const
 {
     assert(_state->hasActivePacketState());
     assert(offsetInPacketBits <
@@ -73,11 +78,15 @@ void PacketDataView::_setBaseAndEndOffsetInPacketBitsFromOffset(const Index offs
     const auto halfPageSize = this->_halfPageSize();
 
     if (rowOffsetInPacketBits < halfPageSize) {
-        _baseOffsetInPacketBits = 0;
-    } else {
-        _baseOffsetInPacketBits = rowOffsetInPacketBits - halfPageSize.bits();
+        return 0;
     }
 
+    return rowOffsetInPacketBits - halfPageSize.bits();
+}
+
+void PacketDataView::_setBaseAndEndOffsetInPacketBitsFromOffset(const Index offsetInPacketBits)
+{
+    _baseOffsetInPacketBits = this->_centeredBaseOffsetInPacketBits(offsetInPacketBits);
     this->_setEndOffsetInPacketBitsFromBaseOffset();
 }
 
@@ -113,41 +122,54 @@ void PacketDataView::_setPrevCurNextOffsetInPacketBits()
     }
 }
 
-bool PacketDataView::_isCharSelected(const _Char& ch) const
+bool PacketDataView::_isCharSelected(const _Chars& chars,
+                                    const Index index) const
 {
-    auto selectedPacketRegionIt = ch.packetRegionIt(_curOffsetInPacketBits);
+    return chars.hasPacketRegion(index, _curOffsetInPacketBits) ||
+           chars.hasPacketRegion(index, _prevOffsetInPacketBits) ||
+           chars.hasPacketRegion(index, _nextOffsetInPacketBits);
+}
 
-    if (selectedPacketRegionIt != std::end(ch.packetRegions)) {
-        return true;
-    }
+void PacketDataView::_drawSelectedChars(const bool isSelected) const
+{
+    for (Index y = 0; y < _rows.size(); ++y) {
+        const auto& row = _rows[y];
 
-    if (_prevOffsetInPacketBits) {
-        selectedPacketRegionIt = ch.packetRegionIt(*_prevOffsetInPacketBits);
+        for (Index index = 0; index < row.numericChars.size(); ++index) {
+            if (!this->_isCharSelected(row.numericChars, index)) {
+                continue;
+            }
 
-        if (selectedPacketRegionIt != std::end(ch.packetRegions)) {
-            return true;
+            if (isSelected) {
+                this->_drawChar(row.numericChars, index, y);
+            } else {
+                this->_drawUnselectedChar(row.numericChars, index, y);
+            }
         }
-    }
 
-    if (_nextOffsetInPacketBits) {
-        selectedPacketRegionIt = ch.packetRegionIt(*_nextOffsetInPacketBits);
+        if (!_isAsciiVisible || (_isDegraded && isSelected)) {
+            continue;
+        }
 
-        if (selectedPacketRegionIt != std::end(ch.packetRegions)) {
-            return true;
+        for (Index index = 0; index < row.asciiChars.size(); ++index) {
+            if (!this->_isCharSelected(row.asciiChars, index)) {
+                continue;
+            }
+
+            if (isSelected) {
+                this->_drawChar(row.asciiChars, index, y);
+            } else {
+                this->_drawUnselectedChar(row.asciiChars, index, y);
+            }
         }
     }
-
-    return false;
 }
 
 void PacketDataView::_updateSelection()
 {
     assert(_state->hasActivePacketState());
 
-    if (_state->curOffsetInPacketBits() < _baseOffsetInPacketBits ||
-            _state->curOffsetInPacketBits() >= _endOffsetInPacketBits ||
-            _chars.empty()) {
-        // outside the current character: reset base offset
+    if (_rows.empty()) {
         this->_setBaseAndEndOffsetInPacketBitsFromOffset(_state->curOffsetInPacketBits());
         this->_setPrevCurNextOffsetInPacketBits();
         this->_redrawContent();
@@ -155,40 +177,23 @@ void PacketDataView::_updateSelection()
     }
 
     // "erase" currently selected characters
-    // TODO: do not search linearly
-    for (const auto& ch : _chars) {
-        if (this->_isCharSelected(ch)) {
-            this->_drawUnselectedChar(ch);
-        }
-    }
-
-    if (_isAsciiVisible) {
-        for (const auto& ch : _asciiChars) {
-            if (this->_isCharSelected(ch)) {
-                this->_drawUnselectedChar(ch);
-            }
-        }
-    }
-
-    // draw new selected characters
-    // TODO: do not search linearly
+    this->_drawSelectedChars(false);
     this->_setPrevCurNextOffsetInPacketBits();
 
-    for (const auto& ch : _chars) {
-        if (this->_isCharSelected(ch)) {
-            this->_drawChar(ch);
-        }
+    if (_curOffsetInPacketBits < _baseOffsetInPacketBits ||
+            _curOffsetInPacketBits >= _endOffsetInPacketBits) {
+        /*
+         * Outside the current rows: center the new selection. Most of
+         * the time (e.g., when moving to the previous/next row), this
+         * only creates and draws half a page of new rows.
+         */
+        this->_scrollToBaseOffsetInPacketBits(this->_centeredBaseOffsetInPacketBits(_curOffsetInPacketBits));
     }
 
-    if (_isAsciiVisible) {
-        for (const auto& ch : _asciiChars) {
-            if (this->_isCharSelected(ch)) {
-                this->_drawChar(ch);
-            }
-        }
-    }
+    // draw new selected characters
+    this->_drawSelectedChars(true);
 
-    // update offset
+    // update offsets
     this->_drawOffsets();
 }
 
@@ -211,7 +216,7 @@ void PacketDataView::_setDataXAndRowSize()
     if (_isOffsetInHex) {
         std::sprintf(buf.data(), "%llx", maxOffset);
     } else {
-        std::strcpy(buf.data(), utils::sepNumber(maxOffset).c_str());
+        utils::formatDecimal(buf.data(), maxOffset, ' ');
     }
 
     const auto offsetWidth = std::strlen(buf.data());
@@ -253,27 +258,12 @@ void PacketDataView::_setDataXAndRowSize()
     _rowSize = DataSize::fromBytes(bytesPerRow);
 }
 
-void PacketDataView::_drawSeparators() const
+void PacketDataView::_drawSeparators(const Index y) const
 {
-    if (!_state->hasActivePacketState()) {
-        return;
-    }
-
-    const auto endOffsetInPacketBits = _endOffsetInPacketBits + _rowSize.bits() - 1;
-    const auto yEnd = (endOffsetInPacketBits - _baseOffsetInPacketBits) /
-                      _rowSize.bits();
-
     this->_stylist().stdDim(*this);
+    this->_putChar({_dataX - 1, y}, ACS_VLINE);
 
-    for (Index y = 0; y < yEnd; ++y) {
-        this->_putChar({_dataX - 1, y}, ACS_VLINE);
-    }
-
-    if (!_isAsciiVisible) {
-        return;
-    }
-
-    for (Index y = 0; y < yEnd; ++y) {
+    if (_isAsciiVisible) {
         this->_putChar({_asciiCharsX - 1, y}, ACS_VLINE);
     }
 }
@@ -284,64 +274,69 @@ void PacketDataView::_drawOffsets() const
         return;
     }
 
+    for (Index y = 0; y < this->contentRect().h; ++y) {
+        this->_drawOffset(y);
+    }
+}
+
+void PacketDataView::_drawOffset(const Index y) const
+{
     assert(_dataX > 0 && _rowSize > 0);
 
     const auto &curRegionSegment = _state->currentPacketRegion()->segment();
     const auto& packetTotalSize = _state->activePacketState().packetIndexEntry().effectiveTotalSize();
     const auto maxOffsetWidth = _dataX - 1;
-    auto offsetInPacketBits = _baseOffsetInPacketBits;
+    const auto offsetInPacketBits = _baseOffsetInPacketBits + y * _rowSize.bits();
     const Size div = _isOffsetInBytes ? 8 : 1;
 
-    for (Index y = 0; y < this->contentRect().h; ++y) {
-        if (offsetInPacketBits >= packetTotalSize) {
-            // clear
-            for (Index x = 0; x < _dataX - 1; ++x) {
-                this->_putChar({x, y}, ' ');
-            }
-        } else {
-            std::array<char, 32> buf;
-            Index dispOffsetInPacketBits = offsetInPacketBits;
+    if (offsetInPacketBits >= packetTotalSize) {
+        // clear
+        for (Index x = 0; x < _dataX - 1; ++x) {
+            this->_putChar({x, y}, ' ');
+        }
 
-            if (!_isOffsetInPacket) {
-                dispOffsetInPacketBits += _state->activePacketState().packetIndexEntry().offsetInDataStreamFileBits();
-            }
+        return;
+    }
 
-            dispOffsetInPacketBits /= div;
+    std::array<char, 32> buf;
+    Index dispOffsetInPacketBits = offsetInPacketBits;
 
-            if (_isOffsetInHex) {
-                std::sprintf(buf.data(), "%llx", dispOffsetInPacketBits);
-            } else {
-                std::strcpy(buf.data(),
-                            utils::sepNumber(dispOffsetInPacketBits, ',').c_str());
-            }
+    if (!_isOffsetInPacket) {
+        dispOffsetInPacketBits += _state->activePacketState().packetIndexEntry().offsetInDataStreamFileBits();
+    }
 
-            const auto offsetWidth = std::strlen(buf.data());
+    dispOffsetInPacketBits /= div;
 
-            this->_moveCursor({0, y});
+    if (_isOffsetInHex) {
+        std::sprintf(buf.data(), "%llx", dispOffsetInPacketBits);
+    } else {
+        utils::formatDecimal(buf.data(), dispOffsetInPacketBits, ',');
+    }
 
-            const auto curRegionBaseOffsetBits = curRegionSegment.offsetInPacketBits() -
-                                                 curRegionSegment.offsetInPacketBits() % _rowSize.bits();
+    const auto offsetWidth = std::strlen(buf.data());
 
-            assert(curRegionSegment.endOffsetInPacketBits());
+    this->_moveCursor({0, y});
 
-            const auto curRegionBaseEndOffsetBits = (*curRegionSegment.endOffsetInPacketBits() - 1) -
-                                                    (*curRegionSegment.endOffsetInPacketBits() - 1) % _rowSize.bits();
+    const auto curRegionBaseOffsetBits = curRegionSegment.offsetInPacketBits() -
+                                         curRegionSegment.offsetInPacketBits() % _rowSize.bits();
 
-            assert(curRegionBaseEndOffsetBits >= curRegionBaseOffsetBits);
+    assert(curRegionSegment.endOffsetInPacketBits());
 
-            const auto selected = offsetInPacketBits >= curRegionBaseOffsetBits &&
-                                  offsetInPacketBits <= curRegionBaseEndOffsetBits;
+    const auto curRegionBaseEndOffsetBits = (*curRegionSegment.endOffsetInPacketBits() - 1) -
+                                            (*curRegionSegment.endOffsetInPacketBits() - 1) % _rowSize.bits();
 
-            this->_stylist().packetDataViewOffset(*this, selected);
+    assert(curRegionBaseEndOffsetBits >= curRegionBaseOffsetBits);
 
-            for (Index x = 0; x < maxOffsetWidth - offsetWidth; ++x) {
-                this->_appendChar(' ');
-            }
+    const auto selected = offsetInPacketBits >= curRegionBaseOffsetBits &&
+                          offsetInPacketBits <= curRegionBaseEndOffsetBits;
 
-            this->_print("%s", buf.data());
-            offsetInPacketBits += _rowSize.bits();
-        }
+    this->_stylist().packetDataViewOffset(*this, selected);
+
+    for (Index x = 0; x < maxOffsetWidth - offsetWidth; ++x) {
+        this->_appendChar(' ');
     }
+
+    this->_print("%s", buf.data());
 }
 
 void PacketDataView::_setTitle()
@@ -375,75 +370,60 @@ void PacketDataView::_setTitle()
     this->_decorate();
 }
 
-void PacketDataView::_setCustomStyle(const _Char& ch) const
+void PacketDataView::_setCustomStyle(const _Chars& chars,
+                                     const Index index) const
 {
-    if (ch.packetRegions.size() != 1) {
-        if (ch.isPrintable) {
-            this->_stylist().std(*this);
-        } else {
-            this->_stylist().stdDim(*this);
-        }
-
-        return;
-    }
-
-    const auto it = _bookmarks->find(_state->activeDataStreamFileStateIndex());
-    const InspectScreen::PacketBookmarks *bookmarks = nullptr;
-
-    if (it != std::end(*_bookmarks)) {
-        const auto& dataStreamFileBookmarks = it->second;
-        const auto pIt = dataStreamFileBookmarks.find(_state->activeDataStreamFileState().activePacketStateIndex());
-
-        if (pIt != std::end(dataStreamFileBookmarks)) {
-            bookmarks = &pIt->second;
-        }
+    switch (chars.styles[index]) {
+    case _CharStyle::STD:
+        this->_stylist().std(*this);
+        break;
+
+    case _CharStyle::STD_DIM:
+        this->_stylist().stdDim(*this);
+        break;
+
+    case _CharStyle::EVENT_RECORD_FIRST:
+        this->_stylist().packetDataViewEventRecordFirstPacketRegion(*this);
+        break;
+
+    case _CharStyle::PADDING:
+        this->_stylist().packetDataViewPadding(*this);
+        break;
+
+    case _CharStyle::ERROR:
+        this->_stylist().error(*this);
+        break;
+
+    case _CharStyle::BOOKMARK:
+    {
+        const auto id = this->_bookmarkId(chars.firstPacketRegionOffsets[index]);
+
+        assert(id);
+        this->_stylist().packetDataViewBookmark(*this, *id);
+        break;
     }
 
-    bool bookmark = false;
-    const auto& singlePacketRegion = *ch.packetRegions.front();
-
-    if (bookmarks) {
-        for (Index id = 0; id < bookmarks->size(); ++id) {
-            if (bookmarks->at(id) &&
-                    *(bookmarks->at(id)) == singlePacketRegion.segment().offsetInPacketBits()) {
-                this->_stylist().packetDataViewBookmark(*this, id);
-                bookmark = true;
-                break;
-            }
-        }
-    }
-
-    if (!bookmark) {
-        if (ch.isEventRecordFirst && _isEventRecordFirstPacketRegionEmphasized) {
-            this->_stylist().packetDataViewEventRecordFirstPacketRegion(*this);
-        } else if (const auto region = dynamic_cast<const ContentPacketRegion *>(&singlePacketRegion)) {
-            if (ch.isPrintable) {
-                this->_stylist().std(*this);
-            } else {
-                this->_stylist().stdDim(*this);
-            }
-        } else if (const auto region = dynamic_cast<const PaddingPacketRegion *>(&singlePacketRegion)) {
-            this->_stylist().packetDataViewPadding(*this);
-        } else if (const auto region = dynamic_cast<const ErrorPacketRegion *>(&singlePacketRegion)) {
-            this->_stylist().error(*this);
-        } else {
-            std::abort();
-        }
+    default:
+        std::abort();
     }
 }
 
-void PacketDataView::_drawUnselectedChar(const _Char& ch) const
+void PacketDataView::_drawUnselectedChar(const _Chars& chars,
+                                         const Index index,
+                                         const Index y) const
 {
-    this->_setCustomStyle(ch);
-    this->_putChar(ch.pt, ch.value);
+    this->_setCustomStyle(chars, index);
+    this->_putChar({chars.xs[index], y}, chars.values[index]);
 }
 
-void PacketDataView::_drawChar(const _Char& ch) const
+void PacketDataView::_drawChar(const _Chars& chars, const Index index,
+                               const Index y) const
 {
-    auto selectedPacketRegionIt = ch.packetRegionIt(_curOffsetInPacketBits);
+    const Point pt {chars.xs[index], y};
+    const auto hasSinglePacketRegion = chars.hasSinglePacketRegion(index);
 
-    if (selectedPacketRegionIt != std::end(ch.packetRegions)) {
-        if (ch.packetRegions.size() == 1) {
+    if (chars.hasPacketRegion(index, _curOffsetInPacketBits)) {
+        if (hasSinglePacketRegion) {
             this->_stylist().packetDataViewSelection(*this,
                                                      Stylist::PacketDataViewSelectionType::CURRENT);
         } else {
@@ -451,69 +431,72 @@ void PacketDataView::_drawChar(const _Char& ch) const
                                                         Stylist::PacketDataViewSelectionType::CURRENT);
         }
 
-        this->_putChar(ch.pt, ch.value);
+        this->_putChar(pt, chars.values[index]);
         return;
     }
 
-    if (ch.packetRegions.size() != 1) {
-        this->_drawUnselectedChar(ch);
+    if (!hasSinglePacketRegion) {
+        this->_drawUnselectedChar(chars, index, y);
         return;
     }
 
-    const auto& singlePacketRegion = *ch.packetRegions.front();
-
-    if (_isPrevNextVisible) {
-        if (_prevOffsetInPacketBits &&
-                *_prevOffsetInPacketBits == singlePacketRegion.segment().offsetInPacketBits()) {
+    if (_isPrevNextVisible && !_isDegraded) {
+        if (chars.hasPacketRegion(index, _prevOffsetInPacketBits)) {
             this->_stylist().packetDataViewSelection(*this,
                                                      Stylist::PacketDataViewSelectionType::PREVIOUS);
-            this->_putChar(ch.pt, ch.value);
+            this->_putChar(pt, chars.values[index]);
             return;
         }
 
-        if (_nextOffsetInPacketBits &&
-                *_nextOffsetInPacketBits == singlePacketRegion.segment().offsetInPacketBits()) {
+        if (chars.hasPacketRegion(index, _nextOffsetInPacketBits)) {
             this->_stylist().packetDataViewSelection(*this,
                                                      Stylist::PacketDataViewSelectionType::NEXT);
-            this->_putChar(ch.pt, ch.value);
+            this->_putChar(pt, chars.values[index]);
             return;
         }
     }
 
-    this->_drawUnselectedChar(ch);
+    this->_drawUnselectedChar(chars, index, y);
 }
 
-void PacketDataView::_drawAllNumericChars() const
+void PacketDataView::_drawRow(const Index y) const
 {
-    for (const auto& ch : _chars) {
-        this->_drawChar(ch);
+    const auto& row = _rows[y];
+
+    this->_drawOffset(y);
+    this->_drawSeparators(y);
+
+    for (Index index = 0; index < row.numericChars.size(); ++index) {
+        this->_drawChar(row.numericChars, index, y);
     }
-}
 
-void PacketDataView::_drawAllAsciiChars() const
-{
-    if (!_isAsciiVisible) {
+    if (!_isAsciiVisible || _isDegraded) {
         return;
     }
 
-    for (const auto& ch : _asciiChars) {
-        this->_drawChar(ch);
+    for (Index index = 0; index < row.asciiChars.size(); ++index) {
+        this->_drawChar(row.asciiChars, index, y);
     }
 }
 
 void PacketDataView::_redrawContent()
 {
     this->_clearContent();
+    _rows.clear();
 
     if (!_state->hasActivePacketState()) {
         return;
     }
 
-    this->_drawOffsets();
-    this->_drawSeparators();
-    this->_setNumericCharsAndAsciiChars();
-    this->_drawAllNumericChars();
-    this->_drawAllAsciiChars();
+    auto rows = this->_createRows(_baseOffsetInPacketBits,
+                                  _endOffsetInPacketBits);
+
+    std::move(std::begin(rows), std::end(rows), std::back_inserter(_rows));
+
+    for (Index y = 0; y < _rows.size(); ++y) {
+        this->_drawRow(y);
+    }
+
     this->_hasMoreTop(_baseOffsetInPacketBits != 0);
 
     const auto effectiveTotalSizeBits = _state->activePacketState().packet().indexEntry().effectiveTotalSize();
@@ -521,64 +504,143 @@ void PacketDataView::_redrawContent()
     this->_hasMoreBottom(_endOffsetInPacketBits < effectiveTotalSizeBits);
 }
 
-static inline chtype charFromNibble(const std::uint8_t nibble)
+void PacketDataView::_scrollToBaseOffsetInPacketBits(const Index baseOffsetInPacketBits)
 {
-    if (nibble < 10) {
-        return '0' + nibble;
-    } else {
-        return 'a' + nibble - 10;
+    assert(_state->hasActivePacketState());
+    assert(baseOffsetInPacketBits % _rowSize.bits() == 0);
+
+    if (baseOffsetInPacketBits == _baseOffsetInPacketBits && !_rows.empty()) {
+        return;
     }
-}
 
-void PacketDataView::_setHexChars()
-{
-    /*
-     * The strategy here is to create all the nibble characters first,
-     * and then iterate the packet regions and find the already-created
-     * character to append a packet region (if not already appended).
-     */
-    const auto data = _state->activePacketState().packet().data(_baseOffsetInPacketBits / 8);
+    const auto oldBaseOffsetInPacketBits = _baseOffsetInPacketBits;
+    const Size oldRowCount = _rows.size();
+
+    _baseOffsetInPacketBits = baseOffsetInPacketBits;
+    this->_setEndOffsetInPacketBitsFromBaseOffset();
+
+    const auto rowSizeBits = _rowSize.bits();
+    const auto pageRowCount = this->contentRect().h;
+    const auto rowDiff = (std::max(baseOffsetInPacketBits, oldBaseOffsetInPacketBits) -
+                          std::min(baseOffsetInPacketBits, oldBaseOffsetInPacketBits)) /
+                         rowSizeBits;
+
+    if (_rows.empty() || rowDiff >= pageRowCount) {
+        // nothing to keep
+        this->_redrawContent();
+        return;
+    }
+
+    Index firstNewY;
+    Index endNewY;
+
+    if (baseOffsetInPacketBits > oldBaseOffsetInPacketBits) {
+        // scrolling down: rows leave at the top
+        this->_scrollContent(static_cast<long long>(rowDiff));
+        _rows.erase(std::begin(_rows), std::begin(_rows) + std::min(rowDiff, oldRowCount));
+        firstNewY = _rows.size();
+
+        auto rows = this->_createRows(baseOffsetInPacketBits + firstNewY * rowSizeBits,
+                                      _endOffsetInPacketBits);
+
+        std::move(std::begin(rows), std::end(rows), std::back_inserter(_rows));
+        endNewY = _rows.size();
+    } else {
+        // scrolling up: rows leave at the bottom
+        this->_scrollContent(-static_cast<long long>(rowDiff));
+
+        const auto keptRowCount = std::min(oldRowCount, pageRowCount - rowDiff);
 
-    for (auto offsetInPacketBits = _baseOffsetInPacketBits;
-            offsetInPacketBits < _endOffsetInPacketBits;
-            offsetInPacketBits += 8) {
-        const auto byte = data[(offsetInPacketBits - _baseOffsetInPacketBits) / 8];
-        const auto y = (offsetInPacketBits - _baseOffsetInPacketBits) /
-                       _rowSize.bits();
-        const auto byteIndexInRow = (offsetInPacketBits % _rowSize.bits()) / 8;
+        _rows.erase(std::begin(_rows) + keptRowCount, std::end(_rows));
 
-        // high nibble
-        {
-            _Char ch;
+        auto rows = this->_createRows(baseOffsetInPacketBits,
+                                      oldBaseOffsetInPacketBits);
 
-            ch.pt.y = y;
-            ch.pt.x = _dataX + byteIndexInRow * 3;
+        std::move(std::rbegin(rows), std::rend(rows), std::front_inserter(_rows));
+        firstNewY = 0;
+        endNewY = rows.size();
+    }
 
-            const auto nibble = (byte >> 4) & 0xf;
+    // draw exposed rows only
+    for (Index y = firstNewY; y < endNewY; ++y) {
+        this->_stylist().std(*this);
+        this->_putChar({0, y}, ' ');
 
-            ch.value = charFromNibble(nibble);
-            _chars.push_back(std::move(ch));
+        for (Index x = 1; x < this->contentRect().w; ++x) {
+            this->_appendChar(' ');
         }
 
-        // low nibble
-        {
-            _Char ch;
+        this->_drawRow(y);
+    }
+
+    // exposed lines without data (end of packet)
+    for (Index y = _rows.size(); y < pageRowCount; ++y) {
+        this->_drawOffset(y);
+    }
+
+    this->_hasMoreTop(_baseOffsetInPacketBits != 0);
+
+    const auto effectiveTotalSizeBits = _state->activePacketState().packet().indexEntry().effectiveTotalSize();
+
+    this->_hasMoreBottom(_endOffsetInPacketBits < effectiveTotalSizeBits);
+}
 
-            ch.pt.y = y;
-            ch.pt.x = _dataX + byteIndexInRow * 3 + 1;
+/*
+ * Hexadecimal digits (high nibble first) of each possible byte value:
+ * converting a byte is a single table lookup instead of two nibble
+ * conversions with branches.
+ */
+static const auto byteHexDigits = []() {
+    std::array<std::array<chtype, 2>, 256> digits;
+    constexpr char nibbleDigits[] = "0123456789abcdef";
 
-            const auto nibble = byte & 0xf;
+    for (unsigned int byte = 0; byte < 256; ++byte) {
+        digits[byte][0] = nibbleDigits[byte >> 4];
+        digits[byte][1] = nibbleDigits[byte & 0xf];
+    }
 
-            ch.value = charFromNibble(nibble);
-            _chars.push_back(std::move(ch));
+    return digits;
+}();
+
+boost::optional<unsigned int> PacketDataView::_bookmarkId(const Index offsetInPacketBits) const
+{
+    const auto it = _bookmarks->find(_state->activeDataStreamFileStateIndex());
+
+    if (it == std::end(*_bookmarks)) {
+        return boost::none;
+    }
+
+    const auto& dataStreamFileBookmarks = it->second;
+    const auto pIt = dataStreamFileBookmarks.find(_state->activeDataStreamFileState().activePacketStateIndex());
+
+    if (pIt == std::end(dataStreamFileBookmarks)) {
+        return boost::none;
+    }
+
+    const auto& bookmarks = pIt->second;
+
+    for (Index id = 0; id < bookmarks.size(); ++id) {
+        if (bookmarks[id] && *bookmarks[id] == offsetInPacketBits) {
+            return static_cast<unsigned int>(id);
         }
     }
 
+    return boost::none;
+}
+
+PacketDataView::_PacketRegionInfos PacketDataView::_packetRegionInfos(const std::vector<PacketRegion::SPC>& packetRegions) const
+{
     const EventRecord *curEventRecord = nullptr;
+    _PacketRegionInfos infos;
+
+    infos.reserve(packetRegions.size());
+
+    for (const auto& packetRegion : packetRegions) {
+        _PacketRegionInfo info;
 
-    for (auto& packetRegion : _packetRegions) {
-        const auto bitArray = _state->activePacketState().packet().bitArray(*packetRegion);
-        const auto firstBitOffsetInPacket = packetRegion->segment().offsetInPacketBits();
+        info.offsetInPacketBits = packetRegion->segment().offsetInPacketBits();
+        info.endOffsetInPacketBits = info.offsetInPacketBits +
+                                     packetRegion->segment().size()->bits();
 
         bool isEventRecordFirst = false;
 
@@ -588,203 +650,306 @@ void PacketDataView::_setHexChars()
             isEventRecordFirst = true;
         }
 
-        const auto startOffsetInPacketBits = std::max(firstBitOffsetInPacket,
-                                                      _baseOffsetInPacketBits);
-        const auto endOffsetInPacketBits = std::min(firstBitOffsetInPacket +
-                                                    packetRegion->segment().size()->bits(),
-                                                    _endOffsetInPacketBits);
+        if (this->_bookmarkId(info.offsetInPacketBits)) {
+            info.style = _CharStyle::BOOKMARK;
+        } else if (isEventRecordFirst && _isEventRecordFirstPacketRegionEmphasized) {
+            info.style = _CharStyle::EVENT_RECORD_FIRST;
+        } else if (dynamic_cast<const ContentPacketRegion *>(packetRegion.get())) {
+            info.style = _CharStyle::STD;
+        } else if (dynamic_cast<const PaddingPacketRegion *>(packetRegion.get())) {
+            info.style = _CharStyle::PADDING;
+        } else if (dynamic_cast<const ErrorPacketRegion *>(packetRegion.get())) {
+            info.style = _CharStyle::ERROR;
+        } else {
+            std::abort();
+        }
 
-        for (Index bitOffsetInPacket = startOffsetInPacketBits;
-                bitOffsetInPacket < endOffsetInPacketBits;
-                ++bitOffsetInPacket) {
-            const auto indexInBitArray = bitOffsetInPacket -
-                                         firstBitOffsetInPacket;
+        infos.push_back(info);
+    }
 
-            // times two because `_chars` contains nibbles, not bytes
-            auto charIndex = ((bitOffsetInPacket / 8) -
-                              (_baseOffsetInPacketBits / 8)) * 2;
-            const auto bitLoc = bitArray.bitLocation(indexInBitArray);
+    return infos;
+}
 
-            if (bitLoc.bitIndexInByte() < 4) {
-                // low nibble
-                charIndex += 1;
-            }
+void PacketDataView::_setHexChars(_Chars& chars, const Index offsetInPacketBits,
+                                  const Index endOffsetInPacketBits,
+                                  const std::vector<PacketRegion::SPC>& packetRegions,
+                                  const _PacketRegionInfos& infos,
+                                  const Index firstInfoIndex) const
+{
+    /*
+     * The strategy here is to create all the nibble characters first,
+     * and then iterate the packet regions and link each one to the
+     * span of already-created characters it covers.
+     */
+    const auto& packet = _state->activePacketState().packet();
+    const auto data = packet.data(offsetInPacketBits / 8);
+    const auto byteCount = (endOffsetInPacketBits - offsetInPacketBits + 7) / 8;
+
+    chars.resize(byteCount * 2);
+
+    for (Index byteIndex = 0; byteIndex < byteCount; ++byteIndex) {
+        const auto& digits = byteHexDigits[data[byteIndex]];
+        const auto x = _dataX + byteIndex * 3;
 
-            assert(charIndex < _chars.size());
+        // high nibble, then low nibble
+        chars.values[byteIndex * 2] = digits[0];
+        chars.values[byteIndex * 2 + 1] = digits[1];
+        chars.xs[byteIndex * 2] = x;
+        chars.xs[byteIndex * 2 + 1] = x + 1;
+    }
+
+    const auto baseByteIndex = offsetInPacketBits / 8;
+
+    for (auto infoIndex = firstInfoIndex; infoIndex < infos.size(); ++infoIndex) {
+        const auto& info = infos[infoIndex];
+
+        if (info.offsetInPacketBits >= endOffsetInPacketBits) {
+            break;
+        }
 
-            // get existing character (created above)
-            auto& ch = _chars[charIndex];
+        const auto startOffsetInPacketBits = std::max(info.offsetInPacketBits,
+                                                      offsetInPacketBits);
+        const auto regionEndOffsetInPacketBits = std::min(info.endOffsetInPacketBits,
+                                                          endOffsetInPacketBits);
+
+        if (startOffsetInPacketBits >= regionEndOffsetInPacketBits) {
+            continue;
+        }
 
-            ch.isEventRecordFirst = isEventRecordFirst;
+        auto bitOffsetInPacket = startOffsetInPacketBits;
 
-            if (ch.packetRegions.empty() ||
-                    ch.packetRegions.back() != packetRegion.get()) {
-                // associate character to packet region
-                ch.packetRegions.push_back(packetRegion.get());
+        while (bitOffsetInPacket < regionEndOffsetInPacketBits) {
+            // times two because `chars` contains nibbles, not bytes
+            const auto charIndex = (bitOffsetInPacket / 8 - baseByteIndex) * 2;
+
+            if ((bitOffsetInPacket & 7) == 0 &&
+                    regionEndOffsetInPacketBits - bitOffsetInPacket >= 8) {
+                // whole bytes: both nibbles of each byte
+                const auto wholeByteCount = (regionEndOffsetInPacketBits -
+                                             bitOffsetInPacket) / 8;
+
+                chars.addPacketRegion(charIndex, charIndex + wholeByteCount * 2,
+                                      info);
+                bitOffsetInPacket += wholeByteCount * 8;
+                continue;
             }
+
+            // partial byte: the nibble depends on the bit order
+            const auto bitArray = packet.bitArray(*packetRegions[infoIndex]);
+            const auto bitLoc = bitArray.bitLocation(bitOffsetInPacket -
+                                                     info.offsetInPacketBits);
+            const auto nibbleCharIndex = charIndex +
+                                         (bitLoc.bitIndexInByte() < 4 ? 1 : 0);
+
+            assert(nibbleCharIndex < chars.size());
+            chars.addPacketRegion(nibbleCharIndex, nibbleCharIndex + 1, info);
+            ++bitOffsetInPacket;
         }
     }
 }
 
-void PacketDataView::_setAsciiChars()
+void PacketDataView::_setAsciiChars(_Chars& chars, const Index offsetInPacketBits,
+                                    const Index endOffsetInPacketBits,
+                                    const _PacketRegionInfos& infos,
+                                    const Index firstInfoIndex) const
 {
     /*
      * Similar strategy to what we're doing in _setHexChars(), only here
      * the characters represent whole bytes, not nibbles.
      */
-    assert((_baseOffsetInPacketBits & 7) == 0);
+    assert((offsetInPacketBits & 7) == 0);
 
-    const auto& packet = _state->activePacketState().packet();
+    const auto data = _state->activePacketState().packet().data(offsetInPacketBits / 8);
+    const auto byteCount = (endOffsetInPacketBits - offsetInPacketBits + 7) / 8;
 
-    for (auto offsetInPacketBits = _baseOffsetInPacketBits;
-            offsetInPacketBits < _endOffsetInPacketBits; offsetInPacketBits += 8) {
-        _Char ch;
+    chars.resize(byteCount);
 
-        ch.pt.y = (offsetInPacketBits - _baseOffsetInPacketBits) /
-                  _rowSize.bits();
-        ch.pt.x = _asciiCharsX + (offsetInPacketBits % _rowSize.bits()) / 8;
+    for (Index byteIndex = 0; byteIndex < byteCount; ++byteIndex) {
+        const char value = static_cast<char>(data[byteIndex]);
 
-        const char value = static_cast<chtype>(*packet.data(offsetInPacketBits / 8));
+        chars.xs[byteIndex] = _asciiCharsX + byteIndex;
 
         if (!std::isprint(value)) {
-            ch.isPrintable = false;
-            ch.value = ACS_BULLET;
+            chars.isPrintable[byteIndex] = 0;
+            chars.styles[byteIndex] = _CharStyle::STD_DIM;
+            chars.values[byteIndex] = ACS_BULLET;
         } else {
-            ch.value = value;
+            chars.values[byteIndex] = value;
         }
-
-        _asciiChars.push_back(std::move(ch));
     }
 
-    const EventRecord *curEventRecord = nullptr;
+    const auto baseByteIndex = offsetInPacketBits / 8;
 
-    for (const auto& packetRegion : _packetRegions) {
-        const auto firstBitOffsetInPacket = packetRegion->segment().offsetInPacketBits();
+    for (auto infoIndex = firstInfoIndex; infoIndex < infos.size(); ++infoIndex) {
+        const auto& info = infos[infoIndex];
 
-        bool isEventRecordFirst = false;
+        if (info.offsetInPacketBits >= endOffsetInPacketBits) {
+            break;
+        }
 
-        if (packetRegion->scope() && packetRegion->scope()->eventRecord() &&
-                packetRegion->scope()->eventRecord() != curEventRecord) {
-            curEventRecord = packetRegion->scope()->eventRecord();
-            isEventRecordFirst = true;
+        const auto startOffsetInPacketBits = std::max(info.offsetInPacketBits,
+                                                      offsetInPacketBits);
+        const auto regionEndOffsetInPacketBits = std::min(info.endOffsetInPacketBits,
+                                                          endOffsetInPacketBits);
+
+        if (startOffsetInPacketBits >= regionEndOffsetInPacketBits) {
+            continue;
         }
 
-        const auto startOffsetInPacketBits = std::max(firstBitOffsetInPacket,
-                                                      _baseOffsetInPacketBits);
-        const auto endOffsetInPacketBits = std::min(firstBitOffsetInPacket +
-                                                    packetRegion->segment().size()->bits(),
-                                                    _endOffsetInPacketBits);
+        const auto beginCharIndex = startOffsetInPacketBits / 8 - baseByteIndex;
+        const auto endCharIndex = (regionEndOffsetInPacketBits - 1) / 8 -
+                                  baseByteIndex + 1;
 
-        for (Index bitOffsetInPacket = startOffsetInPacketBits;
-                bitOffsetInPacket < endOffsetInPacketBits;
-                ++bitOffsetInPacket) {
-            const auto charIndex = ((bitOffsetInPacket / 8) -
-                                    (_baseOffsetInPacketBits / 8));
+        assert(endCharIndex <= chars.size());
+        chars.addPacketRegion(beginCharIndex, endCharIndex, info);
+    }
+}
 
-            assert(charIndex < _asciiChars.size());
+void PacketDataView::_setBinaryChars(_Chars& chars, const Index offsetInPacketBits,
+                                     const Index endOffsetInPacketBits,
+                                     const std::vector<PacketRegion::SPC>& packetRegions,
+                                     const _PacketRegionInfos& infos,
+                                     const Index firstInfoIndex) const
+{
+    const auto& packet = _state->activePacketState().packet();
+    Size charCount = 0;
 
-            // get existing character (created above)
-            auto& ch = _asciiChars[charIndex];
+    for (auto infoIndex = firstInfoIndex; infoIndex < infos.size(); ++infoIndex) {
+        const auto& info = infos[infoIndex];
+        const auto startOffsetInPacketBits = std::max(info.offsetInPacketBits,
+                                                      offsetInPacketBits);
+        const auto regionEndOffsetInPacketBits = std::min(info.endOffsetInPacketBits,
+                                                          endOffsetInPacketBits);
 
-            ch.isEventRecordFirst = isEventRecordFirst;
+        if (info.offsetInPacketBits >= endOffsetInPacketBits) {
+            break;
+        }
 
-            if (ch.packetRegions.empty() ||
-                    ch.packetRegions.back() != packetRegion.get()) {
-                // associate character to packet region
-                ch.packetRegions.push_back(packetRegion.get());
-            }
+        if (startOffsetInPacketBits < regionEndOffsetInPacketBits) {
+            charCount += regionEndOffsetInPacketBits - startOffsetInPacketBits;
         }
     }
-}
 
-void PacketDataView::_setBinaryChars()
-{
-    const EventRecord *curEventRecord = nullptr;
+    chars.resize(charCount);
 
-    for (const auto& packetRegion : _packetRegions) {
-        const auto bitArray = _state->activePacketState().packet().bitArray(*packetRegion);
-        const auto firstBitOffsetInPacket = packetRegion->segment().offsetInPacketBits();
-        bool isEventRecordFirst = false;
+    Index charIndex = 0;
 
-        if (packetRegion->scope() && packetRegion->scope()->eventRecord() &&
-                packetRegion->scope()->eventRecord() != curEventRecord) {
-            curEventRecord = packetRegion->scope()->eventRecord();
-            isEventRecordFirst = true;
+    for (auto infoIndex = firstInfoIndex; infoIndex < infos.size(); ++infoIndex) {
+        const auto& info = infos[infoIndex];
+
+        if (info.offsetInPacketBits >= endOffsetInPacketBits) {
+            break;
+        }
+
+        const auto startOffsetInPacketBits = std::max(info.offsetInPacketBits,
+                                                      offsetInPacketBits);
+        const auto regionEndOffsetInPacketBits = std::min(info.endOffsetInPacketBits,
+                                                          endOffsetInPacketBits);
+
+        if (startOffsetInPacketBits >= regionEndOffsetInPacketBits) {
+            continue;
         }
 
-        const auto startOffsetInPacketBits = std::max(firstBitOffsetInPacket,
-                                                      _baseOffsetInPacketBits);
-        const auto endOffsetInPacketBits = std::min(firstBitOffsetInPacket +
-                                                    packetRegion->segment().size()->bits(),
-                                                    _endOffsetInPacketBits);
+        const auto bitArray = packet.bitArray(*packetRegions[infoIndex]);
+        const auto regionCharIndex = charIndex;
 
         for (Index bitOffsetInPacket = startOffsetInPacketBits;
-                bitOffsetInPacket < endOffsetInPacketBits;
+                bitOffsetInPacket < regionEndOffsetInPacketBits;
                 ++bitOffsetInPacket) {
-            const auto indexInBitArray = bitOffsetInPacket -
-                                         firstBitOffsetInPacket;
-            _Char ch;
-            const auto bitLoc = bitArray.bitLocation(indexInBitArray);
+            const auto bitLoc = bitArray.bitLocation(bitOffsetInPacket -
+                                                     info.offsetInPacketBits);
+            const auto byteIndex = (bitOffsetInPacket - offsetInPacketBits) / 8;
 
-            ch.isEventRecordFirst = isEventRecordFirst;
-            ch.value = '0' + bitArray[bitLoc];
-            ch.pt.y = (bitOffsetInPacket - _baseOffsetInPacketBits) /
-                      _rowSize.bits();
-
-            const auto byteIndex = (bitOffsetInPacket % _rowSize.bits()) / 8;
+            chars.values[charIndex] = '0' + bitArray[bitLoc];
 
             /*
              * 28000 00101101 11010010 11101010 00010010
              *       ^ _dataX [6]      ^ + byteIndex * 9 [+ 2 * 9]
              *                              ^ + 7 - bitLoc.bitIndexInByte [+ 7 - 2]
              */
-            ch.pt.x = _dataX + byteIndex * 9 + 7 - bitLoc.bitIndexInByte();
-            ch.packetRegions.push_back(packetRegion.get());
-            _chars.push_back(std::move(ch));
+            chars.xs[charIndex] = _dataX + byteIndex * 9 + 7 -
+                                  bitLoc.bitIndexInByte();
+            ++charIndex;
         }
+
+        // a binary character always has a single packet region
+        chars.addPacketRegion(regionCharIndex, charIndex, info);
     }
 }
 
-void PacketDataView::_setNumericCharsAndAsciiChars()
+std::vector<PacketDataView::_Row> PacketDataView::_createRows(const Index offsetInPacketBits,
+                                                              const Index endOffsetInPacketBits) const
 {
-    if (_baseOffsetInPacketBits == _endOffsetInPacketBits) {
-        return;
+    std::vector<_Row> rows;
+
+    if (offsetInPacketBits >= endOffsetInPacketBits) {
+        return rows;
     }
 
-    assert(_baseOffsetInPacketBits < _endOffsetInPacketBits);
     assert(_state->hasActivePacketState());
+    assert(offsetInPacketBits % _rowSize.bits() == 0);
 
-    // set numeric characters
-    std::vector<PacketRegion::SPC> packetRegions;
     auto& packet = _state->activePacketState().packet();
 
     /*
      * We'll go one packet region before to detect an initial
      * event record change.
      */
-    const auto& basePacketRegion = packet.regionAtOffsetInPacketBits(_baseOffsetInPacketBits);
+    const auto& basePacketRegion = packet.regionAtOffsetInPacketBits(offsetInPacketBits);
     auto startingPacketRegion = packet.previousRegion(basePacketRegion);
 
     if (!startingPacketRegion) {
         startingPacketRegion = &basePacketRegion;
     }
 
-    _packetRegions.clear();
-    packet.appendRegions(_packetRegions,
+    std::vector<PacketRegion::SPC> packetRegions;
+
+    packet.appendRegions(packetRegions,
                          startingPacketRegion->segment().offsetInPacketBits(),
-                         _endOffsetInPacketBits);
-    assert(!_packetRegions.empty());
-    _chars.clear();
+                         endOffsetInPacketBits);
+    assert(!packetRegions.empty());
+
+    const auto infos = this->_packetRegionInfos(packetRegions);
+    Index firstInfoIndex = 0;
+
+    rows.reserve((endOffsetInPacketBits - offsetInPacketBits +
+                  _rowSize.bits() - 1) / _rowSize.bits());
+
+    for (auto rowOffsetInPacketBits = offsetInPacketBits;
+            rowOffsetInPacketBits < endOffsetInPacketBits;
+            rowOffsetInPacketBits += _rowSize.bits()) {
+        const auto rowEndOffsetInPacketBits = std::min(rowOffsetInPacketBits +
+                                                       _rowSize.bits(),
+                                                       endOffsetInPacketBits);
+
+        // skip packet regions which end before this row
+        while (firstInfoIndex < infos.size() &&
+                infos[firstInfoIndex].endOffsetInPacketBits <= rowOffsetInPacketBits) {
+            ++firstInfoIndex;
+        }
 
-    if (_isDataInHex) {
-        this->_setHexChars();
-    } else {
-        this->_setBinaryChars();
+        _Row row;
+
+        if (_isDataInHex) {
+            this->_setHexChars(row.numericChars, rowOffsetInPacketBits,
+                               rowEndOffsetInPacketBits, packetRegions, infos,
+                               firstInfoIndex);
+        } else {
+            this->_setBinaryChars(row.numericChars, rowOffsetInPacketBits,
+                                  rowEndOffsetInPacketBits, packetRegions,
+                                  infos, firstInfoIndex);
+        }
+
+        if (_isAsciiVisible && !_isDegraded) {
+            this->_setAsciiChars(row.asciiChars, rowOffsetInPacketBits,
+                                 rowEndOffsetInPacketBits, infos,
+                                 firstInfoIndex);
+        }
+
+        rows.push_back(std::move(row));
     }
 
-    // set ASCII chars
-    _asciiChars.clear();
-    this->_setAsciiChars();
+    return rows;
 }
 
 void PacketDataView::pageDown()
@@ -794,22 +959,21 @@ void PacketDataView::pageDown()
     }
 
     const auto effectiveTotalSizeBits = _state->activePacketState().packet().indexEntry().effectiveTotalSize().bits();
+    auto baseOffsetInPacketBits = _baseOffsetInPacketBits +
+                                  this->_halfPageSize().bits();
 
-    _baseOffsetInPacketBits += this->_halfPageSize().bits();
-
-    if (_baseOffsetInPacketBits >= effectiveTotalSizeBits) {
+    if (baseOffsetInPacketBits >= effectiveTotalSizeBits) {
         const auto endRowOffsetInPacketBits = effectiveTotalSizeBits -
                                               (effectiveTotalSizeBits % _rowSize.bits());
 
         if (endRowOffsetInPacketBits == 0) {
-            _baseOffsetInPacketBits = 0;
+            baseOffsetInPacketBits = 0;
         } else {
-            _baseOffsetInPacketBits = endRowOffsetInPacketBits - _rowSize.bits();
+            baseOffsetInPacketBits = endRowOffsetInPacketBits - _rowSize.bits();
         }
     }
 
-    this->_setEndOffsetInPacketBitsFromBaseOffset();
-    this->_redrawContent();
+    this->_scrollToBaseOffsetInPacketBits(baseOffsetInPacketBits);
 }
 
 void PacketDataView::pageUp()
@@ -819,15 +983,13 @@ void PacketDataView::pageUp()
     }
 
     const auto halfPageSize = this->_halfPageSize();
+    Index baseOffsetInPacketBits = 0;
 
-    if (_baseOffsetInPacketBits < halfPageSize.bits()) {
-        _baseOffsetInPacketBits = 0;
-    } else {
-        _baseOffsetInPacketBits -= halfPageSize.bits();
+    if (_baseOffsetInPacketBits >= halfPageSize.bits()) {
+        baseOffsetInPacketBits = _baseOffsetInPacketBits - halfPageSize.bits();
     }
 
-    this->_setEndOffsetInPacketBitsFromBaseOffset();
-    this->_redrawContent();
+    this->_scrollToBaseOffsetInPacketBits(baseOffsetInPacketBits);
 }
 
 void PacketDataView::isAsciiVisible(const bool isVisible)
@@ -848,6 +1010,20 @@ void PacketDataView::isPrevNextVisible(const bool isVisible)
     this->_redrawContent();
 }
 
+void PacketDataView::isDegraded(const bool isDegraded)
+{
+    if (isDegraded == _isDegraded) {
+        return;
+    }
+
+    _isDegraded = isDegraded;
+
+    if (!_isDegraded) {
+        // restore the decorations
+        this->_redrawContent();
+    }
+}
+
 void PacketDataView::isEventRecordFirstPacketRegionEmphasized(const bool isEmphasized)
 {
     _isEventRecordFirstPacketRegionEmphasized = isEmphasized;
@@ -10,8 +10,11 @@
 
 #include <vector>
 #include <list>
+#include <deque>
 #include <algorithm>
 #include <unordered_set>
+#include <cstdint>
+#include <limits>
 
 #include "view.hpp"
 #include "packet-region.hpp"
@@ -25,24 +28,33 @@ namespace jacques {
  * The view has a current base offset which is the offset of the first
  * visible bit/nibble (top left), if any.
  *
- * The view contains a current vector of character objects. A character
- * is linked to one or more packet regions. A character contains a point
- * and a value to print (e.g., `0`, `1`, `5`, `c`).
+ * The view contains the current rows (`_rows`): row `i` shows the data
+ * at `_baseOffsetInPacketBits + i * _rowSize`. A row contains numeric
+ * characters and ASCII characters (see `_Chars`). A character is linked
+ * to zero or more packet regions. A character has an X position, a
+ * value to print (e.g., `0`, `1`, `5`, `c`), and a base (unselected)
+ * style.
  *
- * The view builds character objects from the current packet's packet
- * regions with _setNumericCharsAndAsciiChars(). This method takes the
- * current base offset into account.
+ * The view builds rows from the current packet's packet regions with
+ * _createRows(). The current rows form a row cache: when the base
+ * offset changes by less than a page (page up/down, or the selection
+ * leaving the visible rows), _scrollToBaseOffsetInPacketBits() keeps
+ * the rows which remain visible, scrolls the terminal lines, and only
+ * creates and draws the newly exposed rows.
  *
  * A character can be linked to more than one packet regions in
  * hexadecimal display mode (when `_isHex` is true). This is because a
  * single nibble can contain up to four individual bits which belong to
- * different packet regions.
+ * different packet regions. Because packet regions are contiguous and
+ * sorted by offset, the packet regions of a character always form a
+ * span: a character only records the offsets of the first and last
+ * packet regions of this span. Selection tests are therefore span
+ * containment tests of the offsets of the selected packet regions.
  *
- * ASCII characters use the same character class. An ASCII character can
- * have its `isPrintable` property set to false, in which case the view
- * must print an alternative (printable) character with a different
- * style. Hex editors typically use `.` for this (we use `ACS_BULLET`, a
- * centered dot).
+ * ASCII characters use the same representation. An ASCII character can
+ * be marked as not printable, in which case the view must print an
+ * alternative (printable) character with a different style. Hex editors
+ * typically use `.` for this (we use `ACS_BULLET`, a centered dot).
  */
 class PacketDataView :
     public View
@@ -63,6 +75,16 @@ public:
     void isRowSizePowerOfTwo(bool isPowerOfTwo);
     void isOffsetInPacket(bool isOffsetInPacket);
 
+    /*
+     * Sets whether or not the view is degraded.
+     *
+     * A degraded view doesn't emphasize the previous/next packet
+     * regions and doesn't create or draw ASCII characters, keeping its
+     * layout. When the view becomes nondegraded, it redraws its whole
+     * content.
+     */
+    void isDegraded(bool isDegraded);
+
     bool isAsciiVisible() const noexcept
     {
         return _isAsciiVisible;
@@ -103,53 +125,165 @@ public:
         return _isOffsetInPacket;
     }
 
+    bool isDegraded() const noexcept
+    {
+        return _isDegraded;
+    }
+
     const DataSize& rowSize() const noexcept
     {
         return _rowSize;
     }
 
 private:
-    struct _Char
+    // style of a character when it's not selected
+    enum class _CharStyle : std::uint8_t
+    {
+        STD,
+        STD_DIM,
+        EVENT_RECORD_FIRST,
+        PADDING,
+        ERROR,
+        BOOKMARK,
+    };
+
+    // what the view needs to know about a packet region to create rows
+    struct _PacketRegionInfo
+    {
+        Index offsetInPacketBits;
+        Index endOffsetInPacketBits;
+
+        // unselected style of a printable character of this region
+        _CharStyle style;
+    };
+
+    /*
+     * Characters of a row as parallel arrays which always have the
+     * same size.
+     *
+     * Character `i` is located at `xs[i]`, has the value `values[i]`,
+     * and has the unselected style `styles[i]`.
+     *
+     * Character `i` is linked to the packet regions having an offset
+     * from `firstPacketRegionOffsets[i]` to `lastPacketRegionOffsets[i]`
+     * (inclusive), or to no packet region if
+     * `firstPacketRegionOffsets[i]` is `noPacketRegionOffset`.
+     */
+    struct _Chars
     {
-        auto packetRegionIt(const Index offsetInPacketBits) const
+        static constexpr Index noPacketRegionOffset = std::numeric_limits<Index>::max();
+
+        Size size() const noexcept
         {
-            return std::find_if(std::begin(packetRegions),
-                                std::end(packetRegions),
-                                [offsetInPacketBits](const auto& packetRegion) {
-                return packetRegion->segment().offsetInPacketBits() == offsetInPacketBits;
-            });
+            return values.size();
         }
 
-        Point pt;
-        chtype value;
-        std::vector<const PacketRegion *> packetRegions;
-        bool isEventRecordFirst = false;
-        bool isPrintable = true;
+        void resize(const Size size)
+        {
+            xs.resize(size);
+            values.resize(size);
+            styles.assign(size, _CharStyle::STD);
+            isPrintable.assign(size, 1);
+            firstPacketRegionOffsets.assign(size, noPacketRegionOffset);
+            lastPacketRegionOffsets.assign(size, noPacketRegionOffset);
+        }
+
+        bool hasSinglePacketRegion(const Index index) const noexcept
+        {
+            return firstPacketRegionOffsets[index] != noPacketRegionOffset &&
+                   firstPacketRegionOffsets[index] == lastPacketRegionOffsets[index];
+        }
+
+        bool hasPacketRegion(const Index index,
+                             const boost::optional<Index>& offsetInPacketBits) const noexcept
+        {
+            return offsetInPacketBits &&
+                   firstPacketRegionOffsets[index] != noPacketRegionOffset &&
+                   *offsetInPacketBits >= firstPacketRegionOffsets[index] &&
+                   *offsetInPacketBits <= lastPacketRegionOffsets[index];
+        }
+
+        /*
+         * Links the characters from `beginIndex` to `endIndex`
+         * (excluded) to the packet region described by `info`, updating
+         * their unselected style.
+         *
+         * Call this for packet regions in ascending offset order.
+         */
+        void addPacketRegion(const Index beginIndex, const Index endIndex,
+                             const _PacketRegionInfo& info) noexcept
+        {
+            for (auto index = beginIndex; index < endIndex; ++index) {
+                if (firstPacketRegionOffsets[index] == noPacketRegionOffset) {
+                    firstPacketRegionOffsets[index] = info.offsetInPacketBits;
+                    lastPacketRegionOffsets[index] = info.offsetInPacketBits;
+
+                    if (info.style != _CharStyle::STD) {
+                        styles[index] = info.style;
+                    }
+                } else if (lastPacketRegionOffsets[index] != info.offsetInPacketBits) {
+                    // more than one packet region: standard style
+                    lastPacketRegionOffsets[index] = info.offsetInPacketBits;
+                    styles[index] = isPrintable[index] ? _CharStyle::STD :
+                                    _CharStyle::STD_DIM;
+                }
+            }
+        }
+
+        std::vector<Index> xs;
+        std::vector<chtype> values;
+        std::vector<_CharStyle> styles;
+        std::vector<std::uint8_t> isPrintable;
+        std::vector<Index> firstPacketRegionOffsets;
+        std::vector<Index> lastPacketRegionOffsets;
     };
 
-    using _Chars = std::vector<_Char>;
+    struct _Row
+    {
+        _Chars numericChars;
+        _Chars asciiChars;
+    };
+
+    using _PacketRegionInfos = std::vector<_PacketRegionInfo>;
 
 private:
     void _stateChanged(Message msg) override;
     void _redrawContent() override;
     void _resized() override;
-    void _drawSeparators() const;
+    void _drawSeparators(Index y) const;
     void _drawOffsets() const;
+    void _drawOffset(Index y) const;
     void _setTitle();
-    void _setCustomStyle(const _Char& ch) const;
-    void _drawChar(const _Char& ch) const;
-    void _drawUnselectedChar(const _Char& ch) const;
-    void _drawAllNumericChars() const;
-    void _drawAllAsciiChars() const;
-    bool _isCharSelected(const _Char& ch) const;
+    void _setCustomStyle(const _Chars& chars, Index index) const;
+    void _drawChar(const _Chars& chars, Index index, Index y) const;
+    void _drawUnselectedChar(const _Chars& chars, Index index, Index y) const;
+    void _drawRow(Index y) const;
+    void _drawSelectedChars(bool isSelected) const;
+    bool _isCharSelected(const _Chars& chars, Index index) const;
     void _setDataXAndRowSize();
     void _updateSelection();
-    void _setHexChars();
-    void _setBinaryChars();
-    void _setAsciiChars();
-    void _setNumericCharsAndAsciiChars();
+    void _setHexChars(_Chars& chars, Index offsetInPacketBits,
+                      Index endOffsetInPacketBits,
+                      const std::vector<PacketRegion::SPC>& packetRegions,
+                      const _PacketRegionInfos& infos,
+                      Index firstInfoIndex) const;
+    void _setBinaryChars(_Chars& chars, Index offsetInPacketBits,
+                         Index endOffsetInPacketBits,
+                         const std::vector<PacketRegion::SPC>& packetRegions,
+                         const _PacketRegionInfos& infos,
+                         Index firstInfoIndex) const;
+    void _setAsciiChars(_Chars& chars, Index offsetInPacketBits,
+                        Index endOffsetInPacketBits,
+                        const _PacketRegionInfos& infos,
+                        Index firstInfoIndex) const;
+    _PacketRegionInfos _packetRegionInfos(const std::vector<PacketRegion::SPC>& packetRegions) const;
+    std::vector<_Row> _createRows(Index offsetInPacketBits,
+                                  Index endOffsetInPacketBits) const;
+    void _scrollToBaseOffsetInPacketBits(Index baseOffsetInPacketBits);
     void _setPrevCurNextOffsetInPacketBits();
     void _setBaseAndEndOffsetInPacketBitsFromOffset(Index offsetInPacketBits);
+    Index _centeredBaseOffsetInPacketBits(Index offsetInPacketBits) const;
+    boost::optional<unsigned int> _bookmarkId(Index offsetInPacketBits) const;
 
     void _setEndOffsetInPacketBitsFromBaseOffset() noexcept
     {
@@ -199,14 +333,8 @@ private:
     // offset of the first invisible bit (last visible bit's offset + 1)
     Index _endOffsetInPacketBits = 0;
 
-    // current numeric characters
-    _Chars _chars;
-
-    // current ASCII characters
-    _Chars _asciiChars;
-
-    // current packet regions (owned here)
-    std::vector<PacketRegion::SPC> _packetRegions;
+    // current rows (row cache), the first one being at the base offset
+    std::deque<_Row> _rows;
 
     boost::optional<Index> _prevOffsetInPacketBits;
     Index _curOffsetInPacketBits = 0;
@@ -219,6 +347,7 @@ private:
     bool _isOffsetInBytes = true;
     bool _isRowSizePowerOfTwo = true;
     bool _isOffsetInPacket = true;
+    bool _isDegraded = false;
 };
 
 } // namespace jacques
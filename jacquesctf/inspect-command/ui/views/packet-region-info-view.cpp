@@ -143,8 +143,17 @@ void PacketRegionInfoView::_redrawContent()
     }
 
     // value
-    if (cPacketRegion && cPacketRegion->value()) {
-        const auto& varVal = *cPacketRegion->value();
+    boost::optional<ContentPacketRegion::Value> value;
+
+    if (cPacketRegion) {
+        const auto& packet = _state->activePacketState().packet();
+
+        // decoded from the packet's data on demand
+        value = cPacketRegion->value(packet.bitArray(*cPacketRegion));
+    }
+
+    if (value) {
+        const auto& varVal = *value;
 
         this->_safePrint("    ");
         this->_stylist().packetRegionInfoViewValue(*this);
@@ -174,8 +183,8 @@ void PacketRegionInfoView::_redrawContent()
             }
         } else if (const auto val = boost::get<double>(&varVal)) {
             this->_safePrint("%f", *val);
-        } else if (const auto val = boost::get<std::string>(&varVal)) {
-            this->_safePrint("%s", utils::escapeString(*val).c_str());
+        } else if (const auto val = boost::get<boost::string_view>(&varVal)) {
+            this->_safePrint("%s", utils::escapeString(val->to_string()).c_str());
         }
     } else if (isError) {
         const auto& error = _state->activePacketState().packet().error();
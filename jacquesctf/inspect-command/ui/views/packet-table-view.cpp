@@ -298,6 +298,7 @@ void PacketTableView::timestampFormatMode(const TimestampFormatMode tsFormatMode
     }
 
     _tsFormatMode = tsFormatMode;
+    this->_invalidateCellCache();
     this->_redrawRows();
 }
 
@@ -307,6 +308,7 @@ void PacketTableView::dataSizeFormatMode(const utils::SizeFormatMode dataSizeFor
     static_cast<DataSizeTableViewCell&>(*_row[2]).formatMode(dataSizeFormatMode);
     static_cast<DataSizeTableViewCell&>(*_row[3]).formatMode(dataSizeFormatMode);
     _sizeFormatMode = dataSizeFormatMode;
+    this->_invalidateCellCache();
     this->_redrawRows();
 }
 
@@ -330,6 +332,7 @@ void PacketTableView::_stateChanged(const Message msg)
          * packets than our current selection index.
          */
         this->_selectionIndex(0, false);
+        this->_invalidateCellCache();
         this->redraw();
         updateSelection = true;
     } else if (msg == Message::ACTIVE_PACKET_CHANGED) {
@@ -12,6 +12,7 @@
 
 #include "search-input-view.hpp"
 #include "stylist.hpp"
+#include "utils.hpp"
 
 namespace jacques {
 
@@ -172,6 +173,44 @@ void SearchInputView::_drawNumber(std::string::const_iterator it,
     }
 }
 
+void SearchInputView::drawProgress(const SearchProgress& progress)
+{
+    // clear input first
+    this->_stylist().std(*this);
+
+    for (Index x = 1; x < this->contentRect().w - 2; ++x) {
+        this->_putChar({x, 1}, ' ');
+    }
+
+    this->_moveCursor({1, 1});
+
+    if (progress.isCanceled()) {
+        this->_safePrint("Canceling...");
+        return;
+    }
+
+    if (!progress.isStarted()) {
+        this->_safePrint("Searching...");
+        return;
+    }
+
+    const auto scannedCountStr = utils::sepNumber(progress.scannedPacketCount(), ',');
+    const auto countStr = utils::sepNumber(progress.packetCount(), ',');
+    const auto rateBits = static_cast<Size>(progress.bytesPerSecond() * 8);
+    const auto rate = utils::formatSize(rateBits,
+                                        utils::SizeFormatMode::FULL_FLOOR);
+    std::string etaStr = "?";
+
+    if (const auto etaSec = progress.etaSec()) {
+        etaStr = utils::sepNumber(static_cast<unsigned long long>(*etaSec + .5), ',');
+        etaStr += " s";
+    }
+
+    this->_safePrint("%s/%s packets    %s %s/s    ETA %s    (Ctrl+D: cancel)",
+                     scannedCountStr.c_str(), countStr.c_str(),
+                     rate.first.c_str(), rate.second.c_str(), etaStr.c_str());
+}
+
 void SearchInputView::animateBorder(const Index index)
 {
     const auto borderChCount = (this->contentRect().h - 2) * 2 +
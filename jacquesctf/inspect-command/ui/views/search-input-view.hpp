@@ -13,6 +13,7 @@
 #include <boost/optional.hpp>
 
 #include "input-view.hpp"
+#include "search-progress.hpp"
 
 namespace jacques {
 
@@ -23,6 +24,7 @@ public:
     explicit SearchInputView(const Rectangle& rect,
                              const Stylist& stylist);
     void animateBorder(Index index);
+    void drawProgress(const SearchProgress& progress);
 
 private:
     void _drawFormatText(const std::string& text);
@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <numeric>
+
+#include "search-match-table-view.hpp"
+#include "message.hpp"
+#include "utils.hpp"
+
+namespace jacques {
+
+SearchMatchTableView::SearchMatchTableView(const Rectangle& rect,
+                                           const Stylist& stylist,
+                                           State& state) :
+    TableView {rect, "Search matches", DecorationStyle::BORDERS, stylist},
+    _state {&state},
+    _stateObserverGuard {state, *this}
+{
+    this->_setColumnDescriptions();
+    this->_setTitle();
+}
+
+void SearchMatchTableView::_resized()
+{
+    TableView::_resized();
+    this->_setColumnDescriptions();
+}
+
+void SearchMatchTableView::_setColumnDescriptions()
+{
+    std::vector<TableViewColumnDescription> descrs {
+        TableViewColumnDescription {"Match", 12},
+        TableViewColumnDescription {"Packet", 12},
+        TableViewColumnDescription {"Event record", 12},
+        TableViewColumnDescription {"Packet offset", 16},
+        TableViewColumnDescription {"Packet timestamp: beginning", 29},
+        TableViewColumnDescription {"Packet seq num", 14},
+    };
+
+    const auto accOp = [](Size sz, const TableViewColumnDescription& descr) {
+        return sz + descr.contentWidth();
+    };
+    auto curSize = std::accumulate(std::begin(descrs), std::end(descrs),
+                                   0ULL, accOp);
+
+    // remove columns until they all fit
+    while (this->_contentSize(descrs.size()) < curSize) {
+        descrs.pop_back();
+        curSize = std::accumulate(std::begin(descrs), std::end(descrs),
+                                  0ULL, accOp);
+    }
+
+    // expand last column
+    descrs.back() = TableViewColumnDescription {
+        descrs.back().title(),
+        this->_contentSize(descrs.size()) -
+            std::accumulate(std::begin(descrs), std::end(descrs) - 1,
+                            0ULL, accOp)
+    };
+
+    this->_resetRow(descrs);
+    this->_columnDescriptions(std::move(descrs));
+}
+
+void SearchMatchTableView::_resetRow(const std::vector<TableViewColumnDescription>& descrs)
+{
+    _row.clear();
+    _row.push_back(std::make_unique<UnsignedIntTableViewCell>(TableViewCell::TextAlignment::RIGHT));
+    _row.back()->emphasized(true);
+    static_cast<UnsignedIntTableViewCell&>(*_row.back()).sep(true);
+    _row.push_back(std::make_unique<UnsignedIntTableViewCell>(TableViewCell::TextAlignment::RIGHT));
+    static_cast<UnsignedIntTableViewCell&>(*_row.back()).sep(true);
+    _row.push_back(std::make_unique<UnsignedIntTableViewCell>(TableViewCell::TextAlignment::RIGHT));
+    static_cast<UnsignedIntTableViewCell&>(*_row.back()).sep(true);
+
+    if (descrs.size() >= 4) {
+        _row.push_back(std::make_unique<DataSizeTableViewCell>(_sizeFormatMode));
+    }
+
+    if (descrs.size() >= 5) {
+        _row.push_back(std::make_unique<TimestampTableViewCell>(_tsFormatMode));
+    }
+
+    if (descrs.size() >= 6) {
+        _row.push_back(std::make_unique<UnsignedIntTableViewCell>(TableViewCell::TextAlignment::RIGHT));
+    }
+}
+
+void SearchMatchTableView::_setTitle()
+{
+    const auto& dsfState = _state->activeDataStreamFileState();
+    std::string title = "Search matches";
+
+    if (!dsfState.searchMatches().empty()) {
+        title += " (";
+
+        if (dsfState.curSearchMatchIndex()) {
+            title += utils::sepNumber(*dsfState.curSearchMatchIndex() + 1, ',');
+            title += '/';
+        }
+
+        title += utils::sepNumber(dsfState.searchMatches().size(), ',');
+        title += ')';
+    }
+
+    this->_title(title);
+}
+
+void SearchMatchTableView::_drawRow(const Index index)
+{
+    const auto& dsfState = _state->activeDataStreamFileState();
+
+    assert(index < dsfState.searchMatches().size());
+
+    const auto& match = dsfState.searchMatches()[index];
+    const auto& entry = dsfState.dataStreamFile().packetIndexEntry(match.first);
+
+    for (auto& cell : _row) {
+        cell->style(entry.isInvalid() ? TableViewCell::Style::ERROR :
+                    TableViewCell::Style::NORMAL);
+    }
+
+    // natural (1-based) indexes
+    static_cast<UnsignedIntTableViewCell&>(*_row[0]).value(index + 1);
+    static_cast<UnsignedIntTableViewCell&>(*_row[1]).value(entry.natIndexInDataStreamFile());
+    static_cast<UnsignedIntTableViewCell&>(*_row[2]).value(match.second + 1);
+
+    Index at = 3;
+
+    if (_row.size() >= at + 1) {
+        static_cast<DataSizeTableViewCell&>(*_row[at]).size(entry.offsetInDataStreamFileBits());
+        ++at;
+    }
+
+    if (_row.size() >= at + 1) {
+        if (entry.beginningTimestamp()) {
+            _row[at]->na(false);
+            static_cast<TimestampTableViewCell&>(*_row[at]).ts(*entry.beginningTimestamp());
+        } else {
+            _row[at]->na(true);
+        }
+
+        ++at;
+    }
+
+    if (_row.size() >= at + 1) {
+        if (entry.seqNum()) {
+            _row[at]->na(false);
+            static_cast<UnsignedIntTableViewCell&>(*_row[at]).value(*entry.seqNum());
+        } else {
+            _row[at]->na(true);
+        }
+
+        ++at;
+    }
+
+    this->_drawCells(index, _row);
+}
+
+bool SearchMatchTableView::_hasIndex(const Index index)
+{
+    return index < _state->activeDataStreamFileState().searchMatches().size();
+}
+
+void SearchMatchTableView::timestampFormatMode(const TimestampFormatMode tsFormatMode)
+{
+    if (_row.size() >= 5) {
+        static_cast<TimestampTableViewCell&>(*_row[4]).formatMode(tsFormatMode);
+    }
+
+    _tsFormatMode = tsFormatMode;
+    this->_invalidateCellCache();
+    this->_redrawRows();
+}
+
+void SearchMatchTableView::dataSizeFormatMode(const utils::SizeFormatMode dataSizeFormatMode)
+{
+    if (_row.size() >= 4) {
+        static_cast<DataSizeTableViewCell&>(*_row[3]).formatMode(dataSizeFormatMode);
+    }
+
+    _sizeFormatMode = dataSizeFormatMode;
+    this->_invalidateCellCache();
+    this->_redrawRows();
+}
+
+void SearchMatchTableView::_selectCurSearchMatch()
+{
+    const auto& curIndex = _state->activeDataStreamFileState().curSearchMatchIndex();
+
+    this->_selectionIndex(curIndex ? *curIndex : 0, false);
+}
+
+void SearchMatchTableView::searchMatchesChanged()
+{
+    this->_selectCurSearchMatch();
+    this->_invalidateCellCache();
+    this->_setTitle();
+    this->redraw();
+}
+
+void SearchMatchTableView::_stateChanged(const Message msg)
+{
+    if (msg == Message::ACTIVE_DATA_STREAM_FILE_CHANGED ||
+            msg == Message::ACTIVE_PACKET_CHANGED ||
+            msg == Message::CUR_OFFSET_IN_PACKET_CHANGED) {
+        // each data stream file state has its own search matches
+        this->searchMatchesChanged();
+    }
+}
+
+void SearchMatchTableView::_selectLast()
+{
+    const auto count = _state->activeDataStreamFileState().searchMatches().size();
+
+    if (count == 0) {
+        return;
+    }
+
+    this->_selectionIndex(count - 1);
+}
+
+} // namespace jacques
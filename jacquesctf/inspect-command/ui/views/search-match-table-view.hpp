@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_SEARCH_MATCH_TABLE_VIEW_HPP
+#define _JACQUES_SEARCH_MATCH_TABLE_VIEW_HPP
+
+#include "table-view.hpp"
+#include "state.hpp"
+#include "data-size.hpp"
+
+namespace jacques {
+
+/*
+ * Table of the search matches of the active data stream file state
+ * (see DataStreamFileState::searchAll()).
+ *
+ * A row only needs the packet index entry of its match: drawing a row
+ * doesn't decode anything.
+ */
+class SearchMatchTableView :
+    public TableView
+{
+public:
+    explicit SearchMatchTableView(const Rectangle& rect,
+                                  const Stylist& stylist, State& state);
+    void timestampFormatMode(TimestampFormatMode tsFormatMode);
+    void dataSizeFormatMode(utils::SizeFormatMode dataSizeFormatMode);
+    void searchMatchesChanged();
+
+    Index selectedSearchMatchIndex() const
+    {
+        return this->_selectionIndex();
+    }
+
+protected:
+    void _drawRow(Index index) override;
+    bool _hasIndex(Index index) override;
+    void _selectLast() override;
+    void _resized() override;
+    void _stateChanged(Message msg) override;
+
+private:
+    void _setColumnDescriptions();
+    void _resetRow(const std::vector<TableViewColumnDescription>& descrs);
+    void _setTitle();
+    void _selectCurSearchMatch();
+
+private:
+    std::vector<std::unique_ptr<TableViewCell>> _row;
+    State * const _state;
+    const ViewStateObserverGuard _stateObserverGuard;
+    TimestampFormatMode _tsFormatMode = TimestampFormatMode::LONG;
+    utils::SizeFormatMode _sizeFormatMode = utils::SizeFormatMode::FULL_FLOOR_WITH_EXTRA_BITS;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_SEARCH_MATCH_TABLE_VIEW_HPP
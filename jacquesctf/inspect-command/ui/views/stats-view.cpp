@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "stats-view.hpp"
+#include "stats.hpp"
+#include "stylist.hpp"
+#include "utils.hpp"
+
+namespace jacques {
+
+// counter rows, section title rows, empty rows, and hit rate rows
+static constexpr Size rateCount = 4;
+static constexpr Size rowCount = 1 + stats::counterCount + 2 + rateCount;
+
+// offset of a value from the beginning of its key
+static constexpr Index valueOffset = 36;
+
+StatsView::StatsView(const Rectangle& rect, const Stylist& stylist) :
+    ScrollView {rect, "Statistics", DecorationStyle::BORDERS, stylist}
+{
+    this->_rowCount(rowCount);
+    this->_drawRows();
+}
+
+static std::string hitRate(const Size hits, const Size misses)
+{
+    if (hits + misses == 0) {
+        return "N/A";
+    }
+
+    char buf[32];
+
+    std::snprintf(buf, sizeof buf, "%.2f %%",
+                  100. * static_cast<double>(hits) /
+                  static_cast<double>(hits + misses));
+    return buf;
+}
+
+void StatsView::_drawSectionTitle(const Index index, const char * const title)
+{
+    if (index < this->_index() ||
+            index >= this->_index() + this->contentRect().h) {
+        return;
+    }
+
+    this->_moveCursor({0, this->_contentRectYFromIndex(index)});
+    this->_stylist().sectionTitle(*this);
+    this->_safePrint("%s:", title);
+}
+
+void StatsView::_drawProp(const Index index, const char * const key,
+                          const std::string& value)
+{
+    if (index < this->_index() ||
+            index >= this->_index() + this->contentRect().h) {
+        return;
+    }
+
+    const auto y = this->_contentRectYFromIndex(index);
+
+    this->_moveCursor({2, y});
+    this->_stylist().traceInfoViewPropKey(*this);
+    this->_safePrint("%s:", key);
+    this->_moveCursor({2 + valueOffset, y});
+    this->_stylist().traceInfoViewPropValue(*this);
+    this->_safePrint("%s", value.c_str());
+}
+
+void StatsView::_drawRows()
+{
+    using stats::Counter;
+
+    this->_stylist().std(*this);
+    this->_clearContent();
+
+    Index index = 0;
+
+    this->_drawSectionTitle(index++, "Counters");
+
+    for (Index counterIndex = 0; counterIndex < stats::counterCount;
+            ++counterIndex) {
+        const auto counter = static_cast<Counter>(counterIndex);
+
+        this->_drawProp(index++, stats::name(counter),
+                        utils::sepNumber(stats::value(counter), ','));
+    }
+
+    ++index;
+    this->_drawSectionTitle(index++, "Hit rates");
+    this->_drawProp(index++, "Packets",
+                    hitRate(stats::value(Counter::PACKET_HITS),
+                            stats::value(Counter::PACKETS_CREATED)));
+    this->_drawProp(index++, "Region caches",
+                    hitRate(stats::value(Counter::CUR_REGION_CACHE_HITS) +
+                            stats::value(Counter::PREAMBLE_REGION_CACHE_HITS) +
+                            stats::value(Counter::OTHER_WINDOW_REGION_CACHE_HITS),
+                            stats::value(Counter::REGION_CACHE_MISSES)));
+    this->_drawProp(index++, "Event record caches",
+                    hitRate(stats::value(Counter::CUR_EVENT_RECORD_CACHE_HITS) +
+                            stats::value(Counter::OTHER_WINDOW_EVENT_RECORD_CACHE_HITS),
+                            stats::value(Counter::EVENT_RECORD_CACHE_MISSES)));
+    this->_drawProp(index++, "Offset region cache",
+                    hitRate(stats::value(Counter::OFFSET_REGION_CACHE_HITS),
+                            stats::value(Counter::OFFSET_REGION_CACHE_MISSES)));
+}
+
+} // namespace jacques
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_STATS_VIEW_HPP
+#define _JACQUES_STATS_VIEW_HPP
+
+#include "scroll-view.hpp"
+
+namespace jacques {
+
+/*
+ * View of the current data layer instrumentation counters (see
+ * `stats.hpp`) and of the cache hit rates derived from them.
+ *
+ * The view reads the counters every time it draws its rows.
+ */
+class StatsView :
+    public ScrollView
+{
+public:
+    explicit StatsView(const Rectangle& rect, const Stylist& stylist);
+
+private:
+    void _drawRows() override;
+    void _drawProp(Index index, const char *key, const std::string& value);
+    void _drawSectionTitle(Index index, const char *title);
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_STATS_VIEW_HPP
@@ -6,6 +6,7 @@
  */
 
 #include <iostream>
+#include <array>
 #include <cinttypes>
 #include <algorithm>
 #include <cstdio>
@@ -43,14 +44,8 @@ void StatusView::_createEndPositions()
         positions.curOffsetInDataStreamFileBits = positions.packetPercent + 9;
         positions.curOffsetInPacketBits = positions.curOffsetInDataStreamFileBits + 17;
 
-        const auto maxEntryIt = std::max_element(std::begin(dsf.packetIndexEntries()),
-                                                 std::end(dsf.packetIndexEntries()),
-                                                 [](const auto& entryA,
-                                                    const auto& entryB) {
-            return entryA.effectiveTotalSize() < entryB.effectiveTotalSize();
-        });
-        const auto maxOffsetInPacketBitsStr = (maxEntryIt == std::end(dsf.packetIndexEntries())) ?
-                                              "" : utils::sepNumber(maxEntryIt->effectiveTotalSize().bits());
+        const auto maxOffsetInPacketBitsStr = dsf.packetCount() == 0 ?
+                                              "" : utils::sepNumber(dsf.packetIndex().maxEffectiveTotalSize().bits());
 
         positions.dsfPath = positions.curOffsetInPacketBits +
                             maxOffsetInPacketBitsStr.size() + 6;
@@ -99,23 +94,26 @@ void StatusView::_drawOffset()
     // draw new offset in packet
     this->_stylist().statusViewStd(*this, true);
 
-    auto str = utils::sepNumber(_state->activePacketState().curOffsetInPacketBits(),
-                                ',');
+    std::array<char, utils::formatBufSize> buf;
+    auto len = utils::formatDecimal(buf.data(),
+                                    _state->activePacketState().curOffsetInPacketBits(),
+                                    ',');
 
     this->_moveAndPrint({this->contentRect().w -
-                         _curEndPositions->curOffsetInPacketBits - 2 - str.size(),
-                         0}, "%s", str.c_str());
+                         _curEndPositions->curOffsetInPacketBits - 2 - len,
+                         0}, "%s", buf.data());
     this->_stylist().statusViewStd(*this);
     this->_print(" b");
 
     // draw new offset in data stream file
-    str = utils::sepNumber(_state->activeDataStreamFileState().curOffsetInDataStreamFileBits(),
-                           ',');
+    len = utils::formatDecimal(buf.data(),
+                               _state->activeDataStreamFileState().curOffsetInDataStreamFileBits(),
+                               ',');
     this->_moveAndPrint({this->contentRect().w -
-                         _curEndPositions->curOffsetInDataStreamFileBits - str.size() - 3,
-                         0}, "(", str.c_str());
+                         _curEndPositions->curOffsetInDataStreamFileBits - len - 3,
+                         0}, "(");
     this->_stylist().statusViewStd(*this);
-    this->_print(str.c_str());
+    this->_print("%s", buf.data());
     this->_stylist().statusViewStd(*this);
     this->_print(" b)");
 }
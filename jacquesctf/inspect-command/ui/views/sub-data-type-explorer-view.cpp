@@ -25,8 +25,29 @@ SubDataTypeExplorerView::SubDataTypeExplorerView(const Rectangle& rect,
 {
 }
 
+void SubDataTypeExplorerView::isFrozen(const bool isFrozen)
+{
+    _isFrozen = isFrozen;
+
+    if (!_isFrozen && _isStale) {
+        this->_update();
+    }
+}
+
 void SubDataTypeExplorerView::_stateChanged(const Message)
 {
+    if (_isFrozen) {
+        _isStale = true;
+        return;
+    }
+
+    this->_update();
+}
+
+void SubDataTypeExplorerView::_update()
+{
+    _isStale = false;
+
     const auto& packetRegion = _state->currentPacketRegion();
 
     if (!packetRegion || !packetRegion->scope() ||
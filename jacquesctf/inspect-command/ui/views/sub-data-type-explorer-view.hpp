@@ -19,12 +19,24 @@ public:
     explicit SubDataTypeExplorerView(const Rectangle& rect,
                                      const Stylist& stylist, State& state);
 
+    /*
+     * Sets whether or not the view is frozen.
+     *
+     * A frozen view ignores state changes. When the view becomes
+     * unfrozen, it catches up with the current state if it missed any
+     * state change.
+     */
+    void isFrozen(bool isFrozen);
+
 private:
     void _stateChanged(Message msg) override;
+    void _update();
 
 private:
     State * const _state;
     const ViewStateObserverGuard _stateObserverGuard;
+    bool _isFrozen = false;
+    bool _isStale = false;
 };
 
 } // namespace jacques
@@ -22,7 +22,8 @@ TableView::TableView(const Rectangle& rect, const std::string& title,
                      const DecorationStyle decoStyle,
                      const Stylist& stylist) :
     View {rect, title, decoStyle, stylist},
-    _visibleRowCount {this->contentRect().h - 1}
+    _visibleRowCount {this->contentRect().h - 1},
+    _formattedCellCache {4096}
 {
     assert(this->contentRect().h >= 2);
 }
@@ -37,6 +38,7 @@ TableViewColumnDescription::TableViewColumnDescription(const std::string& title,
 void TableView::_columnDescriptions(std::vector<TableViewColumnDescription>&& columnDescriptions)
 {
     _columnDescrs = std::move(columnDescriptions);
+    this->_invalidateCellCache();
     this->_drawHeader();
     this->_redrawRows();
 }
@@ -265,28 +267,113 @@ void TableView::_drawCell(const Point& contentPos,
                                    rCell->value() ? "Yes" : "No",
                                    rCell->value() ? 3 : 2,
                                    customStyle, cell.textAlignment());
-    } else if (const auto dsCell = dynamic_cast<const DataSizeTableViewCell *>(&cell)) {
-        const auto parts = dsCell->size().format(dsCell->formatMode(), ',');
-        const char *fmt = "%s %s";
-        std::array<char, 32> buf;
+    } else if (const auto pCell = dynamic_cast<const PathTableViewCell *>(&cell)) {
+        std::string dirName, filename;
 
-        if (dsCell->formatMode() == utils::SizeFormatMode::FULL_FLOOR ||
-                dsCell->formatMode() == utils::SizeFormatMode::FULL_FLOOR_WITH_EXTRA_BITS) {
-            fmt = "%s%4s";
-        }
+        assert(!pCell->path().empty());
+        std::tie(dirName, filename) = utils::formatPath(pCell->path(),
+                                                        descr.contentWidth());
 
-        std::sprintf(buf.data(), fmt, parts.first.c_str(),
-                     parts.second.c_str());
+        auto curPos = contentPos;
+
+        if (!dirName.empty()) {
+            if (customStyle) {
+                this->_stylist().tableViewTextCell(*this, false);
+            }
+
+            this->_drawCellAlignedText(curPos, descr.contentWidth(),
+                                       dirName.c_str(), dirName.size(),
+                                       customStyle,
+                                       TableViewCell::TextAlignment::LEFT);
+            curPos.x += dirName.size();
+            this->_drawCellAlignedText(curPos, descr.contentWidth(),
+                                       "/", 1, customStyle,
+                                       TableViewCell::TextAlignment::LEFT);
+            curPos.x += 1;
+        }
 
         if (customStyle) {
             this->_stylist().tableViewTextCell(*this, cell.emphasized());
         }
 
-        this->_drawCellAlignedText(contentPos, descr.contentWidth(), buf.data(),
-                                   std::strlen(buf.data()), customStyle,
-                                   cell.textAlignment());
+        this->_drawCellAlignedText(curPos, descr.contentWidth(),
+                                   filename.c_str(), filename.size(),
+                                   customStyle,
+                                   TableViewCell::TextAlignment::LEFT);
+    } else {
+        std::abort();
+    }
+}
+
+bool TableView::_formattedCellKey(const TableViewCell& cell,
+                                  _FormattedCellKey& key)
+{
+    if (const auto rCell = dynamic_cast<const DataSizeTableViewCell *>(&cell)) {
+        key.kind = 1;
+        key.mode = static_cast<unsigned int>(rCell->formatMode());
+        key.values[0] = rCell->size().bits();
+    } else if (const auto rCell = dynamic_cast<const IntTableViewCell *>(&cell)) {
+        key.mode = static_cast<unsigned int>(rCell->radix());
+        key.values[1] = rCell->radixPrefix();
+        key.values[2] = rCell->sep();
+
+        if (const auto intCell = dynamic_cast<const SignedIntTableViewCell *>(&cell)) {
+            key.kind = 2;
+            key.values[0] = static_cast<unsigned long long>(intCell->value());
+        } else if (const auto intCell = dynamic_cast<const UnsignedIntTableViewCell *>(&cell)) {
+            key.kind = 3;
+            key.values[0] = intCell->value();
+        } else {
+            std::abort();
+        }
+    } else if (const auto rCell = dynamic_cast<const TimestampTableViewCell *>(&cell)) {
+        key.kind = 4;
+        key.mode = static_cast<unsigned int>(rCell->formatMode());
+        key.values[0] = static_cast<unsigned long long>(rCell->ts().nsFromOrigin());
+        key.values[1] = rCell->ts().cycles();
+        key.values[2] = rCell->ts().frequency();
+    } else if (const auto rCell = dynamic_cast<const DurationTableViewCell *>(&cell)) {
+        key.kind = 5;
+        key.mode = static_cast<unsigned int>(rCell->formatMode());
+        key.values[0] = static_cast<unsigned long long>(rCell->beginningTimestamp().nsFromOrigin());
+        key.values[1] = static_cast<unsigned long long>(rCell->endTimestamp().nsFromOrigin());
+        key.values[2] = rCell->beginningTimestamp().frequency();
+        key.values[3] = rCell->endTimestamp().frequency();
+
+        // the cycles format mode shows the cycle difference
+        key.values[4] = rCell->beginningTimestamp().cycles();
+        key.values[5] = rCell->endTimestamp().cycles();
+    } else {
+        // not worth caching
+        return false;
+    }
+
+    return true;
+}
+
+TableView::_FormattedCell TableView::_formatCell(const TableViewCell& cell)
+{
+    _FormattedCell formattedCell;
+    std::array<char, 32> buf;
+
+    buf[0] = '\0';
+
+    if (const auto dsCell = dynamic_cast<const DataSizeTableViewCell *>(&cell)) {
+        const auto unit = utils::formatSize(buf.data(), dsCell->size().bits(),
+                                            dsCell->formatMode(), ',');
+
+        formattedCell.text = buf.data();
+
+        if (dsCell->formatMode() == utils::SizeFormatMode::FULL_FLOOR ||
+                dsCell->formatMode() == utils::SizeFormatMode::FULL_FLOOR_WITH_EXTRA_BITS) {
+            // right-align the unit on four characters
+            formattedCell.text.append(4 - std::strlen(unit), ' ');
+        } else {
+            formattedCell.text += ' ';
+        }
+
+        formattedCell.text += unit;
     } else if (const auto rCell = dynamic_cast<const IntTableViewCell *>(&cell)) {
-        std::array<char, 32> buf;
         const char *fmt = nullptr;
 
         if (rCell->radix() == IntTableViewCell::Radix::OCT) {
@@ -306,109 +393,55 @@ void TableView::_drawCell(const Point& contentPos,
         if (const auto intCell = dynamic_cast<const SignedIntTableViewCell *>(&cell)) {
             assert(rCell->radix() == IntTableViewCell::Radix::DEC);
 
-            if (intCell->sep()) {
-                std::sprintf(buf.data(), "%s",
-                             utils::sepNumber(intCell->value(), ',').c_str());
-            } else {
-                fmt = "%lld";
-            }
-
             if (fmt) {
                 std::sprintf(buf.data(), fmt, intCell->value());
+            } else {
+                utils::formatDecimal(buf.data(), intCell->value(),
+                                     intCell->sep() ? boost::make_optional(',') : boost::none);
             }
         } else if (auto intCell = dynamic_cast<const UnsignedIntTableViewCell *>(&cell)) {
             assert(rCell->radix() == IntTableViewCell::Radix::DEC);
 
-            if (intCell->sep()) {
-                std::sprintf(buf.data(), "%s",
-                             utils::sepNumber(static_cast<long long>(intCell->value()), ',').c_str());
-            } else {
-                fmt = "%llu";
-            }
-
             if (fmt) {
                 std::sprintf(buf.data(), fmt, intCell->value());
+            } else {
+                utils::formatDecimal(buf.data(), intCell->value(),
+                                     intCell->sep() ? boost::make_optional(',') : boost::none);
             }
         } else {
             std::abort();
         }
 
-        if (customStyle) {
-            this->_stylist().tableViewTextCell(*this, cell.emphasized());
-        }
-
-        this->_drawCellAlignedText(contentPos, descr.contentWidth(), buf.data(),
-                                   std::strlen(buf.data()), customStyle,
-                                   cell.textAlignment());
+        formattedCell.text = buf.data();
     } else if (const auto rCell = dynamic_cast<const TimestampTableViewCell *>(&cell)) {
-        std::array<char, 32> buf;
-
         switch (rCell->formatMode()) {
         case TimestampFormatMode::LONG:
         case TimestampFormatMode::SHORT:
             rCell->ts().format(buf.data(), buf.size(), rCell->formatMode());
-
-            if (customStyle) {
-                this->_stylist().tableViewTextCell(*this, cell.emphasized());
-            }
-
-            this->_drawCellAlignedText(contentPos, descr.contentWidth(),
-                                       buf.data(), std::strlen(buf.data()),
-                                       customStyle, cell.textAlignment());
+            formattedCell.text = buf.data();
             break;
 
         case TimestampFormatMode::NS_FROM_ORIGIN:
         {
-            const auto parts = utils::formatNs(rCell->ts().nsFromOrigin(), ',');
-            const auto partsWidth = parts.first.size() + parts.second.size() + 4;
-            const auto startPos = Point {
-                contentPos.x + descr.contentWidth() - partsWidth, contentPos.y
-            };
-
-            if (customStyle) {
-                this->_stylist().tableViewTextCell(*this, cell.emphasized());
-            }
-
-            this->_clearCell(contentPos, descr.contentWidth());
-            this->_moveAndPrint(startPos, "%s,", parts.first.c_str());
-
-            if (customStyle) {
-                this->_stylist().tableViewTsCellNsPart(*this, cell.emphasized());
-            }
+            std::array<char, utils::formatBufSize> nsBuf;
 
-            this->_print("%s", parts.second.c_str());
-
-            if (customStyle) {
-                this->_stylist().tableViewTextCell(*this, cell.emphasized());
-            }
-
-            this->_print(" ns");
+            utils::formatNs(buf.data(), nsBuf.data(), rCell->ts().nsFromOrigin(), ',');
+            formattedCell.text = buf.data();
+            formattedCell.text += ',';
+            formattedCell.nsPart = nsBuf.data();
             break;
         }
 
         case TimestampFormatMode::CYCLES:
         {
-            const auto str = utils::sepNumber(rCell->ts().cycles(), ',') + " cc";
+            const auto len = utils::formatDecimal(buf.data(), rCell->ts().cycles(), ',');
 
-            if (customStyle) {
-                this->_stylist().tableViewTextCell(*this, cell.emphasized());
-            }
-
-            this->_drawCellAlignedText(contentPos, descr.contentWidth(),
-                                       str.c_str(), str.size(), customStyle,
-                                       cell.textAlignment());
+            formattedCell.text.assign(buf.data(), len);
+            formattedCell.text += " cc";
             break;
         }
         }
     } else if (const auto rCell = dynamic_cast<const DurationTableViewCell *>(&cell)) {
-        if (customStyle) {
-            this->_stylist().tableViewTextCell(*this, cell.emphasized());
-        }
-
-        std::array<char, 32> buf;
-
-        buf[0] = '\0';
-
         switch (rCell->formatMode()) {
         case TimestampFormatMode::LONG:
         case TimestampFormatMode::SHORT:
@@ -423,108 +456,130 @@ void TableView::_drawCell(const Point& contentPos,
             }
 
             rCell->absDuration().format(fmtBuf, fmtSize);
+            formattedCell.text = buf.data();
             break;
         }
 
         case TimestampFormatMode::NS_FROM_ORIGIN:
         {
-            const auto parts = utils::formatNs(rCell->absDuration().ns(), ',');
-            const auto partsWidth = parts.first.size() + parts.second.size() + 4;
-            const auto startPos = Point {
-                contentPos.x + descr.contentWidth() - partsWidth -
-                (rCell->isNegative() ? 1 : 0),
-                contentPos.y
-            };
-
-            if (customStyle) {
-                this->_stylist().tableViewTextCell(*this, cell.emphasized());
-            }
+            std::array<char, utils::formatBufSize> nsBuf;
 
-            this->_clearCell(contentPos, descr.contentWidth());
-            this->_moveCursor(startPos);
+            utils::formatNs(buf.data(), nsBuf.data(),
+                            static_cast<long long>(rCell->absDuration().ns()), ',');
 
             if (rCell->isNegative()) {
-                this->_appendChar('-');
+                formattedCell.text = "-";
             }
 
-            this->_safePrint("%s,", parts.first.c_str());
-
-            if (customStyle) {
-                this->_stylist().tableViewTsCellNsPart(*this, cell.emphasized());
-            }
-
-            this->_safePrint("%s", parts.second.c_str());
-
-            if (customStyle) {
-                this->_stylist().tableViewTextCell(*this, cell.emphasized());
-            }
-
-            this->_safePrint(" ns");
+            formattedCell.text += buf.data();
+            formattedCell.text += ',';
+            formattedCell.nsPart = nsBuf.data();
             break;
         }
 
         case TimestampFormatMode::CYCLES:
             if (!rCell->cycleDiffAvailable()) {
-                if (customStyle) {
-                    this->_stylist().tableViewNaCell(*this, cell.emphasized());
-                }
-
-                this->_drawCellAlignedText(contentPos, descr.contentWidth(),
-                                           "N/A", 3, customStyle,
-                                           cell.textAlignment());
+                formattedCell.na = true;
                 break;
             }
 
-            std::sprintf(buf.data(), "%s%s cc",
-                         rCell->isNegative() ? "-" : "",
-                         utils::sepNumber(rCell->absCycleDiff(), ',').c_str());
+            if (rCell->isNegative()) {
+                formattedCell.text = "-";
+            }
+
+            utils::formatDecimal(buf.data(), rCell->absCycleDiff(), ',');
+            formattedCell.text += buf.data();
+            formattedCell.text += " cc";
             break;
 
         default:
             break;
         }
+    } else {
+        std::abort();
+    }
 
-        if (std::strlen(buf.data()) > 0) {
-            this->_drawCellAlignedText(contentPos, descr.contentWidth(), buf.data(),
-                                       std::strlen(buf.data()), customStyle,
-                                       cell.textAlignment());
-        }
-    } else if (const auto pCell = dynamic_cast<const PathTableViewCell *>(&cell)) {
-        std::string dirName, filename;
+    return formattedCell;
+}
 
-        assert(!pCell->path().empty());
-        std::tie(dirName, filename) = utils::formatPath(pCell->path(),
-                                                        descr.contentWidth());
+const TableView::_FormattedCell *TableView::_formattedCell(const Index index,
+                                                           const Index column,
+                                                           const TableViewCell& cell)
+{
+    _FormattedCellKey key;
 
-        auto curPos = contentPos;
+    if (cell.na() || !TableView::_formattedCellKey(cell, key)) {
+        return nullptr;
+    }
 
-        if (!dirName.empty()) {
-            if (customStyle) {
-                this->_stylist().tableViewTextCell(*this, false);
-            }
+    // a row has at most 256 columns
+    assert(column < 256);
 
-            this->_drawCellAlignedText(curPos, descr.contentWidth(),
-                                       dirName.c_str(), dirName.size(),
-                                       customStyle,
-                                       TableViewCell::TextAlignment::LEFT);
-            curPos.x += dirName.size();
-            this->_drawCellAlignedText(curPos, descr.contentWidth(),
-                                       "/", 1, customStyle,
-                                       TableViewCell::TextAlignment::LEFT);
-            curPos.x += 1;
+    const auto cacheKey = (index << 8) | column;
+    const auto entry = _formattedCellCache.get(cacheKey);
+
+    if (entry) {
+        if (entry->key == key) {
+            return &entry->formattedCell;
         }
 
+        // same row and column, but other values or format mode
+        _formattedCellCache.invalidate(cacheKey);
+    }
+
+    _formattedCellCache.insert(cacheKey, {key, TableView::_formatCell(cell)});
+    return &_formattedCellCache.get(cacheKey)->formattedCell;
+}
+
+void TableView::_drawFormattedCell(const Point& contentPos,
+                                   const TableViewColumnDescription& descr,
+                                   const TableViewCell& cell,
+                                   const _FormattedCell& formattedCell,
+                                   const bool customStyle)
+{
+    if (formattedCell.na) {
         if (customStyle) {
-            this->_stylist().tableViewTextCell(*this, cell.emphasized());
+            this->_stylist().tableViewNaCell(*this, cell.emphasized());
         }
 
-        this->_drawCellAlignedText(curPos, descr.contentWidth(),
-                                   filename.c_str(), filename.size(),
-                                   customStyle,
-                                   TableViewCell::TextAlignment::LEFT);
-    } else {
-        std::abort();
+        this->_drawCellAlignedText(contentPos, descr.contentWidth(), "N/A", 3,
+                                   customStyle, cell.textAlignment());
+        return;
     }
+
+    if (customStyle) {
+        this->_stylist().tableViewTextCell(*this, cell.emphasized());
+    }
+
+    if (formattedCell.nsPart.empty()) {
+        this->_drawCellAlignedText(contentPos, descr.contentWidth(),
+                                   formattedCell.text.c_str(),
+                                   formattedCell.text.size(), customStyle,
+                                   cell.textAlignment());
+        return;
+    }
+
+    const auto partsWidth = formattedCell.text.size() +
+                            formattedCell.nsPart.size() + 3;
+    const auto startPos = Point {
+        contentPos.x + descr.contentWidth() - partsWidth, contentPos.y
+    };
+
+    this->_clearCell(contentPos, descr.contentWidth());
+    this->_moveCursor(startPos);
+    this->_safePrint("%s", formattedCell.text.c_str());
+
+    if (customStyle) {
+        this->_stylist().tableViewTsCellNsPart(*this, cell.emphasized());
+    }
+
+    this->_safePrint("%s", formattedCell.nsPart.c_str());
+
+    if (customStyle) {
+        this->_stylist().tableViewTextCell(*this, cell.emphasized());
+    }
+
+    this->_safePrint(" ns");
 }
 
 static inline
@@ -575,8 +630,16 @@ void TableView::_drawCells(const Index index,
             this->_stylist().tableViewCell(*this, cellStylistTvcStyle);
         }
 
-        this->_drawCell({x, y}, _columnDescrs[column], cell,
-                        !selected && cell.style() == TableViewCell::Style::NORMAL);
+        const auto customStyle = !selected &&
+                                 cell.style() == TableViewCell::Style::NORMAL;
+
+        if (const auto formattedCell = this->_formattedCell(index, column, cell)) {
+            this->_drawFormattedCell({x, y}, descr, cell, *formattedCell,
+                                     customStyle);
+        } else {
+            this->_drawCell({x, y}, descr, cell, customStyle);
+        }
+
         x += descr.contentWidth();
 
         if (column == cells.size() - 1) {
@@ -633,6 +696,11 @@ void TableView::_redrawRows()
     this->_hasMoreBottom(this->_hasIndex(_baseIdx + _visibleRowCount));
 }
 
+void TableView::_invalidateCellCache()
+{
+    _formattedCellCache.invalidate();
+}
+
 void TableView::_resized()
 {
     _visibleRowCount = this->contentRect().h - 1;
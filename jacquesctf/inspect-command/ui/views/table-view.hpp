@@ -10,6 +10,7 @@
 
 #include <string>
 #include <vector>
+#include <array>
 #include <memory>
 #include <cassert>
 #include <cstdint>
@@ -21,6 +22,7 @@
 #include "timestamp.hpp"
 #include "duration.hpp"
 #include "time-ops.hpp"
+#include "cache.hpp"
 
 namespace jacques {
 
@@ -421,6 +423,7 @@ protected:
     void _drawWarningRow(Index index, const std::string& msg);
     void _columnDescriptions(std::vector<TableViewColumnDescription>&& columnDescriptions);
     void _redrawRows();
+    void _invalidateCellCache();
     void _redrawContent() override;
     void _isSelectionHighlightEnabled(bool isEnabled, bool draw = true);
 
@@ -471,6 +474,47 @@ protected:
 
     void _resized() override;
 
+private:
+    /*
+     * Formatted text of a data size, integer, timestamp, or duration
+     * cell.
+     *
+     * If `nsPart` is empty, the view draws `text` aligned within the
+     * cell. Otherwise, the view draws `text`, then `nsPart` with the
+     * nanosecond part style, then ` ns`, right-aligned within the cell.
+     */
+    struct _FormattedCell
+    {
+        std::string text;
+        std::string nsPart;
+        bool na = false;
+    };
+
+    /*
+     * What a formatted cell depends on: cell kind, format mode, and
+     * up to six values. The view only reuses a cached formatted cell
+     * when its key is equal to the key of the cell to draw, so that a
+     * stale entry can never be drawn.
+     */
+    struct _FormattedCellKey
+    {
+        bool operator==(const _FormattedCellKey& other) const noexcept
+        {
+            return kind == other.kind && mode == other.mode &&
+                   values == other.values;
+        }
+
+        unsigned int kind = 0;
+        unsigned int mode = 0;
+        std::array<unsigned long long, 6> values {};
+    };
+
+    struct _FormattedCellCacheEntry
+    {
+        _FormattedCellKey key;
+        _FormattedCell formattedCell;
+    };
+
 private:
     void _clearRow(Index y);
     void _clearCell(const Point& pos, Size cellWidth);
@@ -481,6 +525,16 @@ private:
     void _drawCell(const Point& pos,
                    const TableViewColumnDescription& descr,
                    const TableViewCell& cell, bool customStyle);
+    void _drawFormattedCell(const Point& pos,
+                            const TableViewColumnDescription& descr,
+                            const TableViewCell& cell,
+                            const _FormattedCell& formattedCell,
+                            bool customStyle);
+    const _FormattedCell *_formattedCell(Index index, Index column,
+                                         const TableViewCell& cell);
+    static bool _formattedCellKey(const TableViewCell& cell,
+                                  _FormattedCellKey& key);
+    static _FormattedCell _formatCell(const TableViewCell& cell);
     void _drawHeader();
     void _next(Size count);
     void _prev(Size count);
@@ -492,6 +546,14 @@ private:
     Index _selectionIdx = 0;
     Size _visibleRowCount;
     bool _isSelectHighlightEnabled = true;
+
+    /*
+     * Formatted cells, keyed by row index and column (see
+     * _formattedCell()): when the selection moves or when the user
+     * flips pages back and forth, the view reuses the formatted text
+     * of the rows it already drew instead of formatting it again.
+     */
+    Cache<Index, _FormattedCellCacheEntry> _formattedCellCache;
 };
 
 } // namespace jacques
@@ -82,18 +82,12 @@ void TraceInfoView::_buildTraceInfoRows(const Metadata &metadata)
         ++dsfCount;
         packetCount += dsFile.packetCount();
 
-        for (const auto& entry : dsFile.packetIndexEntries()) {
-            if (entry.expectedContentSize()) {
-                totalExpectedPacketsContentSize += *entry.expectedContentSize();
-            }
-
-            if (entry.expectedTotalSize()) {
-                totalExpectedPacketsTotalSize += *entry.expectedTotalSize();
-            }
+        const auto& packetIndex = dsFile.packetIndex();
 
-            totalEffectivePacketsContentSize += entry.effectiveContentSize();
-            totalEffectivePacketsTotalSize += entry.effectiveTotalSize();
-        }
+        totalExpectedPacketsContentSize += packetIndex.totalExpectedContentSize();
+        totalExpectedPacketsTotalSize += packetIndex.totalExpectedTotalSize();
+        totalEffectivePacketsContentSize += packetIndex.totalEffectiveContentSize();
+        totalEffectivePacketsTotalSize += packetIndex.totalEffectiveTotalSize();
 
         if (dsFile.packetCount() > 0) {
             const auto &dataStreamId = dsFile.packetIndexEntry(0).dataStreamId();
@@ -105,10 +99,8 @@ void TraceInfoView::_buildTraceInfoRows(const Metadata &metadata)
                 ++dsfWithoutDsIdCount;
             }
 
-            const auto& firstPacketIndexEntry = dsFile.packetIndexEntries().front();
-            const auto& lastPacketIndexEntry = dsFile.packetIndexEntries().back();
-            const auto& dsfFirstTs = firstPacketIndexEntry.beginningTimestamp();
-            const auto& dsfLastTs = lastPacketIndexEntry.endTimestamp();
+            const auto& dsfFirstTs = packetIndex.firstTimestamp();
+            const auto& dsfLastTs = packetIndex.lastTimestamp();
 
             if (dsfFirstTs) {
                 if (!firstTs || *dsfFirstTs < *firstTs) {
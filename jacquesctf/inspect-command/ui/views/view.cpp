@@ -13,6 +13,7 @@
 #include "view.hpp"
 #include "stylist.hpp"
 #include "utils.hpp"
+#include "profiler.hpp"
 
 namespace jacques {
 
@@ -64,6 +65,8 @@ void View::refresh(const bool touch) const
 
 void View::redraw(const bool touch)
 {
+    const profiler::Span span {"View::redraw"};
+
     _myStylist->std(*this);
     werase(_curWindow);
     this->_decorate();
@@ -182,6 +185,23 @@ void View::_clearRect() const
     }
 }
 
+void View::_scrollContent(const long long lineCount) const
+{
+    const auto top = static_cast<int>(_contentRectangle.pos.y);
+    const auto bottom = top + static_cast<int>(_contentRectangle.h) - 1;
+
+    _myStylist->std(*this);
+    idlok(_curWindow, TRUE);
+    scrollok(_curWindow, TRUE);
+    wsetscrreg(_curWindow, top, bottom);
+    wscrl(_curWindow, static_cast<int>(lineCount));
+    wsetscrreg(_curWindow, 0, static_cast<int>(_rect.h) - 1);
+    scrollok(_curWindow, FALSE);
+
+    // left and right borders of the exposed lines
+    this->_decorate();
+}
+
 ViewStateObserverGuard::ViewStateObserverGuard(State& state, View& view) :
     _observerGuard {state, std::bind(&View::_stateChanged, &view,
                                      std::placeholders::_1)}
@@ -197,6 +197,18 @@ protected:
      */
     void _clearRect() const;
 
+    /*
+     * Scrolls the lines of the content rectangle (contentRect()) by
+     * `lineCount` lines: up if `lineCount` is positive, down if it's
+     * negative. This lets ncurses use the terminal's line
+     * insertion/deletion capabilities instead of repainting each moved
+     * line.
+     *
+     * The exposed lines are blank: the caller must draw them. This
+     * method redraws the decoration.
+     */
+    void _scrollContent(long long lineCount) const;
+
     /*
      * Draws the view's decoration according to the current state
      * (decoration style, title, "more content" indicators).
@@ -23,7 +23,10 @@
 #include "list-packets-command.hpp"
 #include "copy-packets-command.hpp"
 #include "create-lttng-index-command.hpp"
+#include "validate-command.hpp"
 #include "inspect-command.hpp"
+#include "stats.hpp"
+#include "profiler.hpp"
 
 namespace bfs = boost::filesystem;
 
@@ -37,6 +40,27 @@ static void printCliUsage(const char *cmdName)
     std::puts("");
     std::puts("  --help, -h     Print usage and exit");
     std::puts("  --version, -V  Print version and exit");
+    std::puts("  --stats        Print data layer statistics (cache hits and misses,");
+    std::puts("                 decoded elements, and more) and the key-to-frame latency");
+    std::puts("                 histogram of the `inspect` command to the standard error");
+    std::puts("                 at exit");
+    std::puts("  --data-source=SRC");
+    std::puts("                 Read data stream files with SRC: `mmap` (memory-mapped");
+    std::puts("                 files; default), `pread` (large `pread()` reads, asking");
+    std::puts("                 the kernel to read ahead), or `pread-thread` (large");
+    std::puts("                 `pread()` reads, reading ahead on a background thread)");
+    std::puts("  --packet-cache-windows=COUNT");
+    std::puts("                 Keep at most COUNT cached event record windows per");
+    std::puts("                 inspected packet (default: 6)");
+    std::puts("  --packet-cache-window-size=COUNT");
+    std::puts("                 Cache at most COUNT (at least 4) event records per window");
+    std::puts("                 (default: 500)");
+    std::puts("  --packet-cache-max-regions=COUNT");
+    std::puts("                 Cache at most COUNT packet regions in all the windows of");
+    std::puts("                 an inspected packet (default: 250000)");
+    std::puts("");
+    std::puts("Set the `JACQUES_PROFILE` environment variable to a file path to write");
+    std::puts("a profile of the main operations (Chrome trace event format) at exit.");
     std::puts("");
     std::puts("`inspect` (default) command");
     std::puts("---------------------------");
@@ -96,6 +120,34 @@ static void printCliUsage(const char *cmdName)
     std::puts("");
     std::puts("If PATH is a CTF data stream file, inspect this file.");
     std::puts("If PATH is a directory, inspect all CTF data stream files found recursively.");
+    std::puts("");
+    std::puts("`validate` command");
+    std::puts("------------------");
+    std::puts("Usage: validate PATH...");
+    std::puts("");
+    std::puts("Fully decode all the packets of the specified CTF data stream files and print");
+    std::puts("each decoding error. Exit with status 1 if there's any decoding error.");
+    std::puts("");
+    std::puts("If PATH is a CTF data stream file, validate this file.");
+    std::puts("If PATH is a directory, validate all CTF data stream files found recursively.");
+    std::puts("");
+    std::puts("`replay` command");
+    std::puts("----------------");
+    std::puts("Usage: replay [--width=W] [--height=H] KEY-SCRIPT PATH...");
+    std::puts("");
+    std::puts("Run the `inspect` command on a headless W x H (default: 160 x 48) terminal,");
+    std::puts("pressing the keys of KEY-SCRIPT, and then print the latency of each frame");
+    std::puts("(frame index, latency (us), and key name) to the standard output and a");
+    std::puts("latency summary to the standard error.");
+    std::puts("");
+    std::puts("KEY-SCRIPT contains one `KEY [COUNT]` line per key to press COUNT times.");
+    std::puts("KEY is a character, `^X`, or one of `up`, `down`, `left`, `right`, `pgup`,");
+    std::puts("`pgdn`, `home`, `end`, `backspace`, `enter`, `tab`, `esc`, `space`, `hash`,");
+    std::puts("and `f1` to `f12`. A `text TEXT` line types TEXT. Lines starting with `#`");
+    std::puts("are ignored.");
+    std::puts("");
+    std::puts("If PATH is a CTF data stream file, inspect this file.");
+    std::puts("If PATH is a directory, inspect all CTF data stream files found recursively.");
 }
 
 static void printVersion()
@@ -103,9 +155,33 @@ static void printVersion()
     std::cout << "Jacques CTF " JACQUES_VERSION << std::endl;
 }
 
+/*
+ * Prints the data layer statistics to the standard error when
+ * destroyed, if enabled, even if the command throws.
+ */
+class StatsPrinter
+{
+public:
+    explicit StatsPrinter(const bool isEnabled) :
+        _isEnabled {isEnabled}
+    {
+    }
+
+    ~StatsPrinter()
+    {
+        if (_isEnabled) {
+            stats::print(std::cerr);
+        }
+    }
+
+private:
+    const bool _isEnabled;
+};
+
 static void jacques(const int argc, const char *argv[])
 {
     const auto cfg = configFromArgs(argc, argv);
+    const StatsPrinter statsPrinter {cfg->printStats()};
 
     if (dynamic_cast<const PrintCliUsageConfig *>(cfg.get())) {
         printCliUsage(argv[0]);
@@ -119,6 +195,11 @@ static void jacques(const int argc, const char *argv[])
         copyPacketsCommand(*specCfg);
     } else if (const auto specCfg = dynamic_cast<const CreateLttngIndexConfig *>(cfg.get())) {
         createLttngIndexCommand(*specCfg);
+    } else if (const auto specCfg = dynamic_cast<const ValidateConfig *>(cfg.get())) {
+        validateCommand(*specCfg);
+    } else if (const auto specCfg = dynamic_cast<const ReplayConfig *>(cfg.get())) {
+        // before `InspectConfig`: a replay configuration is one
+        replayCommand(*specCfg);
     } else if (const auto specCfg = dynamic_cast<const InspectConfig *>(cfg.get())) {
         inspectCommand(*specCfg);
     } else {
@@ -130,12 +211,25 @@ static void jacques(const int argc, const char *argv[])
 
 int main(const int argc, const char *argv[])
 {
+    jacques::profiler::init();
+
     const auto exStr = jacques::utils::tryFunc([&]() {
         jacques::jacques(argc, argv);
     });
 
+    // write the profile even if the command failed
+    const auto profilerExStr = jacques::utils::tryFunc([]() {
+        jacques::profiler::finish();
+    });
+
+    if (profilerExStr) {
+        jacques::utils::error() << *profilerExStr << std::endl;
+    }
+
     if (exStr) {
         jacques::utils::error() << *exStr << std::endl;
         return 1;
     }
+
+    return profilerExStr ? 1 : 0;
 }
@@ -6,13 +6,16 @@
  */
 
 #include <iostream>
+#include <array>
 #include <cassert>
+#include <cstring>
 
 #include "config.hpp"
 #include "list-packets-command.hpp"
 #include "metadata.hpp"
 #include "data-stream-file.hpp"
 #include "time-ops.hpp"
+#include "utils.hpp"
 
 namespace jacques {
 
@@ -28,28 +31,54 @@ static void printHeader(const ListPacketsConfig::Format fmt)
                  "Discarded event record counter,Is valid" << std::endl;
 }
 
+static inline void writeField(char *& bufAt, const unsigned long long value)
+{
+    bufAt += utils::formatDecimal(bufAt, value);
+    *bufAt++ = ',';
+}
+
+static inline void writeField(char *& bufAt, const long long value)
+{
+    bufAt += utils::formatDecimal(bufAt, value);
+    *bufAt++ = ',';
+}
+
+static inline void writeEmptyFields(char *& bufAt, const Size count = 1)
+{
+    for (Index i = 0; i < count; ++i) {
+        *bufAt++ = ',';
+    }
+}
+
 static void printRow(const PacketIndexEntry& indexEntry,
                      const ListPacketsConfig::Format fmt)
 {
     assert(fmt == ListPacketsConfig::Format::MACHINE);
 
-    std::cout << indexEntry.natIndexInDataStreamFile() << "," <<
-                 indexEntry.offsetInDataStreamFileBytes() << "," <<
-                 indexEntry.effectiveTotalSize().bytes() << "," <<
-                 indexEntry.effectiveContentSize().bits() << ",";
+    /*
+     * Write the whole row to a fixed buffer and print it at once: this
+     * is called for each packet of the data stream file.
+     */
+    std::array<char, 512> buf;
+    auto bufAt = buf.data();
+
+    writeField(bufAt, indexEntry.natIndexInDataStreamFile());
+    writeField(bufAt, indexEntry.offsetInDataStreamFileBytes());
+    writeField(bufAt, indexEntry.effectiveTotalSize().bytes());
+    writeField(bufAt, indexEntry.effectiveContentSize().bits());
 
     if (indexEntry.beginningTimestamp()) {
-        std::cout << indexEntry.beginningTimestamp()->cycles() << "," <<
-                     indexEntry.beginningTimestamp()->nsFromOrigin() << ",";
+        writeField(bufAt, indexEntry.beginningTimestamp()->cycles());
+        writeField(bufAt, indexEntry.beginningTimestamp()->nsFromOrigin());
     } else {
-        std::cout << ",,";
+        writeEmptyFields(bufAt, 2);
     }
 
     if (indexEntry.endTimestamp()) {
-        std::cout << indexEntry.endTimestamp()->cycles() << "," <<
-                     indexEntry.endTimestamp()->nsFromOrigin() << ",";
+        writeField(bufAt, indexEntry.endTimestamp()->cycles());
+        writeField(bufAt, indexEntry.endTimestamp()->nsFromOrigin());
     } else {
-        std::cout << ",,";
+        writeEmptyFields(bufAt, 2);
     }
 
     if (indexEntry.beginningTimestamp() && indexEntry.endTimestamp() &&
@@ -59,43 +88,50 @@ static void printRow(const PacketIndexEntry& indexEntry,
         const auto durCycles = indexEntry.endTimestamp()->cycles() -
                                indexEntry.beginningTimestamp()->cycles();
 
-        std::cout << durCycles << "," <<
-                     duration.ns() << ",";
+        writeField(bufAt, durCycles);
+        writeField(bufAt, duration.ns());
     } else {
-        std::cout << ",,";
+        writeEmptyFields(bufAt, 2);
     }
 
     if (indexEntry.dataStreamType()) {
-        std::cout << indexEntry.dataStreamType()->id() << ",";
+        writeField(bufAt, static_cast<unsigned long long>(indexEntry.dataStreamType()->id()));
     } else {
-        std::cout << ",";
+        writeEmptyFields(bufAt);
     }
 
     if (indexEntry.dataStreamId()) {
-        std::cout << *indexEntry.dataStreamId() << ",";
+        writeField(bufAt, static_cast<unsigned long long>(*indexEntry.dataStreamId()));
     } else {
-        std::cout << ",";
+        writeEmptyFields(bufAt);
     }
 
     if (indexEntry.seqNum()) {
-        std::cout << *indexEntry.seqNum() << ",";
+        writeField(bufAt, static_cast<unsigned long long>(*indexEntry.seqNum()));
     } else {
-        std::cout << ",";
+        writeEmptyFields(bufAt);
     }
 
     if (indexEntry.discardedEventRecordCounter()) {
-        std::cout << *indexEntry.discardedEventRecordCounter() << ",";
+        writeField(bufAt, static_cast<unsigned long long>(*indexEntry.discardedEventRecordCounter()));
     } else {
-        std::cout << ",";
+        writeEmptyFields(bufAt);
     }
 
-    std::cout << (indexEntry.isInvalid() ? "no" : "yes") << std::endl;
+    const auto isValidStr = indexEntry.isInvalid() ? "no\n" : "yes\n";
+    const auto isValidStrLen = std::strlen(isValidStr);
+
+    std::memcpy(bufAt, isValidStr, isValidStrLen);
+    bufAt += isValidStrLen;
+    std::cout.write(buf.data(), bufAt - buf.data());
 }
 
 void listPacketsCommand(const ListPacketsConfig& cfg)
 {
     const Metadata metadata {cfg.path().parent_path() / "metadata"};
-    DataStreamFile dsf {cfg.path(), metadata};
+    DataStreamFile dsf {
+        cfg.path(), metadata, nullptr, cfg.dataSourceKind()
+    };
 
     dsf.buildIndex();
 
@@ -5,8 +5,10 @@
  * prohibited. Proprietary and confidential.
  */
 
+#include <cassert>
 #include <cstring>
 #include <cstdio>
+#include <algorithm>
 #include <array>
 #include <string>
 #include <sstream>
@@ -56,54 +58,116 @@ std::pair<std::string, std::string> formatPath(const bfs::path& path,
     return std::make_pair(dirNameStr, filenameStr);
 }
 
-template <typename T>
-static std::string sepNumber(const T value, const char sep, const char *fmt)
+// two decimal digits for each value from 0 to 99
+static const char decimalDigitPairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// number of decimal digits of `value`
+static Size decimalDigitCount(unsigned long long value) noexcept
 {
+    Size count = 1;
+
+    while (true) {
+        if (value < 10) {
+            return count;
+        } else if (value < 100) {
+            return count + 1;
+        } else if (value < 1000) {
+            return count + 2;
+        } else if (value < 10000) {
+            return count + 3;
+        }
+
+        value /= 10000;
+        count += 4;
+    }
+}
+
+Size formatDecimal(char * const buf, unsigned long long value,
+                   const boost::optional<char>& sep,
+                   const Size minDigitCount)
+{
+    assert(minDigitCount <= 20);
+
     /*
-     * 1. Convert absolute value to string.
-     * 2. Create return string, iterate first string in reverse order,
-     *    and append separator every three characters.
-     * 3. Remove trailing separator if any.
-     * 4. Append `-` if the value is negative.
-     * 5. Reverse the whole string.
+     * Knowing the final length, write the digits directly to `buf`,
+     * from its end. Writing `digitCount` digits zero-pads the value.
      */
-    std::array<char, 64> buf;
-    const auto absValue = std::is_signed<T>::value ?
-                          std::abs(static_cast<long long>(value)) : value;
-    const auto count = std::sprintf(buf.data(), fmt, absValue);
-    Index i = 0;
-    std::string ret;
-
-    for (auto at = count - 1; at >= 0; --at, ++i) {
-        const auto ch = buf[at];
-
-        if (i % 3 == 0 && i != 0) {
-            ret += sep;
+    const auto digitCount = std::max(decimalDigitCount(value),
+                                     minDigitCount);
+    const auto len = sep ? digitCount + (digitCount - 1) / 3 : digitCount;
+    auto bufAt = buf + len;
+
+    *bufAt = '\0';
+
+    if (sep) {
+        // one group of three digits at a time, except the first one
+        const auto sepChar = *sep;
+        auto groupCount = (digitCount - 1) / 3;
+
+        while (groupCount > 0) {
+            const auto group = value % 1000;
+            const auto pairAt = &decimalDigitPairs[(group % 100) * 2];
+
+            value /= 1000;
+            *--bufAt = pairAt[1];
+            *--bufAt = pairAt[0];
+            *--bufAt = '0' + static_cast<char>(group / 100);
+            *--bufAt = sepChar;
+            --groupCount;
         }
+    } else {
+        // two digits at a time
+        while (bufAt - buf >= 2) {
+            const auto pairAt = &decimalDigitPairs[(value % 100) * 2];
 
-        ret += ch;
+            value /= 100;
+            *--bufAt = pairAt[1];
+            *--bufAt = pairAt[0];
+        }
     }
 
-    if (ret.back() == sep) {
-        ret.pop_back();
+    // remaining (first) one to three digits
+    while (bufAt > buf) {
+        *--bufAt = '0' + static_cast<char>(value % 10);
+        value /= 10;
     }
 
+    return len;
+}
+
+Size formatDecimal(char * const buf, const long long value,
+                   const boost::optional<char>& sep)
+{
     if (value < 0) {
-        ret += '-';
+        // negate as unsigned to support the minimum value
+        buf[0] = '-';
+        return 1 + formatDecimal(buf + 1,
+                                 0ULL - static_cast<unsigned long long>(value),
+                                 sep);
     }
 
-    std::reverse(std::begin(ret), std::end(ret));
-    return ret;
+    return formatDecimal(buf, static_cast<unsigned long long>(value), sep);
 }
 
 std::string sepNumber(const long long value, const char sep)
 {
-    return sepNumber(value, sep, "%lld");
+    std::array<char, formatBufSize> buf;
+    const auto len = formatDecimal(buf.data(), value, sep);
+
+    return {buf.data(), len};
 }
 
 std::string sepNumber(const unsigned long long value, const char sep)
 {
-    return sepNumber(value, sep, "%llu");
+    std::array<char, formatBufSize> buf;
+    const auto len = formatDecimal(buf.data(), value, sep);
+
+    return {buf.data(), len};
 }
 
 std::string wrapText(const std::string& text, const Size lineLength)
@@ -262,102 +326,113 @@ endOfPattern:
     return p[-1] == '*' && atEndOfPattern(p, pattern);
 }
 
-std::pair<std::string, std::string> formatSize(const Size sizeBits,
-                                               const SizeFormatMode formatMode,
-                                               const boost::optional<char>& sep)
+const char *formatSize(char * const buf, const Size sizeBits,
+                       const SizeFormatMode formatMode,
+                       const boost::optional<char>& sep)
 {
-    std::array<char, 64> buf;
-    const char *unit;
+    const char *unit = "B";
     const auto sizeBytes = sizeBits / 8;
     const auto extraBits = sizeBits & 7;
+    auto bufAt = buf;
+    bool withExtraBits = false;
 
     switch (formatMode) {
     case SizeFormatMode::FULL_FLOOR:
     case SizeFormatMode::FULL_FLOOR_WITH_EXTRA_BITS:
     {
-        unit = "B";
-        double val = static_cast<double>(sizeBytes);
+        Size divisor = 1;
 
         if (sizeBytes >= 1024 * 1024 * 1024) {
-            val = static_cast<double>(sizeBytes) / (1024. * 1024 * 1024);
+            divisor = 1024ULL * 1024 * 1024;
             unit = "GiB";
         } else if (sizeBytes >= 1024 * 1024) {
-            val = static_cast<double>(sizeBytes) / (1024. * 1024);
+            divisor = 1024 * 1024;
             unit = "MiB";
         } else if (sizeBytes >= 1024) {
-            val = static_cast<double>(sizeBytes) / 1024.;
+            divisor = 1024;
             unit = "KiB";
         }
 
-        if (formatMode == SizeFormatMode::FULL_FLOOR_WITH_EXTRA_BITS &&
-                extraBits > 0) {
-            std::sprintf(buf.data(), "%.3f+%llu", val, extraBits);
-        } else {
-            std::sprintf(buf.data(), "%.3f", val);
+        /*
+         * Three decimal digits, rounding half to even like printf()'s
+         * `%.3f` does with the exact quotient.
+         */
+        auto intPart = sizeBytes / divisor;
+        const auto scaledRem = (sizeBytes % divisor) * 1000;
+        auto fracPart = scaledRem / divisor;
+        const auto fracRemTwice = (scaledRem % divisor) * 2;
+
+        if (fracRemTwice > divisor ||
+                (fracRemTwice == divisor && (fracPart & 1) == 1)) {
+            ++fracPart;
+
+            if (fracPart == 1000) {
+                ++intPart;
+                fracPart = 0;
+            }
         }
 
+        bufAt += formatDecimal(bufAt, intPart);
+        *bufAt++ = '.';
+        bufAt += formatDecimal(bufAt, fracPart, boost::none, 3);
+        withExtraBits = formatMode == SizeFormatMode::FULL_FLOOR_WITH_EXTRA_BITS;
         break;
     }
 
     case SizeFormatMode::BYTES_FLOOR:
     case SizeFormatMode::BYTES_FLOOR_WITH_EXTRA_BITS:
-        unit = "B";
-
-        if (formatMode == SizeFormatMode::BYTES_FLOOR_WITH_EXTRA_BITS &&
-                extraBits > 0) {
-            if (sep) {
-                std::sprintf(buf.data(), "%s+%llu",
-                             sepNumber(static_cast<long long>(sizeBytes), *sep).c_str(),
-                             extraBits);
-            } else {
-                std::sprintf(buf.data(), "%llu+%llu", sizeBytes, extraBits);
-            }
-        } else {
-            if (sep) {
-                std::sprintf(buf.data(), "%s",
-                             sepNumber(static_cast<long long>(sizeBytes), *sep).c_str());
-            } else {
-                std::sprintf(buf.data(), "%llu", sizeBytes);
-            }
-        }
-
+        bufAt += formatDecimal(bufAt, sizeBytes, sep);
+        withExtraBits = formatMode == SizeFormatMode::BYTES_FLOOR_WITH_EXTRA_BITS;
         break;
 
     case SizeFormatMode::BITS:
         unit = "b";
-
-        if (sep) {
-            std::sprintf(buf.data(), "%s",
-                         sepNumber(static_cast<long long>(sizeBits), *sep).c_str());
-        } else {
-            std::sprintf(buf.data(), "%llu", sizeBits);
-        }
-
+        bufAt += formatDecimal(bufAt, sizeBits, sep);
         break;
     }
 
+    if (withExtraBits && extraBits > 0) {
+        *bufAt++ = '+';
+        formatDecimal(bufAt, extraBits);
+    }
+
+    return unit;
+}
+
+std::pair<std::string, std::string> formatSize(const Size sizeBits,
+                                               const SizeFormatMode formatMode,
+                                               const boost::optional<char>& sep)
+{
+    std::array<char, formatBufSize> buf;
+    const auto unit = formatSize(buf.data(), sizeBits, formatMode, sep);
+
     return {buf.data(), unit};
 }
 
-std::pair<std::string, std::string> formatNs(long long ns,
-                                             const boost::optional<char>& sep)
+void formatNs(char * const sBuf, char * const nsBuf, const long long ns,
+              const boost::optional<char>& sep)
 {
-    constexpr auto nsInS = 1'000'000'000LL;
-    const auto absNs = std::abs(ns);
-    const auto absSOnly = (absNs / nsInS);
-    const auto nsOnly = absNs % nsInS;
-    std::string sStr;
+    constexpr auto nsInS = 1'000'000'000ULL;
+    const auto absNs = ns < 0 ? 0ULL - static_cast<unsigned long long>(ns) :
+                       static_cast<unsigned long long>(ns);
+    auto sBufAt = sBuf;
 
     if (ns < 0) {
-        sStr = "-";
+        *sBufAt++ = '-';
     }
 
-    sStr += sep ? sepNumber(absSOnly, *sep) : std::to_string(absSOnly);
+    formatDecimal(sBufAt, absNs / nsInS, sep);
+    formatDecimal(nsBuf, absNs % nsInS, sep, 9);
+}
 
-    const auto nsStr = sep ? sepNumber(nsOnly, *sep, "%09llu") :
-                       std::to_string(nsOnly);
+std::pair<std::string, std::string> formatNs(const long long ns,
+                                             const boost::optional<char>& sep)
+{
+    std::array<char, formatBufSize> sBuf;
+    std::array<char, formatBufSize> nsBuf;
 
-    return {sStr, nsStr};
+    formatNs(sBuf.data(), nsBuf.data(), ns, sep);
+    return {sBuf.data(), nsBuf.data()};
 }
 
 static std::string formatMetadataParseError(const std::string& path,
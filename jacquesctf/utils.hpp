@@ -11,6 +11,11 @@
 #include <string>
 #include <iostream>
 #include <utility>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <boost/utility.hpp>
 #include <boost/optional.hpp>
@@ -68,6 +73,32 @@ std::string escapeString(const std::string& str);
 std::string sepNumber(long long value, char sep = ' ');
 std::string sepNumber(unsigned long long value, char sep = ' ');
 
+/*
+ * Minimal size of the buffer to pass to the buffer versions of
+ * formatDecimal(), formatSize(), and formatNs() below (enough for any
+ * 64-bit integer with separators and a sign, plus the terminating null
+ * character).
+ */
+constexpr Size formatBufSize = 32;
+
+/*
+ * Writes the decimal representation of `value`, with the "thousands
+ * separator" `sep` if set, to `buf`, followed by a null character.
+ * Zeros are prepended so that there's at least `minDigitCount` digits.
+ *
+ * Returns the number of written characters, excluding the null
+ * character.
+ *
+ * Those functions don't allocate memory and don't use printf(): use
+ * them where formatting is done for each visible row or for each
+ * printed line.
+ */
+Size formatDecimal(char *buf, unsigned long long value,
+                   const boost::optional<char>& sep = boost::none,
+                   Size minDigitCount = 1);
+Size formatDecimal(char *buf, long long value,
+                   const boost::optional<char>& sep = boost::none);
+
 /*
  * Used as such:
  *
@@ -92,14 +123,95 @@ std::pair<std::string, std::string> formatSize(Size sizeBits,
                                                SizeFormatMode formatMode = SizeFormatMode::FULL_FLOOR_WITH_EXTRA_BITS,
                                                const boost::optional<char>& sep = boost::none);
 
+/*
+ * Like the formatSize() above, but writes the quantity to `buf`
+ * (null-terminated), and returns the (static) unit string.
+ */
+const char *formatSize(char *buf, Size sizeBits,
+                       SizeFormatMode formatMode = SizeFormatMode::FULL_FLOOR_WITH_EXTRA_BITS,
+                       const boost::optional<char>& sep = boost::none);
+
 std::pair<std::string, std::string> formatNs(long long ns,
                                              const boost::optional<char>& sep = boost::none);
 
+/*
+ * Like the formatNs() above, but writes the seconds part (with its
+ * sign) to `sBuf` and the nanosecond part to `nsBuf` (both
+ * null-terminated).
+ */
+void formatNs(char *sBuf, char *nsBuf, long long ns,
+              const boost::optional<char>& sep = boost::none);
+
 void printMetadataParseError(std::ostream& os, const std::string& path,
                              const yactfr::MetadataParseError& error);
 
 boost::optional<std::string> tryFunc(const std::function<void ()>& func);
 
+/*
+ * Calls `func(index)` for each index in [0, `count`[ from a bounded
+ * set of worker threads (at most the number of hardware threads, and
+ * never more than `count`). Each worker takes the next index to
+ * process until there's none left, so uneven tasks balance naturally.
+ *
+ * When `count` is 1 or when there's a single hardware thread, this
+ * function calls `func` from the calling thread.
+ *
+ * If one or more calls throw, this function rethrows, once all the
+ * workers are done, the exception of the lowest index so that the
+ * reported error does not depend on scheduling.
+ */
+template <typename FuncT>
+void parallelFor(const Size count, FuncT&& func)
+{
+    if (count == 0) {
+        return;
+    }
+
+    const auto workerCount = std::min(static_cast<Size>(std::max(std::thread::hardware_concurrency(), 1U)),
+                                      count);
+
+    if (workerCount == 1) {
+        for (Index index = 0; index < count; ++index) {
+            func(index);
+        }
+
+        return;
+    }
+
+    std::vector<std::exception_ptr> exceptions(count);
+    std::atomic<Index> nextIndex {0};
+    const auto workerFunc = [&]() {
+        while (true) {
+            const Index index = nextIndex++;
+
+            if (index >= count) {
+                break;
+            }
+
+            try {
+                func(index);
+            } catch (...) {
+                exceptions[index] = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+
+    for (Index i = 0; i < workerCount; ++i) {
+        workers.emplace_back(workerFunc);
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (const auto& exc : exceptions) {
+        if (exc) {
+            std::rethrow_exception(exc);
+        }
+    }
+}
+
 } // namespace utils
 } // namespace jacques
 
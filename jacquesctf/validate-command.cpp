@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <thread>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "config.hpp"
+#include "validate-command.hpp"
+#include "command-error.hpp"
+#include "metadata.hpp"
+#include "trace.hpp"
+#include "data-stream-file.hpp"
+#include "file-handle-pool.hpp"
+#include "utils.hpp"
+
+namespace bfs = boost::filesystem;
+
+namespace jacques {
+
+static void printDecodingError(const DataStreamFile& dsf,
+                               const PacketDecodingError& error)
+{
+    const auto& indexEntry = error.packetIndexEntry();
+    const auto offsetInPacketBits = error.decodingError().offset() -
+                                    indexEntry.offsetInDataStreamFileBits();
+
+    std::cout << dsf.path().string() << ": packet " <<
+                 indexEntry.natIndexInDataStreamFile() << " (offset " <<
+                 indexEntry.offsetInDataStreamFileBytes() << " B): at " <<
+                 offsetInPacketBits << " b within packet: " <<
+                 error.decodingError().reason() << std::endl;
+}
+
+void validateCommand(const ValidateConfig& cfg)
+{
+    // group by trace
+    std::map<bfs::path, std::vector<bfs::path>> tracePaths;
+
+    for (const auto& path : cfg.paths()) {
+        tracePaths[path.parent_path()].push_back(path);
+    }
+
+    std::vector<const std::vector<bfs::path> *> traceDsfPaths;
+
+    for (const auto& tracePathPathsPair : tracePaths) {
+        traceDsfPaths.push_back(&tracePathPathsPair.second);
+    }
+
+    /*
+     * Traces sharing an identical metadata text share a trace type.
+     * The data stream files only keep a bounded number of files open.
+     */
+    Metadata::TextCache metadataTextCache;
+    FileHandlePool fileHandlePool;
+    std::vector<std::unique_ptr<Trace>> traces(traceDsfPaths.size());
+
+    utils::parallelFor(traceDsfPaths.size(), [&](const Index index) {
+        traces[index] = std::make_unique<Trace>(*traceDsfPaths[index],
+                                                &metadataTextCache,
+                                                &fileHandlePool,
+                                                cfg.dataSourceKind());
+    });
+
+    std::vector<DataStreamFile *> dsfs;
+
+    for (auto& trace : traces) {
+        for (auto& dsf : trace->dataStreamFiles()) {
+            dsfs.push_back(dsf.get());
+        }
+    }
+
+    /*
+     * Index and decode the data stream files concurrently, sharing the
+     * hardware threads between them: a data stream file which has many
+     * packets gets more than one packet decoding worker when there are
+     * fewer data stream files than hardware threads.
+     */
+    const auto hwThreadCount = static_cast<Size>(std::max(std::thread::hardware_concurrency(),
+                                                          1U));
+    const auto maxWorkerCount = std::max(hwThreadCount / dsfs.size(),
+                                         static_cast<Size>(1));
+    std::vector<std::vector<PacketDecodingError>> dsfErrors(dsfs.size());
+
+    utils::parallelFor(dsfs.size(), [&](const Index index) {
+        auto& dsf = *dsfs[index];
+
+        dsf.buildIndex();
+        dsfErrors[index] = dsf.decodingErrors(maxWorkerCount);
+    });
+
+    Size packetCount = 0;
+    Size errorCount = 0;
+
+    for (Index index = 0; index < dsfs.size(); ++index) {
+        packetCount += dsfs[index]->packetCount();
+        errorCount += dsfErrors[index].size();
+
+        for (const auto& error : dsfErrors[index]) {
+            printDecodingError(*dsfs[index], error);
+        }
+    }
+
+    std::cout << "Validated " << packetCount << " packet(s) of " <<
+                 dsfs.size() << " data stream file(s): " << errorCount <<
+                 " decoding error(s)." << std::endl;
+
+    if (errorCount > 0) {
+        std::ostringstream ss;
+
+        ss << "Found " << errorCount << " invalid packet(s).";
+        throw CommandError {ss.str()};
+    }
+}
+
+} // namespace jacques
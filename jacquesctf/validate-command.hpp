@@ -0,0 +1,19 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_VALIDATE_COMMAND_HPP
+#define _JACQUES_VALIDATE_COMMAND_HPP
+
+#include "config.hpp"
+
+namespace jacques {
+
+void validateCommand(const ValidateConfig& cfg);
+
+} // namespace jacques
+
+#endif // _JACQUES_VALIDATE_COMMAND_HPP